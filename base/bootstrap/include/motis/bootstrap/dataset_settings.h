@@ -32,6 +32,12 @@ struct dataset_settings : public conf::configuration,
           "Remove footpaths if they do not fit an assumed average speed");
     param(expand_footpaths_, "expand_footpaths",
           "Calculate expanded footpaths");
+    param(sparse_footpath_closure_, "sparse_footpath_closure",
+          "Expand footpaths using Dijkstra searches per station instead of "
+          "Floyd-Warshall per connected component");
+    param(max_footpath_duration_, "max_footpath_duration",
+          "Max. duration of expanded footpaths (minutes, 0 = unlimited, only "
+          "used with sparse_footpath_closure)");
     param(use_platforms_, "use_platforms",
           "Use separate interchange times for trips stopping at the same "
           "platform");
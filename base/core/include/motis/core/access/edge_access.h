@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "motis/core/schedule/connection.h"
 #include "motis/core/schedule/edges.h"
 #include "motis/core/schedule/nodes.h"
@@ -13,8 +15,10 @@ void foreach_departure_in(edge const& edge, time begin, time end, F fun) {
   }
 
   auto const& conns = edge.m_.route_edge_.conns_;
-  auto it = std::lower_bound(std::begin(conns), std::end(conns),
-                             light_connection(begin));
+  auto const d_times = edge.get_lcon_times(event_type::DEP);
+  auto it = std::begin(conns) +
+            (std::lower_bound(d_times, d_times + conns.size(), begin) -
+             d_times);
   for (; it != std::end(conns) && it->d_time_ < end; ++it) {
     fun(it);
   }
@@ -27,10 +31,10 @@ void foreach_arrival_in(edge const& edge, time begin, time end, F fun) {
   }
 
   auto const& conns = edge.m_.route_edge_.conns_;
-  auto it = std::lower_bound(std::begin(conns), std::end(conns), begin,
-                             [](light_connection const& lcon, time const& t) {
-                               return lcon.a_time_ < t;
-                             });
+  auto const a_times = edge.get_lcon_times(event_type::ARR);
+  auto it = std::begin(conns) +
+            (std::lower_bound(a_times, a_times + conns.size(), begin) -
+             a_times);
   for (; it != std::end(conns) && it->a_time_ < end; ++it) {
     fun(it);
   }
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+namespace motis {
+
+// Peak resident set size of the current process in bytes (0 if unknown).
+std::size_t get_peak_rss();
+
+}  // namespace motis
@@ -79,6 +79,7 @@ public:
       m_.route_edge_.conns_.set(std::begin(connections), std::end(connections));
       std::sort(std::begin(m_.route_edge_.conns_),
                 std::end(m_.route_edge_.conns_));
+      update_lcon_times();
     }
   }
 
@@ -257,36 +258,54 @@ public:
     return nullptr;
   }
 
+  /** departure (DEP) or arrival (ARR) times of all light connections */
+  inline time const* get_lcon_times(event_type const ev_type) const {
+    assert(type() == ROUTE_EDGE);
+    assert(m_.route_edge_.times_.size() == 2 * m_.route_edge_.conns_.size());
+    return std::begin(m_.route_edge_.times_) +
+           (ev_type == event_type::DEP ? 0U : m_.route_edge_.conns_.size());
+  }
+
+  /** has to be called after the times of light connections changed. */
+  void update_lcon_times() {
+    assert(type() == ROUTE_EDGE);
+    auto const& conns = m_.route_edge_.conns_;
+    auto& times = m_.route_edge_.times_;
+    times.resize(2 * conns.size());
+    for (auto i = 0U; i < conns.size(); ++i) {
+      times[i] = conns[i].d_time_;
+      times[conns.size() + i] = conns[i].a_time_;
+    }
+  }
+
   template <search_dir Dir = search_dir::FWD>
   light_connection const* get_connection(time const start_time) const {
     assert(type() == ROUTE_EDGE);
 
-    if (m_.route_edge_.conns_.empty()) {
+    auto const& conns = m_.route_edge_.conns_;
+    if (conns.empty()) {
       return nullptr;
     }
 
     if (Dir == search_dir::FWD) {
-      auto it = std::lower_bound(std::begin(m_.route_edge_.conns_),
-                                 std::end(m_.route_edge_.conns_),
-                                 light_connection(start_time));
+      auto const d_times = get_lcon_times(event_type::DEP);
+      auto const it =
+          std::lower_bound(d_times, d_times + conns.size(), start_time);
 
-      if (it == std::end(m_.route_edge_.conns_)) {
+      if (it == d_times + conns.size()) {
         return nullptr;
       } else {
-        return get_next_valid_lcon(&*it);
+        return get_next_valid_lcon(&conns[it - d_times]);
       }
     } else {
-      auto it = std::lower_bound(
-          m_.route_edge_.conns_.rbegin(), m_.route_edge_.conns_.rend(),
-          light_connection(0, start_time, nullptr),
-          [](light_connection const& lhs, light_connection const& rhs) {
-            return lhs.a_time_ > rhs.a_time_;
-          });
-
-      if (it == m_.route_edge_.conns_.rend()) {
+      auto const a_times = get_lcon_times(event_type::ARR);
+      auto const it =
+          std::upper_bound(a_times, a_times + conns.size(), start_time);
+
+      if (it == a_times) {
         return nullptr;
       } else {
-        return get_prev_valid_lcon(&*it);
+        return get_prev_valid_lcon(&conns[it - a_times - 1]);
       }
     }
   }
@@ -451,6 +470,8 @@ public:
       if (type_ == ROUTE_EDGE) {
         using Type = decltype(route_edge_.conns_);
         route_edge_.conns_.~Type();
+        using TimesType = decltype(route_edge_.times_);
+        route_edge_.times_.~TimesType();
       }
     }
 
@@ -462,7 +483,14 @@ public:
       uint8_t type_padding_;
       mcd::vector<light_connection> conns_;
 
-      void init_empty() { new (&conns_) mcd::vector<light_connection>(); }
+      // d_time_ of all conns_ followed by a_time_ of all conns_:
+      // binary searches only touch these instead of the light connections
+      mcd::vector<time> times_;
+
+      void init_empty() {
+        new (&conns_) mcd::vector<light_connection>();
+        new (&times_) mcd::vector<time>();
+      }
     } route_edge_;
 
     // TYPE = FOOT_EDGE & CO
@@ -0,0 +1,37 @@
+#include "motis/core/common/memory_usage.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+// windows.h must be included before psapi.h
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace motis {
+
+std::size_t get_peak_rss() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS info{};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info)) == 0) {
+    return 0U;
+  }
+  return static_cast<std::size_t>(info.PeakWorkingSetSize);
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0U;
+  }
+#ifdef __APPLE__
+  return static_cast<std::size_t>(usage.ru_maxrss);  // bytes
+#else
+  return static_cast<std::size_t>(usage.ru_maxrss) * 1024U;  // kilobytes
+#endif
+#endif
+}
+
+}  // namespace motis
@@ -70,6 +70,10 @@ inline void serialize(Ctx& c, edge const* origin,
                      offset + offsetof(edge, m_) +
                          offsetof(decltype(origin->m_), route_edge_) +
                          offsetof(decltype(origin->m_.route_edge_), conns_));
+    cista::serialize(c, &origin->m_.route_edge_.times_,
+                     offset + offsetof(edge, m_) +
+                         offsetof(decltype(origin->m_), route_edge_) +
+                         offsetof(decltype(origin->m_.route_edge_), times_));
   }
 }
 
@@ -79,6 +83,7 @@ inline void deserialize(Ctx const& c, edge* el) {
   cista::deserialize(c, &el->to_);
   if (el->type() == edge::ROUTE_EDGE) {
     cista::deserialize(c, &el->m_.route_edge_.conns_);
+    cista::deserialize(c, &el->m_.route_edge_.times_);
   }
 }
 
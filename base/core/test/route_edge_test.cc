@@ -91,3 +91,31 @@ TEST(core_route_edge, get_connection_reverse_end_test) {
 
   EXPECT_FALSE(e1.get_connection<search_dir::BWD>(11));
 }
+
+TEST(core_route_edge, lcon_times_test) {
+  auto const d_times = e.get_lcon_times(event_type::DEP);
+  auto const a_times = e.get_lcon_times(event_type::ARR);
+  for (auto i = 0U; i < e.m_.route_edge_.conns_.size(); ++i) {
+    EXPECT_EQ(e.m_.route_edge_.conns_[i].d_time_, d_times[i]);
+    EXPECT_EQ(e.m_.route_edge_.conns_[i].a_time_, a_times[i]);
+  }
+}
+
+TEST(core_route_edge, update_lcon_times_test) {
+  auto e1 = e;
+  e1.m_.route_edge_.conns_[2].d_time_ = 5;
+  e1.m_.route_edge_.conns_[2].a_time_ = 15;
+  e1.update_lcon_times();
+
+  auto c = e1.get_connection(3);
+  ASSERT_TRUE(c);
+  EXPECT_EQ(5, c->d_time_);
+
+  c = e1.get_connection<search_dir::BWD>(14);
+  ASSERT_TRUE(c);
+  EXPECT_EQ(11, c->a_time_);
+
+  c = e1.get_connection<search_dir::BWD>(15);
+  ASSERT_TRUE(c);
+  EXPECT_EQ(15, c->a_time_);
+}
@@ -10,6 +10,7 @@ namespace motis::launcher {
 
 void inject_queries(boost::asio::io_service&, motis::module::receiver&,
                     std::string const& input_file_path,
-                    std::string const& output_file_path, int num_threads);
+                    std::string const& output_file_path, int num_threads,
+                    bool binary = false, bool ordered = false);
 
 }  // namespace motis::launcher
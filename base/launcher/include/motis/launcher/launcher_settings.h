@@ -48,17 +48,26 @@ public:
           "test = exit after 1s");
     param(batch_input_file_, "batch_input_file", "query file");
     param(batch_output_file_, "batch_output_file", "response file");
+    param(batch_binary_, "batch_binary",
+          "batch files contain length-prefixed flatbuffers instead of JSON");
+    param(batch_ordered_, "batch_ordered",
+          "write batch responses in the order of the queries");
     param(init_, "init", "init operation");
     param(num_threads_, "num_threads", "number of worker threads");
     param(direct_mode_, "direct", "no ctx/multi-threading");
+    param(response_cache_size_, "response_cache_size",
+          "routing response cache size in MB (0 = disabled)");
   }
 
   motis_mode_t mode_{launcher_settings::motis_mode_t::SERVER};
   std::string batch_input_file_{"queries.txt"};
   std::string batch_output_file_{"responses.txt"};
+  bool batch_binary_{false};
+  bool batch_ordered_{false};
   std::string init_;
   unsigned num_threads_{std::thread::hardware_concurrency()};
   bool direct_mode_{sizeof(void*) >= 8 ? false : true};
+  std::size_t response_cache_size_{0U};
 };
 
 }  // namespace motis::launcher
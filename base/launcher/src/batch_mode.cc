@@ -1,14 +1,25 @@
 #include "motis/launcher/batch_mode.h"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <functional>
 #include <istream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <ostream>
+#include <thread>
+#include <vector>
 
-#include "utl/erase.h"
+#include "utl/parallel_for.h"
 
+#include "motis/core/common/logging.h"
 #include "motis/module/message.h"
 
 using namespace motis::module;
@@ -17,15 +28,23 @@ namespace motis::launcher {
 
 struct query_injector : std::enable_shared_from_this<query_injector> {
 public:
+  using clock = std::chrono::steady_clock;
+
   query_injector(boost::asio::io_service& ios,
                  motis::module::receiver& receiver,
                  std::string const& input_file_path,
-                 std::string const& output_file_path, int num_threads)
+                 std::string const& output_file_path, int num_threads,
+                 bool binary, bool ordered)
       : ios_(ios),
         receiver_(receiver),
-        in_(input_file_path),
-        out_(output_file_path),
-        num_threads_(num_threads) {
+        in_(input_file_path, binary ? std::ios_base::in | std::ios_base::binary
+                                    : std::ios_base::in),
+        out_(output_file_path, binary
+                                   ? std::ios_base::out | std::ios_base::binary
+                                   : std::ios_base::out),
+        num_threads_(num_threads),
+        binary_(binary),
+        ordered_(ordered) {
     in_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     out_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
   }
@@ -36,62 +55,166 @@ public:
   query_injector(query_injector&&) = delete;
   query_injector& operator=(query_injector&&) = delete;
 
-  ~query_injector() { ios_.stop(); }
+  ~query_injector() {
+    if (reader_.joinable()) {
+      reader_.join();
+    }
+    ios_.stop();
+  }
 
   void start() {
-    auto self = shared_from_this();
-    ios_.post([this, self]() {
-      for (int i = 0; i < 2 * num_threads_; ++i) {
-        if (!inject_msg(self)) {
-          break;
-        }
-      }
-    });
+    start_time_ = clock::now();
+    reader_ = std::thread{[self = shared_from_this()]() mutable {
+      self->read_queries();
+      // the destructor joins the reader thread: release the last reference
+      // on the io_service thread
+      auto& ios = self->ios_;
+      ios.post([self = std::move(self)]() {});
+    }};
   }
 
 private:
-  msg_ptr next_query() {
+  struct query {
+    std::size_t seq_{0U};
+    std::string raw_;  // encoded error response if the query is invalid
+    msg_ptr msg_;
+    std::error_code ec_;
+  };
+
+  struct target_stats {
+    std::vector<clock::duration> latencies_;
+    unsigned errors_{0U};
+  };
+
+  std::size_t block_size() const {
+    return 4U * static_cast<std::size_t>(num_threads_);
+  }
+
+  // Reader thread: the input is read and parsed ahead of the io_service
+  // thread, at most two blocks of queries that have not been injected yet.
+  void read_queries() {
+    auto done = false;
+    while (!done) {
+      {
+        std::unique_lock lock{read_mutex_};
+        read_cv_.wait(lock, [&]() { return read_ahead_ < 2U * block_size(); });
+      }
+
+      auto batch = read_block();
+      done = batch.empty();
+      {
+        std::lock_guard const lock{read_mutex_};
+        read_ahead_ += batch.size();
+      }
+      ios_.post([self = shared_from_this(), batch = std::move(batch),
+                 done]() mutable { self->on_read(std::move(batch), done); });
+    }
+  }
+
+  bool read_raw(std::string& buf) {
     if (in_.eof() || in_.peek() == EOF) {
-      return nullptr;
+      return false;
     }
 
-    std::string json;
-    std::getline(in_, json);
-    return make_msg(json);
+    if (binary_) {
+      auto size = std::uint32_t{};
+      in_.read(reinterpret_cast<char*>(&size), sizeof(size));
+      buf.resize(size);
+      in_.read(buf.data(), size);
+    } else {
+      std::getline(in_, buf);
+    }
+    return true;
   }
 
-  bool inject_msg(std::shared_ptr<query_injector> const&) {
-    msg_ptr next;
+  // Reads the next block of queries and parses them in parallel (parse
+  // errors are encoded as error responses here as well).
+  std::vector<query> read_block() {
+    std::vector<query> batch;
     try {
-      next = next_query();
-      if (next) {
-        ++in_flight_;
-        receiver_.on_msg(next,
-                         ios_.wrap([self = shared_from_this(), id = next->id()](
-                                       msg_ptr const& res, std::error_code ec) {
-                           self->on_response(self, id, res, ec);
-                         }));
-      } else {
-        if (in_flight_ == 0) {
-          ios_.stop();
+      for (auto i = 0U; i < block_size(); ++i) {
+        auto q = query{next_read_seq_};
+        if (!read_raw(q.raw_)) {
+          break;
         }
-        return false;
+        ++next_read_seq_;
+        batch.emplace_back(std::move(q));
       }
-    } catch (std::system_error const& e) {
-      on_response(shared_from_this(), next ? next->id() : -1, msg_ptr(),
-                  e.code());
+    } catch (std::exception const& e) {
+      LOG(logging::error) << "batch: reading input failed: " << e.what();
+      in_.close();
+      in_.exceptions(std::ifstream::goodbit);
     }
-    return true;
+
+    std::vector<std::size_t> indices(batch.size());
+    std::iota(begin(indices), end(indices), 0U);
+    utl::parallel_for(indices, [&](std::size_t const i) {
+      auto& q = batch[i];
+      try {
+        q.msg_ = binary_ ? make_msg(q.raw_.data(), q.raw_.size())
+                         : make_msg(q.raw_);
+        q.raw_ = std::string{};
+      } catch (std::system_error const& e) {
+        q.ec_ = e.code();
+        q.raw_ = encode(-1, nullptr, q.ec_);
+      }
+    });
+    return batch;
   }
 
-  void on_response(std::shared_ptr<query_injector> const& self, int id,
-                   msg_ptr const& res, std::error_code ec) {
-    --in_flight_;
-    write_response(id, res, ec);
-    inject_msg(self);
+  void on_read(std::vector<query>&& batch, bool const done) {
+    input_done_ = done;
+    std::move(begin(batch), end(batch), std::back_inserter(queue_));
+    while (in_flight_ < 2U * static_cast<unsigned>(num_threads_) &&
+           inject_msg()) {
+    }
   }
 
-  void write_response(int id, msg_ptr const& res, std::error_code ec) {
+  bool inject_msg() {
+    if (queue_.empty()) {
+      if (input_done_ && in_flight_ == 0) {
+        finish();
+      }
+      return false;
+    }
+
+    auto q = std::move(queue_.front());
+    queue_.pop_front();
+    ++in_flight_;
+    {
+      std::lock_guard const lock{read_mutex_};
+      --read_ahead_;
+    }
+    read_cv_.notify_one();
+
+    if (q.ec_) {
+      ios_.post([self = shared_from_this(), seq = q.seq_,
+                 encoded = std::move(q.raw_)]() mutable {
+        self->on_response(seq, "invalid", clock::duration{}, true,
+                          std::move(encoded));
+      });
+      return true;
+    }
+
+    // Serialization runs on the worker thread that finished the query,
+    // only writing the output is done on the io_service thread.
+    receiver_.on_msg(
+        q.msg_, [self = shared_from_this(), seq = q.seq_, id = q.msg_->id(),
+                 target = q.msg_->get()->destination()->target()->str(),
+                 start = clock::now()](msg_ptr const& res, std::error_code ec) {
+          auto const latency = clock::now() - start;
+          auto const failed = static_cast<bool>(ec);
+          auto encoded = self->encode(id, res, ec);
+          self->ios_.post([self, seq, target, latency, failed,
+                           encoded = std::move(encoded)]() mutable {
+            self->on_response(seq, target, latency, failed,
+                              std::move(encoded));
+          });
+        });
+    return true;
+  }
+
+  std::string encode(int id, msg_ptr const& res, std::error_code ec) const {
     msg_ptr response;
 
     if (ec) {
@@ -103,8 +226,77 @@ private:
     }
     response->get()->mutate_id(id);
 
-    out_ << response->to_json(true) << "\n";
+    if (binary_) {
+      auto const size = static_cast<std::uint32_t>(response->size());
+      std::string buf(sizeof(size) + response->size(), '\0');
+      std::memcpy(buf.data(), &size, sizeof(size));
+      std::memcpy(buf.data() + sizeof(size), response->data(),
+                  response->size());
+      return buf;
+    } else {
+      auto json = response->to_json(true);
+      json.push_back('\n');
+      return json;
+    }
+  }
+
+  void on_response(std::size_t const seq, std::string const& target,
+                   clock::duration const latency, bool const failed,
+                   std::string&& encoded) {
+    --in_flight_;
+
+    auto& stats = stats_[target];
+    stats.latencies_.emplace_back(latency);
+    if (failed) {
+      ++stats.errors_;
+    }
+
+    if (ordered_) {
+      pending_.emplace(seq, std::move(encoded));
+      for (auto it = begin(pending_);
+           it != end(pending_) && it->first == next_write_seq_;
+           it = pending_.erase(it), ++next_write_seq_) {
+        out_ << it->second;
+      }
+    } else {
+      out_ << encoded;
+    }
+
+    inject_msg();
+  }
+
+  void finish() {
     out_.flush();
+    print_summary();
+    ios_.stop();
+  }
+
+  void print_summary() {
+    using ms = std::chrono::duration<double, std::milli>;
+
+    auto const total_time =
+        std::chrono::duration<double>(clock::now() - start_time_).count();
+    LOG(logging::info) << "batch: " << next_read_seq_ << " queries in "
+                       << total_time << "s ("
+                       << (total_time == 0.0 ? 0.0
+                                             : next_read_seq_ / total_time)
+                       << " queries/s)";
+
+    for (auto& [target, stats] : stats_) {
+      auto& latencies = stats.latencies_;
+      std::sort(begin(latencies), end(latencies));
+      auto const percentile = [&](unsigned const p) {
+        return ms{latencies[std::min(latencies.size() - 1,
+                                     latencies.size() * p / 100)]}
+            .count();
+      };
+      LOG(logging::info) << "batch: " << target << ": " << latencies.size()
+                         << " queries, " << stats.errors_
+                         << " errors, latency [ms]: p50=" << percentile(50)
+                         << ", p90=" << percentile(90)
+                         << ", p99=" << percentile(99)
+                         << ", max=" << ms{latencies.back()}.count();
+    }
   }
 
   boost::asio::io_service& ios_;
@@ -117,14 +309,33 @@ private:
   std::ofstream out_;
 
   int num_threads_;
+  bool binary_;
+  bool ordered_;
+
+  std::thread reader_;
+  std::mutex read_mutex_;
+  std::condition_variable read_cv_;
+  std::size_t read_ahead_{0U};  // read, but not yet injected (read_mutex_)
+  std::size_t next_read_seq_{0U};  // reader thread until input_done_
+
+  // io_service thread
+  std::deque<query> queue_;
+  bool input_done_{false};
+  std::size_t next_write_seq_{0U};
+  std::map<std::size_t, std::string> pending_;
+
+  clock::time_point start_time_;
+  std::map<std::string, target_stats> stats_;
 };
 
 void inject_queries(boost::asio::io_service& ios,
                     motis::module::receiver& receiver,
                     std::string const& input_file_path,
-                    std::string const& output_file_path, int num_threads) {
+                    std::string const& output_file_path, int num_threads,
+                    bool binary, bool ordered) {
   std::make_shared<query_injector>(ios, receiver, input_file_path,
-                                   output_file_path, num_threads)
+                                   output_file_path, num_threads, binary,
+                                   ordered)
       ->start();
 }
 
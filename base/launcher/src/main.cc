@@ -37,6 +37,19 @@ using namespace motis::module;
 using namespace motis::logging;
 using namespace motis;
 
+void print_response_cache_stats(response_cache const& cache) {
+  auto const stats = cache.get_statistics();
+  auto const lookups = stats.hits_ + stats.misses_ + stats.coalesced_;
+  LOG(info) << "response cache: " << stats.hits_ << " hits, " << stats.misses_
+            << " misses, " << stats.coalesced_ << " coalesced ("
+            << (lookups == 0U ? 0.0 : 100.0 * stats.hits_ / lookups)
+            << "% hit rate), " << stats.entries_ << " entries, "
+            << stats.size_bytes_ / (1024U * 1024U) << "/"
+            << cache.max_size_bytes() / (1024U * 1024U) << " MB, "
+            << stats.evictions_ << " evictions, " << stats.invalidations_
+            << " invalidations";
+}
+
 int main(int argc, char const** argv) {
   motis_instance instance;
 
@@ -98,6 +111,11 @@ int main(int argc, char const** argv) {
     dispatcher::direct_mode_dispatcher_ = &instance;
   }
 
+  if (launcher_opt.response_cache_size_ != 0U) {
+    instance.response_cache_ = std::make_unique<response_cache>(
+        launcher_opt.response_cache_size_ * 1024U * 1024U);
+  }
+
   try {
     instance.import(module_opt, dataset_opt, import_opt);
     instance.init_modules(module_opt, launcher_opt.num_threads_);
@@ -147,12 +165,19 @@ int main(int argc, char const** argv) {
       LOG(info) << "starting to inject queries";
       inject_queries(
           instance.runner_.ios(), instance, launcher_opt.batch_input_file_,
-          launcher_opt.batch_output_file_, launcher_opt.num_threads_);
+          launcher_opt.batch_output_file_, launcher_opt.num_threads_,
+          launcher_opt.batch_binary_, launcher_opt.batch_ordered_);
     };
     remote_opt.get_remotes().empty()
         ? start_batch()
         : instance.on_remotes_registered(start_batch);
   } else if (launcher_opt.mode_ == launcher_settings::motis_mode_t::SERVER) {
+    if (instance.response_cache_ != nullptr) {
+      instance.register_timer(
+          "Response Cache Statistics", boost::posix_time::minutes(5),
+          [&]() { print_response_cache_stats(*instance.response_cache_); },
+          {});
+    }
     instance.init_io(module_opt);
     stop = std::make_unique<net::stop_handler>(instance.runner_.ios(), [&]() {
       server.stop();
@@ -168,6 +193,10 @@ int main(int argc, char const** argv) {
       launcher_opt.mode_ == launcher_settings::motis_mode_t::SERVER);
   LOG(info) << "shutdown";
 
+  if (instance.response_cache_ != nullptr) {
+    print_response_cache_stats(*instance.response_cache_);
+  }
+
 #ifdef PROTOBUF_LINKED
   google::protobuf::ShutdownProtobufLibrary();
 #endif
@@ -4,6 +4,7 @@
 
 #include "motis/hash_map.h"
 
+#include "motis/core/schedule/footpath.h"
 #include "motis/core/schedule/schedule.h"
 
 #include "motis/loader/loader_options.h"
@@ -13,6 +14,13 @@ namespace motis::loader {
 struct Schedule;  // NOLINT
 struct Station;  // NOLINT
 
+// Shortest footpaths from the source station to all stations reachable within
+// max_duration (exclusive) in the given footpath graph (station_idx ->
+// outgoing footpaths). The result is sorted by target station.
+std::vector<footpath> transitive_footpaths(
+    std::vector<std::vector<footpath>> const& fgraph, uint32_t source,
+    uint32_t max_duration);
+
 void build_footpaths(schedule&, loader_options const&,
                      mcd::hash_map<Station const*, station_node*> const&,
                      std::vector<Schedule const*> const&);
@@ -142,6 +142,8 @@ struct graph_builder {
   void add_services(
       flatbuffers64::Vector<flatbuffers64::Offset<Service>> const* services);
 
+  void index_trips_for_dedup(std::size_t first_trip_idx);
+
   bool has_duplicate(Service const*, mcd::vector<light_connection> const&);
 
   bool are_duplicates(Service const*, mcd::vector<light_connection> const&,
@@ -238,6 +240,7 @@ struct graph_builder {
                 deep_ptr_eq<connection>>
       connections_;
   mcd::hash_map<flatbuffers64::String const*, mcd::string*> filenames_;
+  mcd::hash_map<uint64_t, mcd::vector<trip const*>> dedup_index_;
   schedule& sched_;
   int first_day_{0}, last_day_{0};
   bool apply_rules_{false};
@@ -247,6 +250,9 @@ struct graph_builder {
   connection_info con_info_;
   connection con_;
   std::size_t broken_trips_{0U};
+  std::size_t dedup_indexed_trips_{0U};
+  std::size_t dedup_candidates_{0U};
+  std::size_t dedup_duplicates_{0U};
 };
 
 }  // namespace motis::loader
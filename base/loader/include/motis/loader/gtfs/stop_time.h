@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <string>
 
+#include "utl/parser/cstr.h"
+
 #include "motis/loader/gtfs/trip.h"
 #include "motis/loader/loaded_file.h"
 
@@ -10,4 +13,9 @@ namespace motis::loader::gtfs {
 
 void read_stop_times(loaded_file const&, trip_map&, stop_map const&);
 
+// Rows are parsed concurrently in line-aligned chunks of the given size.
+void read_stop_times(char const* filename, utl::cstr content, trip_map&,
+                     stop_map const&,
+                     std::size_t target_chunk_size = 16U * 1024U * 1024U);
+
 }  // namespace motis::loader::gtfs
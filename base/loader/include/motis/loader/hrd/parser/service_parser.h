@@ -12,13 +12,33 @@
 
 namespace motis::loader::hrd {
 
+// Line-aligned part of a services file that starts at a service boundary
+// ("*Z" line) and can therefore be parsed independently of other chunks.
+struct service_chunk {
+  utl::cstr content_;
+  int line_offset_{0};
+};
+
+std::vector<service_chunk> split_services(utl::cstr content,
+                                          std::size_t target_chunk_size);
+
 void parse_specification(
     loaded_file const&, std::function<void(specification const&)>,
     std::function<void(std::size_t)> bytes_consumed = [](std::size_t) {});
 
+void parse_specification(char const* filename, service_chunk const&,
+                         std::function<void(specification const&)>,
+                         std::function<void(std::size_t)> bytes_consumed);
+
 void for_each_service(loaded_file const&, std::map<int, bitfield> const&,
                       std::function<void(hrd_service const&)>,
                       std::function<void(std::size_t)> bytes_consumed,
                       config const&);
 
+void for_each_service(char const* filename, service_chunk const&,
+                      std::map<int, bitfield> const&,
+                      std::function<void(hrd_service const&)>,
+                      std::function<void(std::size_t)> bytes_consumed,
+                      config const&);
+
 }  // namespace motis::loader::hrd
@@ -27,6 +27,8 @@ struct loader_options {
   bool adjust_footpaths_{false};
   bool expand_trips_{true};
   bool expand_footpaths_{true};
+  bool sparse_footpath_closure_{false};
+  duration max_footpath_duration_{0};
   bool use_platforms_{false};
   bool no_local_transport_{false};
   duration planned_transfer_delta_{30};
@@ -1,7 +1,10 @@
 #include "motis/loader/build_footpaths.h"
 
+#include <functional>
 #include <optional>
+#include <queue>
 #include <stack>
+#include <unordered_map>
 
 #include "geo/latlng.h"
 
@@ -193,7 +196,41 @@ struct footpath_builder {
     ml::scoped_timer timer("building transitively closed foot graph");
 
     auto const fgraph = get_footpath_graph();
+    if (opt_.sparse_footpath_closure_) {
+      transitivize_footpaths_sparse(fgraph);
+    } else {
+      transitivize_footpaths_dense(fgraph);
+    }
+  }
 
+  void transitivize_footpaths_sparse(footgraph const& fgraph) {
+    auto const max_duration =
+        opt_.max_footpath_duration_ == 0
+            ? uint32_t{std::numeric_limits<motis::time>::max()}
+            : uint32_t{opt_.max_footpath_duration_} + 1U;
+
+    std::vector<uint32_t> sources;
+    for (auto i = 0U; i < fgraph.size(); ++i) {
+      if (!fgraph[i].empty()) {
+        sources.emplace_back(i);
+      }
+    }
+
+    std::vector<std::vector<footpath>> closure(fgraph.size());
+    utl::parallel_for(sources, [&](uint32_t const source) {
+      closure[source] = transitive_footpaths(fgraph, source, max_duration);
+    });
+
+    // incoming footpaths of a station are written by different sources
+    for (auto const& fps : closure) {
+      for (auto const& fp : fps) {
+        sched_.stations_[fp.from_station_]->outgoing_footpaths_.push_back(fp);
+        sched_.stations_[fp.to_station_]->incoming_footpaths_.push_back(fp);
+      }
+    }
+  }
+
+  void transitivize_footpaths_dense(footgraph const& fgraph) {
     auto components = find_components(fgraph);
     std::sort(begin(components), end(components));
 
@@ -385,6 +422,50 @@ struct footpath_builder {
   mcd::hash_map<Station const*, station_node*> const& station_nodes_;
 };
 
+std::vector<footpath> transitive_footpaths(footgraph const& fgraph,
+                                           uint32_t const source,
+                                           uint32_t const max_duration) {
+  using queue_entry = std::pair<uint32_t, uint32_t>;  // (duration, station)
+  std::priority_queue<queue_entry, std::vector<queue_entry>, std::greater<>>
+      pq;
+  std::unordered_map<uint32_t, uint32_t> durations;
+
+  durations[source] = 0U;
+  pq.emplace(0U, source);
+  while (!pq.empty()) {
+    auto const [duration, station] = pq.top();
+    pq.pop();
+
+    if (duration > durations.at(station)) {
+      continue;
+    }
+
+    for (auto const& fp : fgraph[station]) {
+      auto const new_duration = duration + fp.duration_;
+      if (new_duration >= max_duration) {
+        continue;
+      }
+
+      auto const it = durations.find(fp.to_station_);
+      if (it == end(durations) || new_duration < it->second) {
+        durations[fp.to_station_] = new_duration;
+        pq.emplace(new_duration, fp.to_station_);
+      }
+    }
+  }
+
+  std::vector<footpath> fps;
+  fps.reserve(durations.size());
+  for (auto const& [station, duration] : durations) {
+    if (station != source) {
+      fps.emplace_back(
+          footpath{source, station, static_cast<motis::time>(duration)});
+    }
+  }
+  std::sort(begin(fps), end(fps));
+  return fps;
+}
+
 void build_footpaths(
     schedule& sched, loader_options const& opt,
     mcd::hash_map<Station const*, station_node*> const& station_nodes,
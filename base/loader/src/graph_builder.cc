@@ -245,35 +245,59 @@ void graph_builder::add_route_services(
   }
 }
 
+// Trips from other datasets are only compared if they share the first
+// departure time, the last arrival time and the number of stops.
+uint64_t dedup_key(time const first_dep, time const last_arr,
+                   std::size_t const stop_count) {
+  return (static_cast<uint64_t>(first_dep) << 48U) |
+         (static_cast<uint64_t>(last_arr) << 32U) |
+         static_cast<uint64_t>(stop_count);
+}
+
+void graph_builder::index_trips_for_dedup(std::size_t const first_trip_idx) {
+  for (auto i = first_trip_idx; i < sched_.trip_mem_.size(); ++i) {
+    auto const* trp = sched_.trip_mem_[i].get();
+    if (trp->edges_ == nullptr || trp->edges_->empty()) {
+      continue;
+    }
+
+    auto const stops = access::stops{trp};
+    auto const stop_count = std::distance(begin(stops), end(stops));
+    auto const& last_stop = *std::next(begin(stops), stop_count - 1);
+    dedup_index_[dedup_key((*begin(stops)).dep_lcon().d_time_,
+                           last_stop.arr_lcon().a_time_,
+                           static_cast<std::size_t>(stop_count))]
+        .push_back(trp);
+    ++dedup_indexed_trips_;
+  }
+}
+
 bool graph_builder::has_duplicate(Service const* service,
                                   mcd::vector<light_connection> const& lcons) {
+  auto const candidates_it = dedup_index_.find(
+      dedup_key(lcons.front().d_time_, lcons.back().a_time_,
+                service->route()->stations()->size()));
+  if (candidates_it == end(dedup_index_)) {
+    return false;
+  }
+
   auto const& first_station = sched_.stations_.at(
       stations_.at(service->route()->stations()->Get(0))->id_);
-  for (auto const& eq : first_station->equivalent_) {
-    if (eq->source_schedule_ == first_station->source_schedule_) {
+  for (auto const& trp : candidates_it->second) {
+    auto const& first_station_b =
+        (*begin(access::stops{trp})).get_station(sched_);
+    if (first_station_b.source_schedule_ == first_station->source_schedule_ ||
+        std::none_of(begin(first_station->equivalent_),
+                     end(first_station->equivalent_), [&](auto const& eq) {
+                       return eq->index_ == first_station_b.index_;
+                     })) {
       continue;  // Ignore duplicates from same schedule.
     }
 
-    for (auto const& route_node :
-         sched_.station_nodes_[eq->index_]->child_nodes_) {
-      if (!route_node->is_route_node()) {
-        continue;
-      }
-      for (auto const& route_edge : route_node->edges_) {
-        if (route_edge.type() != edge::ROUTE_EDGE) {
-          continue;
-        }
-
-        for (auto* lc = route_edge.get_connection(lcons.front().d_time_);
-             lc != nullptr && lc->d_time_ == lcons.front().d_time_;
-             lc = route_edge.get_next_valid_lcon(lc, 1U)) {
-          for (auto const& trp : *sched_.merged_trips_[lc->trips_]) {
-            if (are_duplicates(service, lcons, trp)) {
-              return true;
-            }
-          }
-        }
-      }
+    ++dedup_candidates_;
+    if (are_duplicates(service, lcons, trp)) {
+      ++dedup_duplicates_;
+      return true;
     }
   }
 
@@ -838,6 +862,7 @@ schedule_ptr build_graph(std::vector<Schedule const*> const& fbs_schedules,
 
     std::tie(builder.first_day_, builder.last_day_) =
         first_last_days(*sched, i, fbs_schedule->interval());
+    auto const first_trip_idx = sched->trip_mem_.size();
     builder.add_services(fbs_schedule->services());
     if (opt.apply_rules_) {
       scoped_timer timer("rule services");
@@ -845,6 +870,17 @@ schedule_ptr build_graph(std::vector<Schedule const*> const& fbs_schedules,
           .out_bounds(out_mid, out_high);
       build_rule_routes(builder, fbs_schedule->rule_services());
     }
+
+    if (i + 1 != fbs_schedules.size()) {
+      builder.index_trips_for_dedup(first_trip_idx);
+    }
+  }
+
+  if (fbs_schedules.size() > 1) {
+    LOG(info) << "dedup: " << builder.dedup_indexed_trips_
+              << " indexed trips, " << builder.dedup_candidates_
+              << " candidates compared, " << builder.dedup_duplicates_
+              << " duplicates skipped";
   }
 
   if (opt.expand_trips_) {
@@ -1,6 +1,8 @@
 #include "motis/loader/gtfs/gtfs_parser.h"
 
 #include <numeric>
+#include <optional>
+#include <string_view>
 
 #include "boost/algorithm/string.hpp"
 #include "boost/date_time/posix_time/posix_time.hpp"
@@ -27,6 +29,7 @@
 #include "motis/core/common/constants.h"
 #include "motis/core/common/date_time_util.h"
 #include "motis/core/common/logging.h"
+#include "motis/core/common/memory_usage.h"
 #include "motis/core/schedule/time.h"
 #include "motis/loader/gtfs/agency.h"
 #include "motis/loader/gtfs/calendar.h"
@@ -238,6 +241,38 @@ void fix_flixtrain_transfers(trip_map& trips,
   }
 }
 
+// Logs wall time and the peak resident set size after a parser stage.
+struct stage_timer final {
+  explicit stage_timer(char const* name) : timer_{name}, name_{name} {}
+  stage_timer(stage_timer const&) = delete;
+  stage_timer(stage_timer&&) = delete;
+  stage_timer& operator=(stage_timer const&) = delete;
+  stage_timer& operator=(stage_timer&&) = delete;
+  ~stage_timer() {
+    LOG(info) << "[" << name_ << "] peak rss: "
+              << get_peak_rss() / (1024U * 1024U) << "MB";
+  }
+
+  motis::logging::scoped_timer timer_;
+  char const* name_;
+};
+
+void read_stop_times(fs::path const& path, trip_map& trips,
+                     stop_map const& stops) {
+  if (!fs::is_regular_file(path) || fs::file_size(path) == 0U) {
+    return;
+  }
+  cista::mmap const m{path.generic_string().c_str(),
+                      cista::mmap::protection::READ};
+  auto content =
+      std::string_view{reinterpret_cast<char const*>(m.data()), m.size()};
+  if (content.substr(0U, 3U) == "\xEF\xBB\xBF") {  // UTF-8 BOM
+    content.remove_prefix(3U);
+  }
+  read_stop_times(STOP_TIMES_FILE, utl::cstr{content.data(), content.size()},
+                  trips, stops);
+}
+
 void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
   motis::logging::scoped_timer global_timer{"gtfs parser"};
 
@@ -245,6 +280,9 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
     return fs::is_regular_file(root / file) ? loaded_file{root / file}
                                             : loaded_file{};
   };
+
+  std::optional<stage_timer> stage;
+  stage.emplace("read base data");
   auto const feeds = read_feed_publisher(load(FEED_INFO_FILE));
   auto const agencies = read_agencies(load(AGENCY_FILE));
   auto const stops = read_stops(load(STOPS_FILE));
@@ -254,7 +292,11 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
   auto const traffic_days = merge_traffic_days(calendar, dates);
   auto transfers = read_transfers(load(TRANSFERS_FILE), stops);
   auto [trips, blocks] = read_trips(load(TRIPS_FILE), routes, traffic_days);
-  read_stop_times(load(STOP_TIMES_FILE), trips, stops);
+
+  stage.emplace("stop times");
+  read_stop_times(root / STOP_TIMES_FILE, trips, stops);
+
+  stage.emplace("fix trips");
   fix_stop_positions(trips);
   fix_flixtrain_transfers(trips, transfers);
 
@@ -348,7 +390,7 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
     }
   };
 
-  motis::logging::scoped_timer export_timer{"export"};
+  stage.emplace("export");
   auto progress_tracker = utl::get_active_progress_tracker();
   progress_tracker->status("Export schedule.raw")
       .out_bounds(60.F, 100.F)
@@ -1,9 +1,13 @@
 #include "motis/loader/gtfs/stop_time.h"
 
 #include <algorithm>
+#include <array>
+#include <string_view>
+#include <thread>
 #include <tuple>
 
 #include "utl/enumerate.h"
+#include "utl/parallel_for.h"
 #include "utl/parser/arg_parser.h"
 #include "utl/parser/csv.h"
 #include "utl/progress_tracker.h"
@@ -51,29 +55,100 @@ int hhmm_to_min(cstr s) {
   }
 }
 
-void read_stop_times(loaded_file const& file, trip_map& trips,
-                     stop_map const& stops) {
-  motis::logging::scoped_timer timer{"read stop times"};
-  std::string last_trip_id;
-  trip* last_trip = nullptr;
+struct parsed_stop_time {
+  trip* trip_;
+  unsigned seq_;
+  stop* stop_;
+  std::string headsign_;
+  int arr_time_, dep_time_;
+  bool out_allowed_, in_allowed_;
+};
 
-  auto const entries = read<gtfs_stop_time>(file.content(), stop_time_columns);
+struct stop_times_chunk {
+  cstr content_;
+  std::size_t first_row_;
+  std::vector<parsed_stop_time> parsed_;
+};
 
-  auto progress_tracker = utl::get_active_progress_tracker();
-  progress_tracker->status("Parse Stop Times")
-      .out_bounds(25.F, 60.F)
-      .in_high(entries.size());
+// Splits the rows (without header) into line-aligned chunks. Newlines inside
+// quoted fields are not used as split points.
+std::vector<stop_times_chunk> split_rows(std::string_view const rows,
+                                         std::size_t const target_chunk_size) {
+  std::vector<stop_times_chunk> chunks;
+  auto chunk_begin = std::size_t{0U};
+  auto first_row = std::size_t{0U};
+  auto in_quotes = false;
+  auto pos = std::size_t{0U};
+  while (chunk_begin < rows.size()) {
+    auto chunk_end = rows.size();
+    for (; pos < rows.size(); ++pos) {
+      if (rows[pos] == '"') {
+        in_quotes = !in_quotes;
+      } else if (rows[pos] == '\n' && !in_quotes &&
+                 pos - chunk_begin >= target_chunk_size) {
+        chunk_end = ++pos;
+        break;
+      }
+    }
+
+    auto const chunk = rows.substr(chunk_begin, chunk_end - chunk_begin);
+    chunks.push_back(
+        stop_times_chunk{cstr{chunk.data(), chunk.size()}, first_row, {}});
+    first_row += static_cast<std::size_t>(
+        std::count(begin(chunk), end(chunk), '\n'));
+    chunk_begin = chunk_end;
+  }
+  return chunks;
+}
+
+// Maps the header columns to the tuple positions of gtfs_stop_time, so that
+// chunks can be parsed with read_rows without repeating the header line.
+std::array<column_idx_t, MAX_COLUMNS> map_columns(std::string_view header) {
+  std::array<column_idx_t, MAX_COLUMNS> column_map{};
+  std::fill(begin(column_map), end(column_map), NO_COLUMN_IDX);
+  while (!header.empty() && (header.back() == '\n' || header.back() == '\r')) {
+    header.remove_suffix(1U);
+  }
+  auto col = 0U;
+  for_each_token(cstr{header.data(), header.size()}, ',', [&](cstr name) {
+    if (name.len >= 2U && name.str[0] == '"' && name.str[name.len - 1] == '"') {
+      name = name.substr(1U, size(name.len - 2U));
+    }
+    for (auto i = 0U; i < stop_time_columns.size(); ++i) {
+      if (col < MAX_COLUMNS && stop_time_columns[i] == name) {
+        column_map[col] = static_cast<column_idx_t>(i);
+      }
+    }
+    ++col;
+  });
+  return column_map;
+}
+
+void parse_chunk(char const* filename,
+                 std::array<column_idx_t, MAX_COLUMNS> const& column_map,
+                 stop_times_chunk& chunk, trip_map const& trips,
+                 stop_map const& stops) {
+  auto content = chunk.content_;
+  auto const rows = read_rows<gtfs_stop_time, ','>(content, column_map);
+  std::vector<gtfs_stop_time> entries;
+  read(entries, rows);
+  chunk.parsed_.reserve(entries.size());
+
+  std::string_view last_trip_id;
+  trip* last_trip = nullptr;
   for (auto const& [i, s] : utl::enumerate(entries)) {
-    progress_tracker->update(i);
+    auto const row = chunk.first_row_ + i;
+
     trip* t = nullptr;
-    auto t_id = get<trip_id>(s).to_str();
+    auto const t_id =
+        std::string_view{get<trip_id>(s).str, get<trip_id>(s).len};
     if (last_trip != nullptr && t_id == last_trip_id) {
       t = last_trip;
     } else {
-      auto const trip_it = trips.find(t_id);
+      auto const trip_it = trips.find(std::string{t_id});
       if (trip_it == end(trips)) {
-        LOG(logging::error) << "trip \"" << t_id << "\" in " << file.name()
-                            << ":" << i << " not found";
+        LOG(logging::error) << "trip \"" << t_id << "\" in " << filename
+                            << ":" << row << " not found";
         continue;
       }
       t = trip_it->second.get();
@@ -81,17 +156,71 @@ void read_stop_times(loaded_file const& file, trip_map& trips,
       last_trip = t;
     }
 
-    try {
-      t->stop_times_.emplace(
-          get<stop_sequence>(s), stops.at(get<stop_id>(s).to_str()).get(),
-          get<stop_headsign>(s).to_str(),  //
-          hhmm_to_min(get<arrival_time>(s)), get<drop_off_type>(s) != 1,
-          hhmm_to_min(get<departure_time>(s)), get<pickup_type>(s) != 1);
-    } catch (...) {
+    auto const stop_it = stops.find(get<stop_id>(s).to_str());
+    if (stop_it == end(stops)) {
       LOG(logging::warn) << "unkown stop " << get<stop_id>(s).to_str() << " at "
-                         << file.name() << ":" << i;
+                         << filename << ":" << row;
+      continue;
+    }
+
+    chunk.parsed_.push_back(parsed_stop_time{
+        t, static_cast<unsigned>(get<stop_sequence>(s)), stop_it->second.get(),
+        get<stop_headsign>(s).to_str(), hhmm_to_min(get<arrival_time>(s)),
+        hhmm_to_min(get<departure_time>(s)), get<drop_off_type>(s) != 1,
+        get<pickup_type>(s) != 1});
+  }
+}
+
+void read_stop_times(char const* filename, cstr const content,
+                     trip_map& trips, stop_map const& stops,
+                     std::size_t const target_chunk_size) {
+  motis::logging::scoped_timer timer{"read stop times"};
+
+  auto const sv = std::string_view{content.c_str(), content.length()};
+  auto const header_end = sv.find('\n');
+  if (header_end == std::string_view::npos) {
+    return;
+  }
+  auto const column_map = map_columns(sv.substr(0U, header_end));
+  auto chunks = split_rows(sv.substr(header_end + 1U), target_chunk_size);
+
+  auto progress_tracker = utl::get_active_progress_tracker();
+  progress_tracker->status("Parse Stop Times")
+      .out_bounds(25.F, 60.F)
+      .in_high(sv.size());
+
+  // Chunks are parsed concurrently in batches (bounding the memory used for
+  // parsed but not yet inserted rows) and then inserted in file order.
+  auto const batch_size =
+      std::max(1U, std::thread::hardware_concurrency()) * 2U;
+  for (auto batch_begin = 0U; batch_begin < chunks.size();
+       batch_begin += batch_size) {
+    auto const batch_end = std::min(batch_begin + batch_size,
+                                    static_cast<unsigned>(chunks.size()));
+
+    utl::parallel_for_run(batch_end - batch_begin, [&](auto const j) {
+      parse_chunk(filename, column_map, chunks[batch_begin + j], trips, stops);
+    });
+
+    for (auto i = batch_begin; i != batch_end; ++i) {
+      auto& chunk = chunks[i];
+      for (auto& st : chunk.parsed_) {
+        st.trip_->stop_times_.emplace(st.seq_, st.stop_,
+                                      std::move(st.headsign_), st.arr_time_,
+                                      st.out_allowed_, st.dep_time_,
+                                      st.in_allowed_);
+      }
+      chunk.parsed_ = {};
+      progress_tracker->update(
+          static_cast<std::size_t>(chunk.content_.c_str() - content.c_str()) +
+          chunk.content_.length());
     }
   }
 }
 
+void read_stop_times(loaded_file const& file, trip_map& trips,
+                     stop_map const& stops) {
+  read_stop_times(file.name(), file.content(), trips, stops);
+}
+
 }  // namespace motis::loader::gtfs
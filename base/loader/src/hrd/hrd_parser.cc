@@ -1,7 +1,10 @@
 #include "motis/loader/hrd/hrd_parser.h"
 
+#include <thread>
+
 #include "utl/enumerate.h"
 #include "utl/erase.h"
+#include "utl/parallel_for.h"
 #include "utl/progress_tracker.h"
 
 #include "cista/hash.h"
@@ -154,11 +157,17 @@ loaded_file load_optional(fs::path const& root, char const* filename) {
   }
 }
 
+// Services files are split into chunks of roughly this size which are parsed
+// and expanded concurrently. Building the flatbuffer services stays serial
+// (in file order) so the resulting schedule is deterministic.
+constexpr auto const SERVICE_CHUNK_SIZE = std::size_t{4U * 1024U * 1024U};
+
 void parse_and_build_services(
     fs::path const& hrd_root, std::map<int, bitfield> const& bitfields,
     std::vector<std::unique_ptr<loaded_file>>& schedule_data,
     std::function<void(hrd_service const&)> const& service_builder_fun,
     config const& c) {
+  scoped_timer timer("parsing and building services");
   std::vector<fs::path> files;
   auto const total_bytes =
       collect_files(hrd_root / c.fplan_, c.fplan_file_extension_, files);
@@ -168,19 +177,45 @@ void parse_and_build_services(
       .out_bounds(0.F, 100.F)
       .in_high(total_bytes);
 
-  auto total_consumed = size_t{0ULL};
-  auto const progress_update = [&](std::size_t const file_consumed) {
-    progress_tracker->update(total_consumed + file_consumed);
-  };
+  // Bounds the number of parsed (not yet built) services held in memory.
+  auto const batch_size =
+      std::max(1U, std::thread::hardware_concurrency()) * 2U;
 
+  auto total_consumed = size_t{0ULL};
   for (auto const& [i, file] : utl::enumerate(files)) {
     auto const& loaded = schedule_data.emplace_back(
         std::make_unique<loaded_file>(file, c.convert_utf8_));
     LOG(info) << "parsing " << i << "/" << files.size() << " "
               << schedule_data.back()->name();
 
-    for_each_service(*loaded, bitfields, service_builder_fun, progress_update,
-                     c);
+    auto const chunks = split_services(loaded->content(), SERVICE_CHUNK_SIZE);
+    for (auto batch_begin = 0U; batch_begin < chunks.size();
+         batch_begin += batch_size) {
+      auto const batch_end =
+          std::min(batch_begin + batch_size,
+                   static_cast<unsigned>(chunks.size()));
+
+      std::vector<std::vector<hrd_service>> parsed(batch_end - batch_begin);
+      utl::parallel_for_run(parsed.size(), [&](auto const j) {
+        for_each_service(
+            loaded->name(), chunks[batch_begin + j], bitfields,
+            [&](hrd_service const& s) { parsed[j].push_back(s); },
+            [](std::size_t) {}, c);
+      });
+
+      for (auto const& [j, services] : utl::enumerate(parsed)) {
+        for (auto const& s : services) {
+          service_builder_fun(s);
+        }
+        auto const& chunk = chunks[batch_begin + j];
+        progress_tracker->update(
+            total_consumed +
+            static_cast<std::size_t>(chunk.content_.c_str() -
+                                     loaded->content().c_str()) +
+            chunk.content_.length());
+      }
+    }
+
     total_consumed += fs::file_size(file);
   }
 }
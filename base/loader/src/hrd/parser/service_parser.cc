@@ -2,6 +2,7 @@
 
 #include <cctype>
 #include <algorithm>
+#include <string_view>
 
 #include "utl/verify.h"
 
@@ -17,14 +18,50 @@ using namespace motis::logging;
 
 namespace motis::loader::hrd {
 
+std::vector<service_chunk> split_services(cstr const content,
+                                          std::size_t const target_chunk_size) {
+  auto const sv = std::string_view{content.c_str(), content.length()};
+  auto chunks = std::vector<service_chunk>{};
+  auto chunk_begin = std::size_t{0U};
+  auto line_offset = 0;
+  while (chunk_begin < sv.size()) {
+    auto chunk_end = sv.size();
+    if (sv.size() - chunk_begin > target_chunk_size) {
+      auto const next_service =
+          sv.find("\n*Z", chunk_begin + target_chunk_size);
+      if (next_service != std::string_view::npos) {
+        chunk_end = next_service + 1;
+      }
+    }
+
+    auto const chunk = sv.substr(chunk_begin, chunk_end - chunk_begin);
+    chunks.push_back(
+        service_chunk{cstr{chunk.data(), chunk.size()}, line_offset});
+    line_offset +=
+        static_cast<int>(std::count(begin(chunk), end(chunk), '\n'));
+    chunk_begin = chunk_end;
+  }
+  return chunks;
+}
+
 void parse_specification(loaded_file const& file,
                          std::function<void(specification const&)> builder,
                          std::function<void(std::size_t)> bytes_consumed) {
+  parse_specification(file.name(), service_chunk{file.content(), 0},
+                      std::move(builder), std::move(bytes_consumed));
+}
+
+void parse_specification(char const* filename, service_chunk const& chunk,
+                         std::function<void(specification const&)> builder,
+                         std::function<void(std::size_t)> bytes_consumed) {
   specification spec;
-  for_each_line_numbered(file.content(), [&](cstr line, int line_number) {
-    bytes_consumed(line.c_str() - file.content().c_str());
+  auto last_line_number = chunk.line_offset_;
+  for_each_line_numbered(chunk.content_, [&](cstr line, int line_number) {
+    line_number += chunk.line_offset_;
+    last_line_number = line_number;
+    bytes_consumed(line.c_str() - chunk.content_.c_str());
 
-    bool finished = spec.read_line(line, file.name(), line_number);
+    bool finished = spec.read_line(line, filename, line_number);
 
     if (!finished) {
       return;
@@ -33,24 +70,25 @@ void parse_specification(loaded_file const& file,
     }
 
     if (!spec.valid()) {
-      LOG(error) << "skipping bad service at " << file.name() << ":"
+      LOG(error) << "skipping bad service at " << filename << ":"
                  << line_number;
     } else if (!spec.ignore()) {
       // Store if relevant.
       try {
         builder(spec);
       } catch (std::runtime_error const& e) {
-        LOG(error) << "unable to build service at " << file.name() << ":"
+        LOG(error) << "unable to build service at " << filename << ":"
                    << line_number << ", skipping";
       }
     }
 
     // Next try! Re-read first line of next service.
     spec.reset();
-    spec.read_line(line, file.name(), line_number);
+    spec.read_line(line, filename, line_number);
   });
 
   if (!spec.is_empty() && spec.valid() && !spec.ignore()) {
+    spec.line_number_to_ = last_line_number;
     builder(spec);
   }
 }
@@ -72,8 +110,17 @@ void for_each_service(loaded_file const& file,
                       std::function<void(hrd_service const&)> consumer,
                       std::function<void(std::size_t)> bytes_consumed,
                       config const& c) {
+  for_each_service(file.name(), service_chunk{file.content(), 0}, bitfields,
+                   std::move(consumer), std::move(bytes_consumed), c);
+}
+
+void for_each_service(char const* filename, service_chunk const& chunk,
+                      std::map<int, bitfield> const& bitfields,
+                      std::function<void(hrd_service const&)> consumer,
+                      std::function<void(std::size_t)> bytes_consumed,
+                      config const& c) {
   parse_specification(
-      file,
+      filename, chunk,
       [&](specification const& spec) {
         try {
           expand_and_consume(hrd_service(spec, c), bitfields, consumer);
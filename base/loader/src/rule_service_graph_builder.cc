@@ -197,6 +197,7 @@ struct lcon_time_adjuster {
 
       assert(last_arr <= curr_dep && curr_dep <= curr_arr);
     }
+    e->update_lcon_times();
   }
 
   void process_following_route_edges(edge* e, edge* pred) {
@@ -0,0 +1,78 @@
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "motis/core/common/floyd_warshall.h"
+#include "motis/loader/build_footpaths.h"
+
+namespace motis::loader {
+
+// Dense synthetic component: every station has footpaths to ~1/4 of the
+// other stations (sorted by target station like the loader's foot graph).
+std::vector<std::vector<footpath>> make_dense_component(uint32_t const size) {
+  std::mt19937 gen{size};
+  std::uniform_int_distribution<unsigned> duration_dist{1U, 15U};
+  std::uniform_int_distribution<unsigned> edge_dist{0U, 3U};
+
+  std::vector<std::vector<footpath>> fgraph(size);
+  for (auto from = 0U; from < size; ++from) {
+    for (auto to = 0U; to < size; ++to) {
+      if (from != to && edge_dist(gen) == 0U) {
+        fgraph[from].emplace_back(footpath{
+            from, to, static_cast<motis::time>(duration_dist(gen))});
+      }
+    }
+  }
+  return fgraph;
+}
+
+TEST(loader_build_footpaths, sparse_closure_matches_floyd_warshall) {
+  constexpr auto const kInvalidTime = std::numeric_limits<motis::time>::max();
+
+  for (auto const size : {3U, 10U, 50U, 300U}) {
+    auto const fgraph = make_dense_component(size);
+
+    auto mat = make_flat_matrix<motis::time>(size, kInvalidTime);
+    for (auto const& fps : fgraph) {
+      for (auto const& fp : fps) {
+        mat(fp.from_station_, fp.to_station_) = fp.duration_;
+      }
+    }
+    floyd_warshall(mat);
+
+    std::vector<std::vector<footpath>> closure(size);
+    for (auto source = 0U; source < size; ++source) {
+      closure[source] = transitive_footpaths(fgraph, source, kInvalidTime);
+    }
+
+    for (auto from = 0U; from < size; ++from) {
+      std::vector<footpath> expected;
+      for (auto to = 0U; to < size; ++to) {
+        if (from != to && mat(from, to) != kInvalidTime) {
+          expected.emplace_back(footpath{from, to, mat(from, to)});
+        }
+      }
+      EXPECT_EQ(expected, closure[from]);
+    }
+  }
+}
+
+TEST(loader_build_footpaths, sparse_closure_max_duration) {
+  // 0 -5-> 1 -5-> 2 -5-> 3
+  std::vector<std::vector<footpath>> const fgraph = {
+      {footpath{0U, 1U, 5U}},
+      {footpath{1U, 2U, 5U}},
+      {footpath{2U, 3U, 5U}},
+      {}};
+
+  EXPECT_EQ((std::vector<footpath>{footpath{0U, 1U, 5U},
+                                   footpath{0U, 2U, 10U}}),
+            transitive_footpaths(fgraph, 0U, 11U));
+  EXPECT_EQ((std::vector<footpath>{footpath{0U, 1U, 5U}}),
+            transitive_footpaths(fgraph, 0U, 10U));
+  EXPECT_TRUE(transitive_footpaths(fgraph, 3U, 100U).empty());
+}
+
+}  // namespace motis::loader
@@ -1,5 +1,10 @@
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+#include "utl/zip.h"
+
 #include "motis/loader/gtfs/files.h"
 #include "motis/loader/gtfs/stop_time.h"
 
@@ -65,4 +70,87 @@ TEST(loader_gtfs_route, read_stop_times_example_data) {
   EXPECT_TRUE(stop.dep_.in_out_allowed_);
 }
 
+struct expected_stop_time {
+  std::string trip_;
+  int seq_;
+  std::string stop_;
+  int arr_, dep_;
+  bool out_allowed_, in_allowed_;
+};
+
+// Expected stop times of example/stop_times.txt (times in minutes, -1 if not
+// set, out/in allowed: drop_off_type/pickup_type != 1).
+std::vector<expected_stop_time> const EXAMPLE_STOP_TIMES = {
+    {"AWE1", 1, "S1", 6, 6, true, true},
+    {"AWE1", 2, "S2", -1, -1, false, true},
+    {"AWE1", 3, "S3", 6, 6, true, true},
+    {"AWE1", 4, "S5", -1, -1, true, true},
+    {"AWE1", 5, "S6", 6, 6, true, true},
+    {"AWD1", 1, "S1", 6, 6, true, true},
+    {"AWD1", 2, "S2", -1, -1, true, true},
+    {"AWD1", 3, "S3", 6, 6, true, true},
+    {"AWD1", 4, "S4", -1, -1, true, true},
+    {"AWD1", 5, "S5", -1, -1, true, true},
+    {"AWD1", 6, "S6", 6, 6, true, true}};
+
+// Reads the stop times with chunk sizes that split the file into several
+// chunks and compares them to the expected stop times (in file order).
+void check_chunked_stop_times(boost::filesystem::path const& root,
+                              std::vector<expected_stop_time> const& expected) {
+  auto agencies = read_agencies(loaded_file{root / AGENCY_FILE});
+  auto routes = read_routes(loaded_file{root / ROUTES_FILE}, agencies);
+  auto dates = read_calendar_date(loaded_file{root / CALENDAR_DATES_FILE});
+  auto calendar = read_calendar(loaded_file{root / CALENDAR_FILE});
+  auto traffic_days = merge_traffic_days(calendar, dates);
+  auto stops = read_stops(loaded_file{root / STOPS_FILE});
+  auto const stop_times_file = loaded_file{root / STOP_TIMES_FILE};
+
+  for (auto const chunk_size : {1U, 64U, 256U}) {
+    ASSERT_GT(stop_times_file.content().length(), 2U * chunk_size);
+
+    auto [trips, blocks] =
+        read_trips(loaded_file{root / TRIPS_FILE}, routes, traffic_days);
+    read_stop_times(stop_times_file.name(), stop_times_file.content(), trips,
+                    stops, chunk_size);
+
+    auto actual = std::vector<expected_stop_time>{};
+    for (auto const& e : expected) {
+      auto const trip_it = trips.find(e.trip_);
+      ASSERT_NE(end(trips), trip_it);
+      if (!actual.empty() && actual.back().trip_ == e.trip_) {
+        continue;
+      }
+      for (auto const& [seq, st] : trip_it->second->stop_times_) {
+        actual.push_back({e.trip_, static_cast<int>(seq), st.stop_->id_,
+                          st.arr_.time_, st.dep_.time_,
+                          st.arr_.in_out_allowed_, st.dep_.in_out_allowed_});
+      }
+    }
+
+    auto total = 0U;
+    for (auto const& [id, t] : trips) {
+      total += t->stop_times_.size();
+    }
+    EXPECT_EQ(expected.size(), total);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (auto const& [e, a] : utl::zip(expected, actual)) {
+      EXPECT_EQ(e.trip_, a.trip_);
+      EXPECT_EQ(e.seq_, a.seq_);
+      EXPECT_EQ(e.stop_, a.stop_);
+      EXPECT_EQ(e.arr_, a.arr_);
+      EXPECT_EQ(e.dep_, a.dep_);
+      EXPECT_EQ(e.out_allowed_, a.out_allowed_);
+      EXPECT_EQ(e.in_allowed_, a.in_allowed_);
+    }
+  }
+}
+
+TEST(loader_gtfs_route, read_stop_times_chunked) {
+  check_chunked_stop_times(SCHEDULES / "example", EXAMPLE_STOP_TIMES);
+  // none of the stops of berlin/stop_times.txt are in berlin/stops.txt:
+  // all rows are skipped
+  check_chunked_stop_times(SCHEDULES / "berlin", {});
+}
+
 }  // namespace motis::loader::gtfs
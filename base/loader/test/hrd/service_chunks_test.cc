@@ -0,0 +1,64 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "motis/loader/hrd/parser/service_parser.h"
+
+#include "./paths.h"
+#include "./test_spec_test.h"
+
+namespace motis::loader::hrd {
+
+std::vector<specification> get_chunked_specs(loaded_file const& lf,
+                                             std::size_t const chunk_size) {
+  std::vector<specification> specs;
+  for (auto const& chunk : split_services(lf.content(), chunk_size)) {
+    parse_specification(
+        lf.name(), chunk,
+        [&specs](specification const& spec) { specs.push_back(spec); },
+        [](std::size_t) {});
+  }
+  return specs;
+}
+
+TEST(loader_hrd_service_chunks, split_at_service_boundaries) {
+  test_spec services_file(SCHEDULES / "ts-mss-hrd" / "fahrten",
+                          "services_03056.101");
+
+  auto const chunks = split_services(services_file.lf_.content(), 1U);
+  ASSERT_EQ(8U, chunks.size());
+  for (auto const& chunk : chunks) {
+    EXPECT_TRUE(chunk.content_.starts_with("*Z"));
+  }
+
+  auto const single_chunk =
+      split_services(services_file.lf_.content(), 1024U * 1024U);
+  ASSERT_EQ(1U, single_chunk.size());
+  EXPECT_EQ(services_file.lf_.content().length(),
+            single_chunk.front().content_.length());
+}
+
+TEST(loader_hrd_service_chunks, same_specs_as_sequential) {
+  for (auto const& [dir, filename] :
+       {std::pair{"ts-mss-hrd", "services_03056.101"},
+        std::pair{"hand-crafted", "services-all.101"},
+        std::pair{"mss-dayshift", "services.101"}}) {
+    test_spec services_file(SCHEDULES / dir / "fahrten", filename);
+    auto const expected = services_file.get_specs();
+
+    for (auto const chunk_size : {1U, 100U, 1000U, 1024U * 1024U}) {
+      auto const actual = get_chunked_specs(services_file.lf_, chunk_size);
+      ASSERT_EQ(expected.size(), actual.size());
+      for (auto i = 0U; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].line_number_from_, actual[i].line_number_from_);
+        EXPECT_EQ(expected[i].line_number_to_, actual[i].line_number_to_);
+        EXPECT_EQ(expected[i].internal_service_,
+                  actual[i].internal_service_);
+        EXPECT_EQ(expected[i].stops_, actual[i].stops_);
+        EXPECT_EQ(expected[i].traffic_days_, actual[i].traffic_days_);
+      }
+    }
+  }
+}
+
+}  // namespace motis::loader::hrd
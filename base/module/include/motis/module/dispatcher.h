@@ -2,7 +2,9 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
+#include <string>
 #include <string_view>
 
 #include "ctx/ctx.h"
@@ -12,6 +14,7 @@
 #include "motis/module/message.h"
 #include "motis/module/receiver.h"
 #include "motis/module/registry.h"
+#include "motis/module/response_cache.h"
 #include "motis/module/timer.h"
 
 namespace motis::module {
@@ -55,12 +58,22 @@ struct dispatcher : public receiver, public ctx::access_scheduler<ctx_data> {
   void handle_no_target(msg_ptr const& msg, callback const& cb);
   void retry_no_target_msgs();
 
+  std::optional<std::string> response_cache_key(std::string const& target,
+                                                msg_ptr const& msg,
+                                                op const& o);
+  unixtime schedule_epoch(ctx::accesses_t const& op_access);
+
   registry& registry_;
   bool queue_no_target_msgs_{false};
   std::queue<std::pair<msg_ptr, callback>> no_target_msg_queue_;
   std::vector<std::unique_ptr<module>> modules_;
   std::map<std::string, std::shared_ptr<timer>> timers_;
 
+  // Caches routing responses (nullptr = disabled).
+  // Entries are keyed by the schedule's RT update epoch and the cache is
+  // cleared whenever an RT update is published.
+  std::unique_ptr<response_cache> response_cache_;
+
   // If this is set to a value != nullptr, it indicates direct mode is on.
   // This implies that in direct mode there can only be one global dispatcher.
   // Direct mode means that
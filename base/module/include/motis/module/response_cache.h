@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "motis/core/common/unixtime.h"
+
+#include "motis/module/future.h"
+#include "motis/module/message.h"
+
+namespace motis::module {
+
+struct response_cache_statistics {
+  std::uint64_t hits_{};
+  std::uint64_t misses_{};
+  std::uint64_t coalesced_{};
+  std::uint64_t evictions_{};
+  std::uint64_t invalidations_{};
+  std::uint64_t entries_{};
+  std::uint64_t size_bytes_{};
+};
+
+// Size-bounded LRU cache for responses of side-effect free operations.
+// Concurrent requests with the same key wait for a single computation
+// (only if coalesce = true, requires the callers to run in ctx operations).
+// Every caller receives its own copy of the response message because
+// responses are mutated downstream (e.g. to set the request id).
+struct response_cache {
+  using compute_fn_t = std::function<msg_ptr()>;
+
+  explicit response_cache(std::size_t max_size_bytes);
+
+  // Key = target + schedule epoch + request content in canonical form
+  // (content table re-serialized in schema field order, i.e. independent of
+  // the field order / layout chosen by the client's serializer).
+  // Message id and destination are not part of the key.
+  static std::string make_key(std::string_view target, unixtime epoch,
+                              Message const*);
+
+  msg_ptr get_or_compute(std::string const& key, compute_fn_t const&,
+                         bool coalesce);
+
+  // Drops all entries. Computations started before the call
+  // will not be stored in the cache.
+  void clear();
+
+  std::size_t max_size_bytes() const { return max_size_bytes_; }
+
+  response_cache_statistics get_statistics() const;
+
+private:
+  struct entry {
+    msg_ptr response_;
+    std::list<std::string const*>::iterator lru_it_;
+    std::size_t size_{0U};
+  };
+
+  static msg_ptr copy(msg_ptr const&);
+
+  void insert(std::string const& key, msg_ptr const& response);
+  void evict();
+
+  std::size_t max_size_bytes_;
+  std::size_t size_bytes_{0U};
+  std::uint64_t generation_{0U};
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, entry> entries_;
+  std::unordered_map<std::string, future> pending_;
+  std::list<std::string const*> lru_;  // front = most recently used
+  response_cache_statistics stats_;
+};
+
+}  // namespace motis::module
@@ -1,5 +1,7 @@
 #include "motis/module/dispatcher.h"
 
+#include <algorithm>
+#include <array>
 #include <queue>
 #include <string_view>
 
@@ -11,6 +13,7 @@
 #include "utl/to_vec.h"
 
 #include "motis/core/common/logging.h"
+#include "motis/core/schedule/schedule.h"
 #include "motis/module/error.h"
 #include "motis/module/global_res_ids.h"
 #include "motis/module/module.h"
@@ -19,6 +22,15 @@ namespace motis::module {
 
 dispatcher* dispatcher::direct_mode_dispatcher_ = nullptr;  // NOLINT
 
+// Targets answering RoutingRequest messages without side effects.
+constexpr auto const kCachedRoutingTargets =
+    std::array<std::string_view, 4>{"/routing", "/csa", "/raptor",
+                                    "/tripbased"};
+
+// Published after the schedule has been modified by real-time updates.
+constexpr auto const kRtUpdateTopics =
+    std::array<std::string_view, 2>{"/rt/update", "/rt/graph_updated"};
+
 dispatcher::dispatcher(registry& reg,
                        std::vector<std::unique_ptr<module>>&& modules)
     : ctx::access_scheduler<ctx_data>(
@@ -65,6 +77,12 @@ bool dispatcher::connect_ok(std::string const& target) {
 std::vector<future> dispatcher::publish(msg_ptr const& msg,
                                         ctx_data const& data, ctx::op_id id) {
   id.name = msg->get()->destination()->target()->str();
+  if (response_cache_ != nullptr &&
+      std::find(begin(kRtUpdateTopics), end(kRtUpdateTopics), id.name) !=
+          end(kRtUpdateTopics)) {
+    response_cache_->clear();
+  }
+
   auto it = registry_.topic_subscriptions_.find(id.name);
   if (it == end(registry_.topic_subscriptions_)) {
     return {};
@@ -111,6 +129,13 @@ void dispatcher::dispatch(msg_ptr const& msg, callback const& cb, ctx::op_id id,
   auto const run = [this, id, cb, msg]() {
     try {
       if (auto const op = registry_.get_operation(id.name)) {
+        if (auto const key = response_cache_key(id.name, msg, *op);
+            key.has_value()) {
+          return cb(response_cache_->get_or_compute(
+                        *key, [&]() { return op->fn_(msg); },
+                        direct_mode_dispatcher_ == nullptr),
+                    std::error_code());
+        }
         return cb(op->fn_(msg), std::error_code());
       } else if (auto const remote_op = registry_.get_remote_op(id.name);
                  remote_op.has_value()) {
@@ -159,6 +184,40 @@ msg_ptr dispatcher::api_desc(int const id) const {
   return make_msg(fbb);
 }
 
+std::optional<std::string> dispatcher::response_cache_key(
+    std::string const& target, msg_ptr const& msg, op const& o) {
+  if (response_cache_ == nullptr ||
+      msg->get()->content_type() != MsgContent_RoutingRequest ||
+      std::none_of(begin(kCachedRoutingTargets), end(kCachedRoutingTargets),
+                   [&](std::string_view const t) {
+                     return std::string_view{target}.substr(0, t.size()) == t;
+                   })) {
+    return std::nullopt;
+  }
+
+  // The RT update epoch is only tracked for the default schedule.
+  if (motis_content(RoutingRequest, msg)->schedule() != 0U) {
+    return std::nullopt;
+  }
+
+  return response_cache::make_key(target, schedule_epoch(o.access_),
+                                  msg->get());
+}
+
+unixtime dispatcher::schedule_epoch(ctx::accesses_t const& op_access) {
+  auto const res_id = to_res_id(global_res_id::SCHEDULE);
+  if (direct_mode_dispatcher_ != nullptr ||
+      std::any_of(begin(op_access), end(op_access),
+                  [&](auto const& a) { return a.res_id_ == res_id; })) {
+    return get<schedule_data>(res_id).schedule_->last_update_timestamp_;
+  }
+
+  // The operation locks the schedule itself (e.g. /routing).
+  auto lock = ctx::access_scheduler<ctx_data>::mutex{
+      *this, ctx::op_type_t::WORK, {{res_id, ctx::access_t::READ}}};
+  return lock.get<schedule_data>(res_id).schedule_->last_update_timestamp_;
+}
+
 void dispatcher::handle_no_target(msg_ptr const& msg, callback const& cb) {
   if (queue_no_target_msgs_) {
     no_target_msg_queue_.emplace(msg, cb);
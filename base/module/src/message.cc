@@ -1,7 +1,9 @@
 #include "motis/module/message.h"
 
 #include <cstring>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
 
 #include "flatbuffers/idl.h"
 #include "flatbuffers/util.h"
@@ -47,6 +49,51 @@ reflection::Schema const& init_schema(Parser& parser) {
   return *reflection::GetSchema(parser.builder_.GetBufferPointer());
 }
 
+// flatbuffers::Parser::Parse is not thread-safe (it writes into the parser's
+// builder_). Parsers are expensive to set up (all schemas have to be parsed),
+// so they are kept in a pool and reused instead of being created per request.
+struct json_parser_pool {
+  struct handle {
+    handle(json_parser_pool& pool, std::unique_ptr<Parser> parser)
+        : pool_{pool}, parser_{std::move(parser)} {}
+    handle(handle const&) = delete;
+    handle(handle&&) = delete;
+    handle& operator=(handle const&) = delete;
+    handle& operator=(handle&&) = delete;
+    ~handle() { pool_.release(std::move(parser_)); }
+
+    Parser* operator->() const { return parser_.get(); }
+
+    json_parser_pool& pool_;
+    std::unique_ptr<Parser> parser_;
+  };
+
+  handle acquire() {
+    {
+      std::lock_guard const lock{mutex_};
+      if (!parsers_.empty()) {
+        auto parser = std::move(parsers_.back());
+        parsers_.pop_back();
+        return {*this, std::move(parser)};
+      }
+    }
+    return {*this, init_parser()};
+  }
+
+  void release(std::unique_ptr<Parser> parser) {
+    parser->builder_.Clear();
+    std::lock_guard const lock{mutex_};
+    parsers_.emplace_back(std::move(parser));
+  }
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Parser>> parsers_;
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static json_parser_pool json_parsers;
+
+// Only used for GenerateText (read-only access -> safe to share).
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 static std::unique_ptr<Parser> json_parser = init_parser();
 
@@ -84,23 +131,21 @@ msg_ptr make_msg(std::string const& json, bool const fix,
     throw std::system_error(error::unable_to_parse_msg);
   }
 
-  bool parse_ok =
-      json_parser->Parse(fix ? fix_json(json).c_str() : json.c_str());
+  auto const parser = json_parsers.acquire();
+  bool parse_ok = parser->Parse(fix ? fix_json(json).c_str() : json.c_str());
   if (!parse_ok) {
-    LOG(motis::logging::error) << "parse error: " << json_parser->error_;
+    LOG(motis::logging::error) << "parse error: " << parser->error_;
     throw std::system_error(error::unable_to_parse_msg);
   }
 
-  flatbuffers::Verifier verifier(json_parser->builder_.GetBufferPointer(),
-                                 json_parser->builder_.GetSize(), fbs_max_depth,
+  flatbuffers::Verifier verifier(parser->builder_.GetBufferPointer(),
+                                 parser->builder_.GetSize(), fbs_max_depth,
                                  fbs_max_tables);
   if (!VerifyMessageBuffer(verifier)) {
     throw std::system_error(error::malformed_msg);
   }
-  auto size = json_parser->builder_.GetSize();
-  auto buffer = json_parser->builder_.ReleaseBufferPointer();
-
-  json_parser->builder_.Clear();
+  auto size = parser->builder_.GetSize();
+  auto buffer = parser->builder_.ReleaseBufferPointer();
   return std::make_shared<message>(size, std::move(buffer));
 }
 
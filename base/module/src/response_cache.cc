@@ -0,0 +1,150 @@
+#include "motis/module/response_cache.h"
+
+#include "utl/verify.h"
+
+namespace motis::module {
+
+// Approximate memory overhead per cache entry (map node, list node, ...).
+constexpr auto const kEntryOverhead = std::size_t{128U};
+
+response_cache::response_cache(std::size_t const max_size_bytes)
+    : max_size_bytes_{max_size_bytes} {}
+
+std::string response_cache::make_key(std::string_view const target,
+                                     unixtime const epoch,
+                                     Message const* msg) {
+  auto const& schema = message::get_schema();
+  auto const* msg_obj = message::get_objectref("motis.Message");
+  utl::verify(msg_obj != nullptr, "response_cache: message schema not found");
+  auto const* content_field = msg_obj->fields()->LookupByKey("content");
+  auto const* content_enum =
+      schema.enums()->Get(content_field->type()->index());
+  auto const* content_val = content_enum->values()->LookupByKey(
+      static_cast<int64_t>(msg->content_type()));
+  utl::verify(content_val != nullptr, "response_cache: unknown content type");
+  auto const* content_obj =
+      schema.objects()->Get(content_val->union_type()->index());
+
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(flatbuffers::CopyTable(
+      fbb, schema, *content_obj,
+      *reinterpret_cast<flatbuffers::Table const*>(msg->content())));
+
+  auto key = std::string{target};
+  key.push_back('\0');
+  key.append(reinterpret_cast<char const*>(&epoch), sizeof(epoch));
+  key.append(reinterpret_cast<char const*>(fbb.GetBufferPointer()),
+             fbb.GetSize());
+  return key;
+}
+
+msg_ptr response_cache::copy(msg_ptr const& msg) {
+  return msg == nullptr ? msg
+                        : std::make_shared<message>(msg->size(), msg->data());
+}
+
+msg_ptr response_cache::get_or_compute(std::string const& key,
+                                       compute_fn_t const& compute,
+                                       bool const coalesce) {
+  auto f = future{};
+  auto generation = std::uint64_t{};
+  {
+    std::unique_lock lock{mutex_};
+    if (auto const it = entries_.find(key); it != end(entries_)) {
+      ++stats_.hits_;
+      lru_.splice(begin(lru_), lru_, it->second.lru_it_);
+      auto const response = it->second.response_;
+      lock.unlock();
+      return copy(response);
+    }
+
+    if (coalesce) {
+      if (auto const it = pending_.find(key); it != end(pending_)) {
+        ++stats_.coalesced_;
+        auto const pending = it->second;
+        lock.unlock();
+        return copy(pending->val());
+      }
+      f = make_future(ctx::op_id{"response_cache"});
+      pending_.emplace(key, f);
+    }
+
+    ++stats_.misses_;
+    generation = generation_;
+  }
+
+  auto response = msg_ptr{};
+  try {
+    response = compute();
+  } catch (...) {
+    if (f != nullptr) {
+      {
+        std::lock_guard const lock{mutex_};
+        pending_.erase(key);
+      }
+      f->set(std::current_exception());
+    }
+    throw;
+  }
+
+  {
+    std::lock_guard const lock{mutex_};
+    if (f != nullptr) {
+      pending_.erase(key);
+    }
+    if (generation == generation_ && response != nullptr &&
+        response->get()->content_type() != MsgContent_MotisError) {
+      insert(key, response);
+    }
+  }
+  if (f != nullptr) {
+    f->set(response);
+  }
+
+  return copy(response);
+}
+
+void response_cache::insert(std::string const& key, msg_ptr const& response) {
+  auto const size = kEntryOverhead + key.size() + response->size();
+  if (size > max_size_bytes_) {
+    return;
+  }
+
+  auto const [it, inserted] = entries_.emplace(key, entry{});
+  if (!inserted) {
+    return;
+  }
+  lru_.push_front(&it->first);
+  it->second = entry{response, begin(lru_), size};
+  size_bytes_ += size;
+  evict();
+}
+
+void response_cache::evict() {
+  while (size_bytes_ > max_size_bytes_ && !lru_.empty()) {
+    auto const it = entries_.find(*lru_.back());
+    size_bytes_ -= it->second.size_;
+    lru_.pop_back();
+    entries_.erase(it);
+    ++stats_.evictions_;
+  }
+}
+
+void response_cache::clear() {
+  std::lock_guard const lock{mutex_};
+  ++generation_;
+  ++stats_.invalidations_;
+  lru_.clear();
+  entries_.clear();
+  size_bytes_ = 0U;
+}
+
+response_cache_statistics response_cache::get_statistics() const {
+  std::lock_guard const lock{mutex_};
+  auto stats = stats_;
+  stats.entries_ = entries_.size();
+  stats.size_bytes_ = size_bytes_;
+  return stats;
+}
+
+}  // namespace motis::module
@@ -0,0 +1,51 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "motis/module/message.h"
+
+using namespace motis::module;
+
+TEST(module_message, concurrent_make_msg) {
+  auto const json = std::string{R"({
+    "destination": { "target": "/lookup/meta_station" },
+    "content_type": "LookupMetaStationRequest",
+    "content": { "station_id": "8000105" }
+  })"};
+  auto const expected = make_msg(json, true)->to_json();
+
+  constexpr auto const kThreads = 8U;
+  constexpr auto const kIterations = 100U;
+  std::vector<std::vector<std::string>> results(kThreads);
+  std::vector<std::thread> threads;
+  for (auto t = 0U; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (auto i = 0U; i < kIterations; ++i) {
+        results[t].emplace_back(make_msg(json, true)->to_json());
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (auto const& thread_results : results) {
+    ASSERT_EQ(kIterations, thread_results.size());
+    for (auto const& r : thread_results) {
+      EXPECT_EQ(expected, r);
+    }
+  }
+}
+
+TEST(module_message, parse_error_does_not_poison_parser) {
+  EXPECT_THROW(make_msg(std::string{"{ invalid"}), std::system_error);
+
+  auto const json = std::string{R"({
+    "destination": { "target": "/test" },
+    "content_type": "MotisSuccess",
+    "content": {}
+  })"};
+  auto const msg = make_msg(json, true);
+  EXPECT_EQ("/test", msg->get()->destination()->target()->str());
+}
@@ -0,0 +1,117 @@
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "motis/module/message.h"
+#include "motis/module/response_cache.h"
+
+using namespace motis;
+using namespace motis::module;
+using namespace motis::lookup;
+
+msg_ptr make_geo_station_request(double const max_radius, int const id,
+                                 bool const pad) {
+  message_creator fbb;
+  if (pad) {
+    fbb.CreateString("unrelated data to shift the table layout");
+  }
+  auto const pos = Position{49.8, 8.6};
+  fbb.create_and_finish(
+      MsgContent_LookupGeoStationRequest,
+      CreateLookupGeoStationRequest(fbb, &pos, 0.0, max_radius).Union(),
+      "/lookup/geo_station", DestinationType_Module, id);
+  return make_msg(fbb);
+}
+
+msg_ptr make_response(std::string const& target) {
+  return make_success_msg(target);
+}
+
+TEST(module_response_cache, key_is_canonical) {
+  auto const a = make_geo_station_request(100.0, 1, false);
+  auto const b = make_geo_station_request(100.0, 2, true);
+  auto const c = make_geo_station_request(200.0, 1, false);
+
+  ASSERT_NE(a->to_string(), b->to_string());
+
+  auto const key_a = response_cache::make_key("/lookup", 1, a->get());
+  EXPECT_EQ(key_a, response_cache::make_key("/lookup", 1, b->get()));
+  EXPECT_NE(key_a, response_cache::make_key("/lookup", 1, c->get()));
+  EXPECT_NE(key_a, response_cache::make_key("/lookup", 2, a->get()));
+  EXPECT_NE(key_a, response_cache::make_key("/routing", 1, a->get()));
+}
+
+TEST(module_response_cache, hit_miss) {
+  response_cache cache{1024U * 1024U};
+  auto computations = 0U;
+  auto const compute = [&]() {
+    ++computations;
+    return make_response("a");
+  };
+
+  auto const first = cache.get_or_compute("a", compute, false);
+  auto const second = cache.get_or_compute("a", compute, false);
+  EXPECT_EQ(1U, computations);
+  ASSERT_NE(nullptr, second);
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_EQ(first->to_string(), second->to_string());
+
+  cache.get_or_compute("b", compute, false);
+  EXPECT_EQ(2U, computations);
+
+  auto const stats = cache.get_statistics();
+  EXPECT_EQ(1U, stats.hits_);
+  EXPECT_EQ(2U, stats.misses_);
+  EXPECT_EQ(2U, stats.entries_);
+
+  cache.clear();
+  cache.get_or_compute("a", compute, false);
+  EXPECT_EQ(3U, computations);
+  EXPECT_EQ(1U, cache.get_statistics().invalidations_);
+}
+
+TEST(module_response_cache, errors_are_not_cached) {
+  response_cache cache{1024U * 1024U};
+  auto computations = 0U;
+
+  for (auto i = 0U; i < 2U; ++i) {
+    EXPECT_THROW(cache.get_or_compute(
+                     "a",
+                     [&]() -> msg_ptr {
+                       ++computations;
+                       throw std::runtime_error{"error"};
+                     },
+                     false),
+                 std::runtime_error);
+    cache.get_or_compute(
+        "b",
+        [&]() {
+          ++computations;
+          return make_error_msg(error::unexpected_message_type);
+        },
+        false);
+  }
+  EXPECT_EQ(4U, computations);
+  EXPECT_EQ(0U, cache.get_statistics().entries_);
+}
+
+TEST(module_response_cache, size_limit) {
+  auto const response_size = make_response("x")->size();
+  response_cache cache{3U * (response_size + 128U + 1U)};
+  auto const compute = []() { return make_response("x"); };
+
+  for (auto const key : {"a", "b", "c", "d"}) {
+    cache.get_or_compute(key, compute, false);
+  }
+
+  auto const stats = cache.get_statistics();
+  EXPECT_EQ(3U, stats.entries_);
+  EXPECT_EQ(1U, stats.evictions_);
+  EXPECT_LE(stats.size_bytes_, cache.max_size_bytes());
+
+  // least recently used entry ("a") was evicted
+  cache.get_or_compute("b", compute, false);
+  EXPECT_EQ(1U, cache.get_statistics().hits_);
+  cache.get_or_compute("a", compute, false);
+  EXPECT_EQ(5U, cache.get_statistics().misses_);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include "motis/module/context/motis_http_req.h"
+
+namespace motis::gbfs {
+
+// Response body of a GBFS feed URL. file:// URLs are read from disk
+// (tests and offline setups), other URLs are requested via motis_http.
+struct feed_body {
+  explicit feed_body(std::string const& url);
+
+  std::string const& get();
+
+private:
+  motis::module::http_future_t f_;
+  std::string body_;
+};
+
+}  // namespace motis::gbfs
@@ -10,6 +10,7 @@ namespace motis::gbfs {
 
 struct config {
   unsigned update_interval_minutes_{5U};
+  unsigned precomputed_walk_duration_{15U};
   std::vector<std::string> urls_;
 };
 
@@ -20,4 +20,7 @@ struct urls {
 
 std::vector<urls> read_system_status(std::string_view);
 
+// Returns the "ttl" (seconds) of a GBFS feed (0 if missing).
+unsigned read_ttl(std::string_view);
+
 }  // namespace motis::gbfs
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "cista/hash.h"
+#include "cista/memory_holder.h"
+
+#include "geo/point_rtree.h"
+
+#include "motis/vector.h"
+
+#include "motis/core/schedule/schedule.h"
+#include "motis/gbfs/station.h"
+
+namespace motis::gbfs {
+
+struct pt_walk {
+  uint32_t pt_station_{0U};  // schedule station index
+  double duration_{0.0};  // seconds
+};
+
+// Precomputed foot routing durations between the stations of a GBFS provider
+// and all PT stations within walking distance. Station positions are static,
+// so only the query position dependent walks have to be routed per request.
+struct walk_table {
+  std::optional<double> station_to_pt(std::size_t station_idx,
+                                      uint32_t pt_station) const;
+  std::optional<double> pt_to_station(uint32_t pt_station,
+                                      std::size_t station_idx) const;
+
+  cista::hash_t hash_{0U};
+  unsigned max_duration_{0U};  // minutes
+
+  // indexed by GBFS station index, sorted by PT station index
+  mcd::vector<mcd::vector<pt_walk>> station_to_pt_, pt_to_station_;
+};
+
+cista::hash_t walk_table_hash(std::vector<station> const&, schedule const&,
+                              unsigned max_duration);
+
+walk_table compute_walk_table(std::vector<station> const&, schedule const&,
+                              geo::point_rtree const& pt_stations_rtree,
+                              unsigned max_duration);
+
+walk_table const* read_walk_table(std::string const& path,
+                                  cista::memory_holder&);
+void write_walk_table(std::string const& path, walk_table const&);
+
+}  // namespace motis::gbfs
@@ -0,0 +1,31 @@
+#include "motis/gbfs/feed_body.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "utl/verify.h"
+
+using namespace motis::module;
+
+namespace motis::gbfs {
+
+feed_body::feed_body(std::string const& url) {
+  if (url.starts_with("file://")) {
+    std::ifstream in{url.substr(7), std::ios_base::binary};
+    utl::verify(in.is_open(), "GBFS: unable to open {}", url);
+    body_.assign(std::istreambuf_iterator<char>{in},
+                 std::istreambuf_iterator<char>{});
+  } else {
+    f_ = motis_http(url);
+  }
+}
+
+std::string const& feed_body::get() {
+  if (f_) {
+    body_ = f_->val().body;
+    f_ = nullptr;
+  }
+  return body_;
+}
+
+}  // namespace motis::gbfs
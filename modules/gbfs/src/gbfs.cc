@@ -1,12 +1,18 @@
 #include "motis/gbfs/gbfs.h"
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 #include <numeric>
+#include <optional>
+
+#include "boost/filesystem.hpp"
 
 #include "utl/concat.h"
 #include "utl/enumerate.h"
 #include "utl/erase_duplicates.h"
 #include "utl/pipes.h"
+#include "utl/verify.h"
 
 #include "geo/point_rtree.h"
 
@@ -19,12 +25,15 @@
 #include "motis/module/context/motis_parallel_for.h"
 #include "motis/module/event_collector.h"
 #include "motis/module/message.h"
+#include "motis/gbfs/feed_body.h"
 #include "motis/gbfs/free_bike.h"
 #include "motis/gbfs/station.h"
 #include "motis/gbfs/system_information.h"
 #include "motis/gbfs/system_status.h"
+#include "motis/gbfs/walk_table.h"
 
 namespace fbs = flatbuffers;
+namespace fs = boost::filesystem;
 using namespace motis::logging;
 using namespace motis::module;
 
@@ -33,10 +42,31 @@ namespace motis::gbfs {
 struct positions {};
 
 struct gbfs::impl {
-  explicit impl(config const& c, schedule const& sched)
-      : config_{c}, sched_{sched} {}
+  struct walk_data {
+    cista::memory_holder mem_;
+    walk_table const* table_{nullptr};
+  };
 
-  void fetch_stream(std::string url) {
+  struct provider_status {
+    system_information info_;
+    std::string vehicle_type_;
+    std::vector<station> stations_;
+    std::vector<free_bike> free_bikes_;
+    geo::point_rtree free_bikes_rtree_, stations_rtree_;
+    std::shared_ptr<walk_data const> walks_;
+    std::chrono::steady_clock::time_point next_update_;
+  };
+
+  impl(config const& c, schedule const& sched, fs::path data_dir)
+      : config_{c}, sched_{sched}, data_dir_{std::move(data_dir)} {}
+
+  struct feed {
+    std::string tag_;
+    std::string vehicle_type_;
+    std::string url_;
+  };
+
+  static feed parse_feed(std::string url) {
     auto tag = std::string{};
     auto vehicle_type = std::string{"bike"};
     auto const tag_pos = url.find('|');
@@ -51,70 +81,178 @@ struct gbfs::impl {
 
       url = url.substr(tag_pos + 1);
     }
+    return {tag, vehicle_type, url};
+  }
 
-    auto const s = read_system_status(motis_http(url)->val().body);
+  std::shared_ptr<provider_status> fetch_stream(feed const& f) {
+    auto const s = read_system_status(feed_body{f.url_}.get());
     if (s.empty()) {
-      l(warn, "no feeds from {}", url);
-      return;
+      l(warn, "no feeds from {}", f.url_);
+      return nullptr;
     }
 
     auto const& urls = s.front();
 
-    auto f_station_info = http_future_t{};
-    auto f_station_status = http_future_t{};
-    auto f_free_bikes = http_future_t{};
-    auto f_system_info = http_future_t{};
+    auto f_station_info = std::optional<feed_body>{};
+    auto f_station_status = std::optional<feed_body>{};
+    auto f_free_bikes = std::optional<feed_body>{};
+    auto f_system_info = std::optional<feed_body>{};
 
     if (urls.station_info_url_.has_value()) {
-      f_station_info = motis_http(*urls.station_info_url_);
-      f_station_status = motis_http(*urls.station_status_url_);
+      f_station_info.emplace(*urls.station_info_url_);
+      f_station_status.emplace(*urls.station_status_url_);
     }
 
     if (urls.free_bike_url_.has_value()) {
-      f_free_bikes = motis_http(*urls.free_bike_url_);
+      f_free_bikes.emplace(*urls.free_bike_url_);
     }
 
     if (urls.system_information_url_.has_value()) {
-      f_system_info = motis_http(*urls.system_information_url_);
+      f_system_info.emplace(*urls.system_information_url_);
     }
 
-    auto const lock = std::scoped_lock{mutex_};
-    auto& info = status_[tag];
-    info.vehicle_type_ = vehicle_type;
+    // Availability data is refreshed once the shortest ttl of the
+    // station status / free bike feeds has passed.
+    auto ttl = std::optional<unsigned>{};
+    auto const update_ttl = [&](std::string const& body) {
+      auto const feed_ttl = read_ttl(body);
+      ttl = ttl.has_value() ? std::min(*ttl, feed_ttl) : feed_ttl;
+    };
+
+    auto info = std::make_shared<provider_status>();
+    info->vehicle_type_ = f.vehicle_type_;
     if (urls.station_info_url_.has_value()) {
-      info.stations_ =
-          utl::to_vec(parse_stations(tag, f_station_info->val().body,
-                                     f_station_status->val().body),
-                      [](auto const& el) { return el.second; });
-      info.stations_rtree_ = geo::make_point_rtree(
-          utl::to_vec(info.stations_, [](auto&& s) { return s.pos_; }));
+      auto const& status = f_station_status->get();
+      update_ttl(status);
+      info->stations_ = utl::to_vec(
+          parse_stations(f.tag_, f_station_info->get(), status),
+          [](auto const& el) { return el.second; });
+      info->stations_rtree_ = geo::make_point_rtree(
+          utl::to_vec(info->stations_, [](auto&& s) { return s.pos_; }));
     }
     if (urls.free_bike_url_.has_value()) {
-      info.free_bikes_ = parse_free_bikes(tag, f_free_bikes->val().body);
-      info.free_bikes_rtree_ = geo::make_point_rtree(
-          utl::to_vec(info.free_bikes_, [](auto&& s) { return s.pos_; }));
+      auto const& free_bikes = f_free_bikes->get();
+      update_ttl(free_bikes);
+      info->free_bikes_ = parse_free_bikes(f.tag_, free_bikes);
+      info->free_bikes_rtree_ = geo::make_point_rtree(
+          utl::to_vec(info->free_bikes_, [](auto&& s) { return s.pos_; }));
     }
     if (urls.system_information_url_.has_value()) {
-      info.info_ = read_system_information(f_system_info->val().body);
+      info->info_ = read_system_information(f_system_info->get());
     }
+    info->next_update_ = std::chrono::steady_clock::now() +
+                         std::chrono::seconds{ttl.value_or(0U)};
+    return info;
   }
 
   void init(schedule const& sched) {
     auto const t = scoped_timer{"GBFS init"};
-    motis_parallel_for(config_.urls_, [&](auto&& url) { fetch_stream(url); });
-
-    auto const lock = std::scoped_lock{mutex_};
     pt_stations_rtree_ =
         geo::make_point_rtree(sched.stations_, [](auto const& s) {
           return geo::latlng{s->lat(), s->lng()};
         });
-    for (auto const& [tag, info] : status_) {
+    feeds_ = utl::to_vec(config_.urls_, parse_feed);
+    update(utl::to_vec(feeds_, [](feed const& f) { return &f; }));
+  }
+
+  // Called by the update timer: refreshes all feeds whose ttl has expired.
+  void update() {
+    auto const now = std::chrono::steady_clock::now();
+    auto due = std::vector<feed const*>{};
+    {
+      auto const lock = std::scoped_lock{mutex_};
+      for (auto const& f : feeds_) {
+        auto const it = status_.find(f.tag_);
+        if (it == end(status_) || it->second->next_update_ <= now) {
+          due.emplace_back(&f);
+        }
+      }
+    }
+    if (!due.empty()) {
+      update(due);
+    }
+  }
+
+  // Fetches the feeds and builds new indices without holding the lock.
+  // Requests keep working on the previous provider status until it is
+  // replaced.
+  void update(std::vector<feed const*> const& feeds) {
+    auto fetched_mutex = std::mutex{};
+    auto fetched = std::vector<
+        std::pair<std::string, std::shared_ptr<provider_status>>>{};
+    motis_parallel_for(feeds, [&](feed const* f) {
+      try {
+        if (auto info = fetch_stream(*f); info != nullptr) {
+          auto const lock = std::scoped_lock{fetched_mutex};
+          fetched.emplace_back(f->tag_, std::move(info));
+        }
+      } catch (std::exception const& e) {
+        l(warn, "GBFS {}: unable to fetch {}: {}", f->tag_, f->url_, e.what());
+      }
+    });
+
+    for (auto& [tag, info] : fetched) {
+      auto const prev = find_status(tag);
+      info->walks_ =
+          load_walk_table(tag, *info, prev == nullptr ? nullptr : prev->walks_);
       l(logging::info,
         "GBFS {} (type={}): loaded {} stations, {} free vehicles", tag,
-        info.vehicle_type_, info.stations_.size(), info.free_bikes_.size());
+        info->vehicle_type_, info->stations_.size(),
+        info->free_bikes_.size());
+
+      auto const lock = std::scoped_lock{mutex_};
+      status_[tag] = std::move(info);
     }
   }
 
+  std::shared_ptr<provider_status const> find_status(std::string const& tag) {
+    auto const lock = std::scoped_lock{mutex_};
+    auto const it = status_.find(tag);
+    return it == end(status_) ? nullptr : it->second;
+  }
+
+  std::shared_ptr<walk_data const> load_walk_table(
+      std::string const& tag, provider_status const& info,
+      std::shared_ptr<walk_data const> prev) {
+    if (config_.precomputed_walk_duration_ == 0U || info.stations_.empty()) {
+      return nullptr;
+    }
+
+    auto const hash = walk_table_hash(info.stations_, sched_,
+                                      config_.precomputed_walk_duration_);
+    if (prev != nullptr && prev->table_->hash_ == hash) {
+      return prev;
+    }
+
+    fs::create_directories(data_dir_);
+    auto const path = (data_dir_ / (tag + "_walks.raw")).generic_string();
+    auto walks = std::make_shared<walk_data>();
+    if (fs::exists(path)) {
+      try {
+        walks->table_ = read_walk_table(path, walks->mem_);
+        if (walks->table_->hash_ == hash) {
+          return walks;
+        }
+      } catch (std::exception const& e) {
+        l(warn, "GBFS {}: unable to read walk table: {}", tag, e.what());
+      }
+      walks = std::make_shared<walk_data>();
+    }
+
+    auto const t = scoped_timer{"GBFS walk table"};
+    auto const table =
+        compute_walk_table(info.stations_, sched_, pt_stations_rtree_,
+                           config_.precomputed_walk_duration_);
+    // The previous table may still be mapped and in use by running requests:
+    // never write to that file, replace it instead (the old mapping keeps
+    // the unlinked file alive).
+    auto const tmp_path = path + ".tmp";
+    write_walk_table(tmp_path, table);
+    fs::rename(tmp_path, path);
+    walks->table_ = read_walk_table(path, walks->mem_);
+    return walks;
+  }
+
   static msg_ptr make_one_to_many(std::string const& profile,
                                   geo::latlng const& one,
                                   std::vector<geo::latlng> const& many,
@@ -190,8 +328,9 @@ struct gbfs::impl {
 
     auto const provider = req->provider()->str();
 
-    auto const lock = std::lock_guard{mutex_};
-    auto const& info = status_.at(provider);
+    auto const info_ptr = find_status(provider);
+    utl::verify(info_ptr != nullptr, "GBFS: unknown provider {}", provider);
+    auto const& info = *info_ptr;
     auto const& stations = info.stations_;
     auto const& stations_rtree = info.stations_rtree_;
     auto const& free_bikes = info.free_bikes_;
@@ -199,6 +338,11 @@ struct gbfs::impl {
     auto const& vehicle_type = info.vehicle_type_;
 
     auto const max_walk_duration = req->max_foot_duration();
+    auto const* walks =
+        (info.walks_ != nullptr &&
+         max_walk_duration <= info.walks_->table_->max_duration_)
+            ? info.walks_->table_
+            : nullptr;
     auto const max_bike_duration = req->max_bike_duration();
     auto const max_walk_dist = max_walk_duration * 60 * max_walk_speed;
     auto const max_bike_dist =
@@ -281,7 +425,7 @@ struct gbfs::impl {
               ? future{}
               : motis_call(make_table_request(vehicle_type, sx_pos, sp_pos));
       auto const f_sp_to_p_walks =
-          (sx.empty() || sp.empty())
+          (sx.empty() || sp.empty() || walks != nullptr)
               ? future{}
               : motis_call(make_table_request("foot", sp_pos, p_pos));
 
@@ -326,8 +470,19 @@ struct gbfs::impl {
             motis_content(OSRMManyToManyResponse, f_sx_to_sp_rides->val())
                 ->costs();
         auto const sp_to_p_table =
-            motis_content(OSRMManyToManyResponse, f_sp_to_p_walks->val())
-                ->costs();
+            f_sp_to_p_walks
+                ? motis_content(OSRMManyToManyResponse, f_sp_to_p_walks->val())
+                      ->costs()
+                : nullptr;
+        auto const get_sp_to_p_walk = [&](std::size_t const sp_vec_idx,
+                                          std::size_t const p_vec_idx) {
+          return sp_to_p_table != nullptr
+                     ? std::optional{sp_to_p_table->Get(
+                           sp_vec_idx * p.size() + p_vec_idx)}
+                     : walks->station_to_pt(
+                           sp.at(sp_vec_idx),
+                           static_cast<uint32_t>(p.at(p_vec_idx)));
+        };
         for (auto const [sx_vec_idx, x_to_sx_res] : utl::enumerate(
                  *motis_content(OSRMOneToManyResponse, f_x_to_sx_walks->val())
                       ->costs())) {
@@ -346,8 +501,12 @@ struct gbfs::impl {
             }
 
             for (auto const& [p_vec_idx, p_id] : utl::enumerate(p)) {
-              auto const sp_to_p_walk_duration = static_cast<duration>(
-                  sp_to_p_table->Get(sp_vec_idx * p.size() + p_vec_idx) / 60.0);
+              auto const sp_to_p_walk = get_sp_to_p_walk(sp_vec_idx, p_vec_idx);
+              if (!sp_to_p_walk.has_value()) {
+                continue;
+              }
+              auto const sp_to_p_walk_duration =
+                  static_cast<duration>(*sp_to_p_walk / 60.0);
               if (sp_to_p_walk_duration > max_walk_duration ||
                   x_to_sx_walk_duration + sp_to_p_walk_duration >
                       max_walk_duration) {
@@ -385,7 +544,7 @@ struct gbfs::impl {
       // REQUESTS
       // station BWD: [p] --walk--> [sp] --bike--> [sx] --walk--> x
       auto const f_p_to_sp_walks =
-          (sp_pos.empty() || sx_pos.empty())
+          (sp_pos.empty() || sx_pos.empty() || walks != nullptr)
               ? future{}
               : motis_call(make_table_request("foot", p_pos, sp_pos));
       auto const f_sp_to_sx_rides =
@@ -436,10 +595,21 @@ struct gbfs::impl {
 
       // BUILD JOURNEYS
       // station BWD: [p] --walk--> [sp] --bike--> [sx] --walk--> x
-      if (f_p_to_b_walks && f_sp_to_sx_rides) {
+      if (f_sp_to_sx_rides) {
         auto const p_to_sp_table =
-            motis_content(OSRMManyToManyResponse, f_p_to_sp_walks->val())
-                ->costs();
+            f_p_to_sp_walks
+                ? motis_content(OSRMManyToManyResponse, f_p_to_sp_walks->val())
+                      ->costs()
+                : nullptr;
+        auto const get_p_to_sp_walk = [&](std::size_t const p_vec_idx,
+                                          std::size_t const sp_vec_idx) {
+          return p_to_sp_table != nullptr
+                     ? std::optional{p_to_sp_table->Get(
+                           p_vec_idx * sp.size() + sp_vec_idx)}
+                     : walks->pt_to_station(
+                           static_cast<uint32_t>(p.at(p_vec_idx)),
+                           sp.at(sp_vec_idx));
+        };
         auto const sp_to_sx_table =
             motis_content(OSRMManyToManyResponse, f_sp_to_sx_rides->val())
                 ->costs();
@@ -462,9 +632,12 @@ struct gbfs::impl {
             }
 
             for (auto const& [p_vec_idx, p_id] : utl::enumerate(p)) {
-              auto const p_to_sp_walk_duration = static_cast<duration>(
-                  p_to_sp_table->Get(p_vec_idx * sp.size() + sp_vec_idx) /
-                  60.0);
+              auto const p_to_sp_walk = get_p_to_sp_walk(p_vec_idx, sp_vec_idx);
+              if (!p_to_sp_walk.has_value()) {
+                continue;
+              }
+              auto const p_to_sp_walk_duration =
+                  static_cast<duration>(*p_to_sp_walk / 60.0);
               if (p_to_sp_walk_duration > max_walk_duration ||
                   p_to_sp_walk_duration + sx_to_x_walk_duration >
                       max_walk_duration) {
@@ -562,48 +735,51 @@ struct gbfs::impl {
     return make_msg(fbb);
   }
 
-  msg_ptr info() const {
+  msg_ptr info() {
+    auto const status = [&]() {
+      auto const lock = std::scoped_lock{mutex_};
+      return status_;
+    }();
+
     message_creator fbb;
     fbb.create_and_finish(
         MsgContent_GBFSProvidersResponse,
         CreateGBFSProvidersResponse(
             fbb, fbb.CreateVector(utl::to_vec(
-                     status_,
+                     status,
                      [&](auto&& s) {
                        auto const& [tag, info] = s;
                        return CreateGBFSProvider(
                            fbb, fbb.CreateString(tag),
-                           fbb.CreateString(info.info_.name_),
-                           fbb.CreateString(info.info_.name_short_),
-                           fbb.CreateString(info.info_.operator_),
-                           fbb.CreateString(info.info_.url_),
-                           fbb.CreateString(info.info_.purchase_url_),
-                           fbb.CreateString(info.info_.mail_),
-                           fbb.CreateString(info.vehicle_type_));
+                           fbb.CreateString(info->info_.name_),
+                           fbb.CreateString(info->info_.name_short_),
+                           fbb.CreateString(info->info_.operator_),
+                           fbb.CreateString(info->info_.url_),
+                           fbb.CreateString(info->info_.purchase_url_),
+                           fbb.CreateString(info->info_.mail_),
+                           fbb.CreateString(info->vehicle_type_));
                      })))
             .Union());
     return make_msg(fbb);
   }
 
-  struct provider_status {
-    system_information info_;
-    std::string vehicle_type_;
-    std::vector<station> stations_;
-    std::vector<free_bike> free_bikes_;
-    geo::point_rtree free_bikes_rtree_, stations_rtree_;
-  };
-
   config const& config_;
   schedule const& sched_;
+  fs::path data_dir_;
   std::mutex mutex_;
-  std::map<std::string, provider_status> status_;
+  std::vector<feed> feeds_;
+  std::map<std::string, std::shared_ptr<provider_status const>> status_;
   geo::point_rtree pt_stations_rtree_;
 };
 
 gbfs::gbfs() : module("RIS", "gbfs") {
   param(config_.update_interval_minutes_, "update_interval",
-        "update interval in minutes");
+        "update interval in minutes (feeds are only refetched after their "
+        "ttl has expired, 0 = no updates)");
   param(config_.urls_, "urls", "URLs to fetch data from");
+  param(config_.precomputed_walk_duration_, "precomputed_walk_duration",
+        "max. walk duration [min] between GBFS and PT stations to precompute "
+        "(0 = route all walks on request)");
 }
 
 gbfs::~gbfs() = default;
@@ -639,8 +815,20 @@ void gbfs::import(import_dispatcher& reg) {
 }
 
 void gbfs::init(motis::module::registry& r) {
-  impl_ = std::make_unique<impl>(config_, get_sched());
-  r.subscribe("/init", [&]() { impl_->init(get_sched()); });
+  impl_ = std::make_unique<impl>(config_, get_sched(),
+                                 get_data_directory() / "gbfs");
+  r.subscribe("/init", [&]() {
+    impl_->init(get_sched());
+    if (config_.update_interval_minutes_ != 0U) {
+      shared_data_->register_timer(
+          "GBFS Update",
+          boost::posix_time::minutes{config_.update_interval_minutes_},
+          [&]() { impl_->update(); },
+          ctx::accesses_t{ctx::access_request{
+              to_res_id(::motis::module::global_res_id::SCHEDULE),
+              ctx::access_t::READ}});
+    }
+  });
   r.register_op("/gbfs/route",
                 [&](msg_ptr const& m) { return impl_->route(get_sched(), m); });
   r.register_op("/gbfs/info", [&](msg_ptr const&) { return impl_->info(); });
@@ -51,4 +51,15 @@ std::vector<urls> read_system_status(std::string_view s) {
   });
 }
 
+unsigned read_ttl(std::string_view s) {
+  rapidjson::Document doc;
+  if (doc.Parse(s.data(), s.size()).HasParseError() || !doc.IsObject()) {
+    return 0U;
+  }
+
+  auto const it = doc.FindMember("ttl");
+  return (it != doc.MemberEnd() && it->value.IsUint()) ? it->value.GetUint()
+                                                       : 0U;
+}
+
 }  // namespace motis::gbfs
@@ -0,0 +1,155 @@
+#include "motis/gbfs/walk_table.h"
+
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+
+#include "cista/mmap.h"
+#include "cista/serialization.h"
+
+#include "utl/to_vec.h"
+
+#include "motis/core/conv/position_conv.h"
+#include "motis/module/context/motis_call.h"
+#include "motis/module/context/motis_parallel_for.h"
+#include "motis/module/message.h"
+
+using namespace motis::module;
+
+namespace motis::gbfs {
+
+constexpr auto const CISTA_MODE =
+    cista::mode::WITH_INTEGRITY | cista::mode::WITH_VERSION;
+
+// Upper bound for the walking speed used by OSRM (foot profile: 5km/h).
+// PT stations further away (beeline) can not be reached within the
+// duration limit and are not stored.
+constexpr auto const kMaxWalkSpeed = 1.5;  // m/s
+
+std::optional<double> find_duration(mcd::vector<pt_walk> const& walks,
+                                    uint32_t const pt_station) {
+  auto const it = std::lower_bound(
+      begin(walks), end(walks), pt_station,
+      [](pt_walk const& w, uint32_t const s) { return w.pt_station_ < s; });
+  return (it == end(walks) || it->pt_station_ != pt_station)
+             ? std::nullopt
+             : std::optional{it->duration_};
+}
+
+std::optional<double> walk_table::station_to_pt(
+    std::size_t const station_idx, uint32_t const pt_station) const {
+  return find_duration(station_to_pt_[station_idx], pt_station);
+}
+
+std::optional<double> walk_table::pt_to_station(
+    uint32_t const pt_station, std::size_t const station_idx) const {
+  return find_duration(pt_to_station_[station_idx], pt_station);
+}
+
+cista::hash_t walk_table_hash(std::vector<station> const& stations,
+                              schedule const& sched,
+                              unsigned const max_duration) {
+  auto const hash_pos = [](cista::hash_t const h, double const lat,
+                           double const lng) {
+    double const pos[] = {lat, lng};
+    return cista::hash(
+        std::string_view{reinterpret_cast<char const*>(pos), sizeof(pos)}, h);
+  };
+
+  auto h = cista::hash_combine(cista::BASE_HASH, max_duration);
+  for (auto const& s : stations) {
+    h = hash_pos(h, s.pos_.lat_, s.pos_.lng_);
+  }
+  for (auto const& s : sched.stations_) {
+    h = hash_pos(h, s->lat(), s->lng());
+  }
+  return h;
+}
+
+mcd::vector<pt_walk> route_walks(geo::latlng const& station_pos,
+                                 std::vector<std::size_t> pt_stations,
+                                 schedule const& sched, SearchDir const dir,
+                                 unsigned const max_duration) {
+  if (pt_stations.empty()) {
+    return {};
+  }
+  std::sort(begin(pt_stations), end(pt_stations));
+
+  auto const fbs_pos = to_fbs(station_pos);
+  message_creator mc;
+  mc.create_and_finish(
+      MsgContent_OSRMOneToManyRequest,
+      osrm::CreateOSRMOneToManyRequest(
+          mc, mc.CreateString("foot"), dir, &fbs_pos,
+          mc.CreateVectorOfStructs(utl::to_vec(
+              pt_stations,
+              [&](auto const idx) {
+                auto const& s = *sched.stations_.at(idx);
+                return Position{s.lat(), s.lng()};
+              })))
+          .Union(),
+      "/osrm/one_to_many");
+  auto const res_msg = motis_call(make_msg(mc))->val();
+  auto const costs =
+      motis_content(osrm::OSRMOneToManyResponse, res_msg)->costs();
+
+  mcd::vector<pt_walk> walks;
+  for (auto i = 0U; i < pt_stations.size(); ++i) {
+    auto const dur = costs->Get(i)->duration();
+    if (dur <= max_duration * 60.0) {
+      walks.emplace_back(pt_walk{static_cast<uint32_t>(pt_stations[i]), dur});
+    }
+  }
+  return walks;
+}
+
+walk_table compute_walk_table(std::vector<station> const& stations,
+                              schedule const& sched,
+                              geo::point_rtree const& pt_stations_rtree,
+                              unsigned const max_duration) {
+  auto const max_dist = max_duration * 60.0 * kMaxWalkSpeed;
+
+  walk_table t;
+  t.hash_ = walk_table_hash(stations, sched, max_duration);
+  t.max_duration_ = max_duration;
+  t.station_to_pt_.resize(stations.size());
+  t.pt_to_station_.resize(stations.size());
+
+  std::vector<std::size_t> station_indices(stations.size());
+  std::iota(begin(station_indices), end(station_indices), 0U);
+  motis_parallel_for(station_indices, [&](std::size_t const i) {
+    auto const& pos = stations[i].pos_;
+    auto const pt_stations = pt_stations_rtree.in_radius(pos, max_dist);
+    t.station_to_pt_[i] =
+        route_walks(pos, pt_stations, sched, SearchDir_Forward, max_duration);
+    t.pt_to_station_[i] =
+        route_walks(pos, pt_stations, sched, SearchDir_Backward, max_duration);
+  });
+
+  return t;
+}
+
+walk_table const* read_walk_table(std::string const& path,
+                                  cista::memory_holder& mem) {
+#if defined(MOTIS_SCHEDULE_MODE_OFFSET) && !defined(CLANG_TIDY)
+  mem = cista::buf<cista::mmap>(
+      cista::mmap{path.c_str(), cista::mmap::protection::READ});
+  return cista::deserialize<walk_table, CISTA_MODE>(
+      std::get<cista::buf<cista::mmap>>(mem));
+#elif defined(MOTIS_SCHEDULE_MODE_RAW) || defined(CLANG_TIDY)
+  mem = cista::file(path.c_str(), "r").content();
+  // NOLINTNEXTLINE
+  return cista::deserialize<walk_table, CISTA_MODE>(
+      std::get<cista::buffer>(mem));
+#else
+#error "no ptr mode specified"
+#endif
+}
+
+void write_walk_table(std::string const& path, walk_table const& t) {
+  auto writer = cista::buf<cista::mmap>(
+      cista::mmap{path.c_str(), cista::mmap::protection::WRITE});
+  cista::serialize<CISTA_MODE>(writer, t);
+}
+
+}  // namespace motis::gbfs
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <string>
+
+#include "boost/filesystem.hpp"
+
+#include "motis/gbfs/feed_body.h"
+#include "motis/gbfs/station.h"
+#include "motis/gbfs/system_status.h"
+
+namespace fs = boost::filesystem;
+using namespace motis::gbfs;
+
+namespace {
+
+void write_file(fs::path const& p, std::string const& content) {
+  std::ofstream out{p.generic_string(), std::ios_base::binary};
+  out << content;
+}
+
+std::string file_url(fs::path const& p) {
+  return "file://" + p.generic_string();
+}
+
+}  // namespace
+
+TEST(gbfs, load_feed_from_local_file) {
+  auto const dir = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(dir);
+
+  write_file(dir / "station_information.json", R"({
+"last_updated": 1643129104,
+"ttl": 0,
+"data": {
+"stations": [
+  {"station_id": "A", "lat": 48.7829, "lon": 9.17978, "name": "Station A"}
+]
+}})");
+  write_file(dir / "station_status.json", R"({
+"last_updated": 1643129104,
+"ttl": 0,
+"data": {
+"stations": [
+  {"station_id": "A", "num_bikes_available": 3}
+]
+}})");
+  auto const feed = [&](char const* name, char const* file) {
+    return std::string{R"({"name": ")"} + name + R"(", "url": ")" +
+           file_url(dir / file) + R"("})";
+  };
+  write_file(dir / "gbfs.json",
+             R"({"last_updated": 1643129104, "ttl": 60, "data": {"en": {)"
+             R"("feeds": [)" +
+                 feed("station_information", "station_information.json") +
+                 "," + feed("station_status", "station_status.json") +
+                 "]}}}");
+
+  auto gbfs_body = feed_body{file_url(dir / "gbfs.json")};
+  EXPECT_EQ(60U, read_ttl(gbfs_body.get()));
+  auto const status = read_system_status(gbfs_body.get());
+  ASSERT_EQ(1U, status.size());
+  ASSERT_TRUE(status.front().station_info_url_.has_value());
+  ASSERT_TRUE(status.front().station_status_url_.has_value());
+
+  auto info = feed_body{*status.front().station_info_url_};
+  auto station_status = feed_body{*status.front().station_status_url_};
+  auto const stations =
+      parse_stations("tag-", info.get(), station_status.get());
+  ASSERT_EQ(1U, stations.size());
+  auto const& s = stations.at("tag-A");
+  EXPECT_EQ("Station A", s.name_);
+  EXPECT_EQ(3U, s.bikes_available_);
+
+  EXPECT_ANY_THROW(feed_body{file_url(dir / "missing.json")});
+
+  fs::remove_all(dir);
+}
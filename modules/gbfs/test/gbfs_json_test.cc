@@ -84,3 +84,10 @@ TEST(gbfs, parse_gbfs_json) {
   EXPECT_EQ("https://127.0.0.1/gbfs/v2/station_status.json",
             urls.at(2).station_status_url_);
 }
+
+TEST(gbfs, read_ttl) {
+  EXPECT_EQ(0U, read_ttl(in));
+  EXPECT_EQ(60U, read_ttl(R"({"last_updated": 1640887163, "ttl": 60})"));
+  EXPECT_EQ(0U, read_ttl(R"({"last_updated": 1640887163})"));
+  EXPECT_EQ(0U, read_ttl("invalid"));
+}
@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include "boost/filesystem.hpp"
+
+#include "motis/gbfs/walk_table.h"
+
+using namespace motis::gbfs;
+
+TEST(gbfs, walk_table) {
+  walk_table t;
+  t.hash_ = 42U;
+  t.max_duration_ = 15U;
+  t.station_to_pt_.resize(2U);
+  t.pt_to_station_.resize(2U);
+  t.station_to_pt_[0].emplace_back(pt_walk{3U, 120.0});
+  t.station_to_pt_[0].emplace_back(pt_walk{7U, 300.0});
+  t.pt_to_station_[0].emplace_back(pt_walk{3U, 130.0});
+  t.pt_to_station_[1].emplace_back(pt_walk{5U, 60.0});
+
+  EXPECT_EQ(120.0, t.station_to_pt(0U, 3U));
+  EXPECT_EQ(300.0, t.station_to_pt(0U, 7U));
+  EXPECT_EQ(std::nullopt, t.station_to_pt(0U, 5U));
+  EXPECT_EQ(std::nullopt, t.station_to_pt(1U, 5U));
+  EXPECT_EQ(130.0, t.pt_to_station(3U, 0U));
+  EXPECT_EQ(60.0, t.pt_to_station(5U, 1U));
+
+  auto const path = (boost::filesystem::temp_directory_path() /
+                     boost::filesystem::unique_path("gbfs_walks_%%%%.raw"))
+                        .generic_string();
+  write_walk_table(path, t);
+  {
+    cista::memory_holder mem;
+    auto const* read = read_walk_table(path, mem);
+    ASSERT_NE(nullptr, read);
+    EXPECT_EQ(42U, read->hash_);
+    EXPECT_EQ(15U, read->max_duration_);
+    EXPECT_EQ(300.0, read->station_to_pt(0U, 7U));
+    EXPECT_EQ(60.0, read->pt_to_station(5U, 1U));
+  }
+  boost::filesystem::remove(path);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "motis/module/module.h"
@@ -7,6 +8,8 @@
 
 namespace motis::intermodal {
 
+struct mumo_edge_cache;
+
 struct intermodal : public motis::module::module {
 public:
   intermodal();
@@ -26,7 +29,12 @@ private:
 
   std::string router_{"routing"};
   bool revise_{false};
+  std::size_t edge_cache_size_{0U};
+  unsigned edge_cache_precision_{4U};
+  unsigned edge_cache_ttl_{3600U};
+  unsigned edge_cache_gbfs_ttl_{60U};
   ppr_profiles ppr_profiles_;
+  std::unique_ptr<mumo_edge_cache> edge_cache_;
 };
 
 }  // namespace motis::intermodal
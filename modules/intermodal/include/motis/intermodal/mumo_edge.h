@@ -82,12 +82,20 @@ using appender_fun = std::function<mumo_edge&(
 
 using mumo_stats_appender_fun = std::function<void(stats_category&&)>;
 
+struct mumo_edge_cache;
+
+struct mumo_edge_cache_usage {
+  unsigned hits_{0U};
+  unsigned misses_{0U};
+};
+
 void make_starts(IntermodalRoutingRequest const*, geo::latlng const&,
                  appender_fun const&, mumo_stats_appender_fun const&,
-                 ppr_profiles const&);
+                 ppr_profiles const&, mumo_edge_cache*,
+                 mumo_edge_cache_usage&);
 void make_dests(IntermodalRoutingRequest const*, geo::latlng const&,
                 appender_fun const&, mumo_stats_appender_fun const&,
-                ppr_profiles const&);
+                ppr_profiles const&, mumo_edge_cache*, mumo_edge_cache_usage&);
 
 void remove_intersection(std::vector<mumo_edge>& starts,
                          std::vector<mumo_edge>& destinations,
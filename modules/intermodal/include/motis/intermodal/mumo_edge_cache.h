@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "geo/latlng.h"
+
+#include "motis/core/statistics/statistics.h"
+#include "motis/intermodal/mumo_edge.h"
+
+namespace motis::intermodal {
+
+// LRU cache for the access/egress edges of a single mode at a position.
+// Positions are snapped to a grid, i.e. all queries starting in the same
+// cell share the edges computed for the first query in that cell.
+struct mumo_edge_cache {
+  using clock = std::chrono::steady_clock;
+
+  struct entry {
+    // Edges as passed to the appender: to_ = station id, to_pos_ = station
+    // position (from_ / from_pos_ are unused).
+    std::vector<mumo_edge> edges_;
+    // Statistics of the computation (reported for the miss only).
+    std::vector<stats_category> stats_;
+  };
+
+  using entry_ptr = std::shared_ptr<entry const>;
+
+  // GBFS edges depend on the current vehicle availability and therefore
+  // use their own (usually much shorter) time to live.
+  mumo_edge_cache(std::size_t max_entries, unsigned precision,
+                  clock::duration ttl, clock::duration gbfs_ttl);
+
+  // Empty if edges of this mode should not be cached.
+  std::optional<std::string> key(ModeWrapper const*, geo::latlng const&,
+                                 SearchDir) const;
+
+  // Returns nullptr if the key is not cached or has expired.
+  entry_ptr get(std::string const& key);
+
+  void put(std::string const& key, Mode, entry_ptr);
+
+  void clear();
+
+private:
+  struct cached {
+    entry_ptr entry_;
+    clock::time_point expires_;
+    std::list<std::string>::iterator lru_it_;
+  };
+
+  std::size_t max_entries_;
+  unsigned precision_;
+  clock::duration ttl_, gbfs_ttl_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, cached> entries_;
+  std::list<std::string> lru_;  // front = most recently used
+};
+
+// Statistics reported for a cache hit: the categories of the cached entry
+// with all computation counters set to zero and an "edge_cache_hit" entry.
+std::vector<stats_category> cache_hit_stats(mumo_edge_cache::entry const&);
+
+}  // namespace motis::intermodal
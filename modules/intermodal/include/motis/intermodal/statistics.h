@@ -10,6 +10,8 @@ struct statistics {
   uint64_t linear_distance_{};
   uint64_t dominated_by_direct_connection_{};
   uint64_t mumo_edge_duration_{};
+  uint64_t mumo_edge_cache_hits_{};
+  uint64_t mumo_edge_cache_misses_{};
   uint64_t routing_duration_{};
   uint64_t direct_connection_duration_{};
   uint64_t revise_duration_{};
@@ -23,6 +25,8 @@ inline stats_category to_stats_category(char const* name, statistics const& s) {
        {"linear_distance", s.linear_distance_},
        {"dominated_by_direct_connection", s.dominated_by_direct_connection_},
        {"mumo_edge_duration", s.mumo_edge_duration_},
+       {"mumo_edge_cache_hits", s.mumo_edge_cache_hits_},
+       {"mumo_edge_cache_misses", s.mumo_edge_cache_misses_},
        {"routing_duration", s.routing_duration_},
        {"direct_connection_duration", s.direct_connection_duration_},
        {"revise_duration", s.revise_duration_}}};
@@ -21,6 +21,7 @@
 #include "motis/intermodal/error.h"
 #include "motis/intermodal/eval/commands.h"
 #include "motis/intermodal/mumo_edge.h"
+#include "motis/intermodal/mumo_edge_cache.h"
 #include "motis/intermodal/query_bounds.h"
 #include "motis/intermodal/statistics.h"
 
@@ -38,6 +39,14 @@ namespace motis::intermodal {
 intermodal::intermodal() : module("Intermodal Options", "intermodal") {
   param(router_, "router", "routing module");
   param(revise_, "revise", "revise connections");
+  param(edge_cache_size_, "edge_cache_size",
+        "max. number of cached start/destination edge sets (0 = disabled)");
+  param(edge_cache_precision_, "edge_cache_precision",
+        "decimal places of the coordinates used as edge cache key");
+  param(edge_cache_ttl_, "edge_cache_ttl",
+        "time to live of cached edges in seconds");
+  param(edge_cache_gbfs_ttl_, "edge_cache_gbfs_ttl",
+        "time to live of cached gbfs edges in seconds (0 = no caching)");
 }
 
 intermodal::~intermodal() = default;
@@ -57,6 +66,13 @@ void intermodal::init(motis::module::registry& r) {
     router_ = "/" + router_;
   }
   r.subscribe("/init", [this]() { ppr_profiles_.update(); });
+
+  if (edge_cache_size_ != 0U) {
+    edge_cache_ = std::make_unique<mumo_edge_cache>(
+        edge_cache_size_, edge_cache_precision_,
+        std::chrono::seconds{edge_cache_ttl_},
+        std::chrono::seconds{edge_cache_gbfs_ttl_});
+  }
 }
 
 std::vector<Offset<Connection>> revise_connections(
@@ -439,6 +455,7 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
     mumo_stats.emplace_back(s);
   };
 
+  mumo_edge_cache_usage start_cache_usage, dest_cache_usage;
   std::vector<ctx::future_ptr<ctx_data, void>> futures;
 
   using namespace std::placeholders;
@@ -449,7 +466,8 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
             req, start.pos_,
             std::bind(appender, std::ref(deps),  // NOLINT
                       STATION_START, _1, start.pos_, _2, _3, _4, _5, _6),
-            mumo_stats_appender, ppr_profiles_);
+            mumo_stats_appender, ppr_profiles_, edge_cache_.get(),
+            start_cache_usage);
       }));
     }
     if (dest.is_intermodal_) {
@@ -457,7 +475,8 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
         make_dests(req, dest.pos_,
                    std::bind(appender, std::ref(arrs),  // NOLINT
                              _1, STATION_END, _2, dest.pos_, _3, _4, _5, _6),
-                   mumo_stats_appender, ppr_profiles_);
+                   mumo_stats_appender, ppr_profiles_, edge_cache_.get(),
+                   dest_cache_usage);
       }));
     }
   } else {
@@ -467,7 +486,8 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
             req, start.pos_,
             std::bind(appender, std::ref(deps),  // NOLINT
                       _1, STATION_START, _2, start.pos_, _3, _4, _5, _6),
-            mumo_stats_appender, ppr_profiles_);
+            mumo_stats_appender, ppr_profiles_, edge_cache_.get(),
+            start_cache_usage);
       }));
     }
     if (dest.is_intermodal_) {
@@ -475,7 +495,8 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
         make_dests(req, dest.pos_,
                    std::bind(appender, std::ref(arrs),  // NOLINT
                              STATION_END, _1, dest.pos_, _2, _3, _4, _5, _6),
-                   mumo_stats_appender, ppr_profiles_);
+                   mumo_stats_appender, ppr_profiles_, edge_cache_.get(),
+                   dest_cache_usage);
       }));
     }
   }
@@ -487,6 +508,10 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
   stats.destination_edges_ = arrs.size();
   stats.mumo_edge_duration_ =
       static_cast<uint64_t>(MOTIS_TIMING_MS(mumo_edge_timing));
+  stats.mumo_edge_cache_hits_ =
+      start_cache_usage.hits_ + dest_cache_usage.hits_;
+  stats.mumo_edge_cache_misses_ =
+      start_cache_usage.misses_ + dest_cache_usage.misses_;
 
   if ((start.is_intermodal_ && deps.empty()) ||
       (dest.is_intermodal_ && arrs.empty())) {
@@ -10,6 +10,7 @@
 #include "motis/module/message.h"
 
 #include "motis/intermodal/error.h"
+#include "motis/intermodal/mumo_edge_cache.h"
 
 using namespace geo;
 using namespace flatbuffers;
@@ -219,64 +220,117 @@ void gbfs_edges(appender_fun const& appender, SearchDir const dir,
   }
 }
 
+void make_mode_edges(ModeWrapper const* wrapper, latlng const& pos,
+                     SearchDir const search_dir, appender_fun const& appender,
+                     mumo_stats_appender_fun const& mumo_stats_appender,
+                     std::string const& mumo_stats_prefix,
+                     ppr_profiles const& profiles) {
+  switch (wrapper->mode_type()) {
+    case Mode_Foot: {
+      auto max_dur =
+          reinterpret_cast<Foot const*>(wrapper->mode())->max_duration();
+      auto max_dist = max_dur * WALK_SPEED;
+      osrm_edges(pos, max_dur, max_dist, mumo_type::FOOT, search_dir, appender);
+      break;
+    }
+
+    case Mode_Bike: {
+      auto max_dur =
+          reinterpret_cast<Bike const*>(wrapper->mode())->max_duration();
+      auto max_dist = max_dur * BIKE_SPEED;
+      osrm_edges(pos, max_dur, max_dist, mumo_type::BIKE, search_dir, appender);
+      break;
+    }
+
+    case Mode_Car: {
+      auto max_dur =
+          reinterpret_cast<Car const*>(wrapper->mode())->max_duration();
+      auto max_dist = max_dur * CAR_SPEED;
+      osrm_edges(pos, max_dur, max_dist, mumo_type::CAR, search_dir, appender);
+      break;
+    }
+
+    case Mode_FootPPR: {
+      auto const options =
+          reinterpret_cast<FootPPR const*>(wrapper->mode())->search_options();
+      ppr_edges(pos, options, search_dir, appender, profiles);
+      break;
+    }
+
+    case Mode_CarParking: {
+      auto const cp = reinterpret_cast<CarParking const*>(wrapper->mode());
+      car_parking_edges(pos, cp->max_car_duration(), cp->ppr_search_options(),
+                        search_dir, appender, mumo_stats_appender,
+                        mumo_stats_prefix);
+      break;
+    }
+
+    case Mode_GBFS: {
+      auto const gbfs = reinterpret_cast<GBFS const*>(wrapper->mode());
+      gbfs_edges(appender, search_dir, pos, gbfs->provider()->str(),
+                 gbfs->max_walk_duration() / 60.0,
+                 gbfs->max_ride_duration() / 60.0);
+      break;
+    }
+
+    default: throw std::system_error(error::unknown_mode);
+  }
+}
+
+mumo_edge_cache::entry_ptr compute_cache_entry(
+    ModeWrapper const* wrapper, latlng const& pos, SearchDir const search_dir,
+    std::string const& mumo_stats_prefix, ppr_profiles const& profiles) {
+  auto e = std::make_shared<mumo_edge_cache::entry>();
+  make_mode_edges(
+      wrapper, pos, search_dir,
+      [&](std::string const& station_id, latlng const& station_pos,
+          duration const dur, uint16_t const accessibility,
+          mumo_type const type, int const id) -> mumo_edge& {
+        return e->edges_.emplace_back(std::string{}, station_id, latlng{},
+                                      station_pos, dur, accessibility, type,
+                                      id);
+      },
+      [&](stats_category&& s) { e->stats_.emplace_back(std::move(s)); },
+      mumo_stats_prefix, profiles);
+  return e;
+}
+
 void make_edges(Vector<Offset<ModeWrapper>> const* modes, latlng const& pos,
                 SearchDir const search_dir, appender_fun const& appender,
                 mumo_stats_appender_fun const& mumo_stats_appender,
                 std::string const& mumo_stats_prefix,
-                ppr_profiles const& profiles) {
+                ppr_profiles const& profiles, mumo_edge_cache* cache,
+                mumo_edge_cache_usage& cache_usage) {
   for (auto const& wrapper : *modes) {
-    switch (wrapper->mode_type()) {
-      case Mode_Foot: {
-        auto max_dur =
-            reinterpret_cast<Foot const*>(wrapper->mode())->max_duration();
-        auto max_dist = max_dur * WALK_SPEED;
-        osrm_edges(pos, max_dur, max_dist, mumo_type::FOOT, search_dir,
-                   appender);
-        break;
-      }
-
-      case Mode_Bike: {
-        auto max_dur =
-            reinterpret_cast<Bike const*>(wrapper->mode())->max_duration();
-        auto max_dist = max_dur * BIKE_SPEED;
-        osrm_edges(pos, max_dur, max_dist, mumo_type::BIKE, search_dir,
-                   appender);
-        break;
-      }
-
-      case Mode_Car: {
-        auto max_dur =
-            reinterpret_cast<Car const*>(wrapper->mode())->max_duration();
-        auto max_dist = max_dur * CAR_SPEED;
-        osrm_edges(pos, max_dur, max_dist, mumo_type::CAR, search_dir,
-                   appender);
-        break;
-      }
-
-      case Mode_FootPPR: {
-        auto const options =
-            reinterpret_cast<FootPPR const*>(wrapper->mode())->search_options();
-        ppr_edges(pos, options, search_dir, appender, profiles);
-        break;
-      }
-
-      case Mode_CarParking: {
-        auto const cp = reinterpret_cast<CarParking const*>(wrapper->mode());
-        car_parking_edges(pos, cp->max_car_duration(), cp->ppr_search_options(),
-                          search_dir, appender, mumo_stats_appender,
-                          mumo_stats_prefix);
-        break;
-      }
+    auto const key = cache == nullptr ? std::optional<std::string>{}
+                                      : cache->key(wrapper, pos, search_dir);
+    if (!key.has_value()) {
+      make_mode_edges(wrapper, pos, search_dir, appender, mumo_stats_appender,
+                      mumo_stats_prefix, profiles);
+      continue;
+    }
 
-      case Mode_GBFS: {
-        auto const gbfs = reinterpret_cast<GBFS const*>(wrapper->mode());
-        gbfs_edges(appender, search_dir, pos, gbfs->provider()->str(),
-                   gbfs->max_walk_duration() / 60.0,
-                   gbfs->max_ride_duration() / 60.0);
-        break;
-      }
+    auto cached = cache->get(*key);
+    auto stats = std::vector<stats_category>{};
+    if (cached != nullptr) {
+      ++cache_usage.hits_;
+      stats = cache_hit_stats(*cached);
+    } else {
+      ++cache_usage.misses_;
+      cached = compute_cache_entry(wrapper, pos, search_dir, mumo_stats_prefix,
+                                   profiles);
+      cache->put(*key, wrapper->mode_type(), cached);
+      stats = cached->stats_;
+    }
 
-      default: throw std::system_error(error::unknown_mode);
+    for (auto const& c : cached->edges_) {
+      auto& e = appender(c.to_, c.to_pos_, c.duration_, c.accessibility_,
+                         c.type_, c.id_);
+      e.car_parking_ = c.car_parking_;
+      e.gbfs_ = c.gbfs_;
+    }
+    for (auto& s : stats) {
+      mumo_stats_appender(std::move(s));
     }
   }
 }
@@ -284,17 +338,21 @@ void make_edges(Vector<Offset<ModeWrapper>> const* modes, latlng const& pos,
 void make_starts(IntermodalRoutingRequest const* req, latlng const& pos,
                  appender_fun const& appender,
                  mumo_stats_appender_fun const& mumo_stats_appender,
-                 ppr_profiles const& profiles) {
+                 ppr_profiles const& profiles, mumo_edge_cache* cache,
+                 mumo_edge_cache_usage& cache_usage) {
   make_edges(req->start_modes(), pos, SearchDir_Forward, appender,
-             mumo_stats_appender, "intermodal.start.", profiles);
+             mumo_stats_appender, "intermodal.start.", profiles, cache,
+             cache_usage);
 }
 
 void make_dests(IntermodalRoutingRequest const* req, latlng const& pos,
                 appender_fun const& appender,
                 mumo_stats_appender_fun const& mumo_stats_appender,
-                ppr_profiles const& profiles) {
+                ppr_profiles const& profiles, mumo_edge_cache* cache,
+                mumo_edge_cache_usage& cache_usage) {
   make_edges(req->destination_modes(), pos, SearchDir_Backward, appender,
-             mumo_stats_appender, "intermodal.dest.", profiles);
+             mumo_stats_appender, "intermodal.dest.", profiles, cache,
+             cache_usage);
 }
 
 void remove_intersection(std::vector<mumo_edge>& starts,
@@ -0,0 +1,129 @@
+#include "motis/intermodal/mumo_edge_cache.h"
+
+#include <cmath>
+
+#include "fmt/format.h"
+
+namespace motis::intermodal {
+
+mumo_edge_cache::mumo_edge_cache(std::size_t const max_entries,
+                                 unsigned const precision,
+                                 clock::duration const ttl,
+                                 clock::duration const gbfs_ttl)
+    : max_entries_{max_entries},
+      precision_{precision},
+      ttl_{ttl},
+      gbfs_ttl_{gbfs_ttl} {}
+
+mumo_edge_cache::entry_ptr mumo_edge_cache::get(std::string const& key) {
+  std::lock_guard const lock{mutex_};
+  auto const it = entries_.find(key);
+  if (it == end(entries_)) {
+    return nullptr;
+  }
+
+  if (it->second.expires_ < clock::now()) {
+    lru_.erase(it->second.lru_it_);
+    entries_.erase(it);
+    return nullptr;
+  }
+
+  lru_.splice(begin(lru_), lru_, it->second.lru_it_);
+  return it->second.entry_;
+}
+
+void mumo_edge_cache::put(std::string const& key, Mode const mode,
+                          entry_ptr e) {
+  auto const ttl = mode == Mode_GBFS ? gbfs_ttl_ : ttl_;
+  if (max_entries_ == 0U || ttl <= clock::duration::zero()) {
+    return;
+  }
+
+  std::lock_guard const lock{mutex_};
+  auto const expires = clock::now() + ttl;
+  if (auto const it = entries_.find(key); it != end(entries_)) {
+    it->second.entry_ = std::move(e);
+    it->second.expires_ = expires;
+    lru_.splice(begin(lru_), lru_, it->second.lru_it_);
+    return;
+  }
+
+  lru_.push_front(key);
+  entries_.emplace(key, cached{std::move(e), expires, begin(lru_)});
+  while (entries_.size() > max_entries_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+void mumo_edge_cache::clear() {
+  std::lock_guard const lock{mutex_};
+  entries_.clear();
+  lru_.clear();
+}
+
+std::optional<std::string> mumo_edge_cache::key(ModeWrapper const* wrapper,
+                                                geo::latlng const& pos,
+                                                SearchDir const dir) const {
+  if (max_entries_ == 0U ||
+      (wrapper->mode_type() == Mode_GBFS ? gbfs_ttl_ : ttl_) <=
+          clock::duration::zero()) {
+    return std::nullopt;
+  }
+
+  auto const scale = std::pow(10.0, precision_);
+  auto const cell = fmt::format("{}|{}|{}|{}",
+                                static_cast<int>(wrapper->mode_type()),
+                                static_cast<int>(dir),
+                                std::llround(pos.lat_ * scale),
+                                std::llround(pos.lng_ * scale));
+
+  auto const ppr_key = [](ppr::SearchOptions const* o) {
+    return fmt::format("{}|{}", o->profile()->str(), o->duration_limit());
+  };
+
+  switch (wrapper->mode_type()) {
+    case Mode_Foot:
+      return fmt::format(
+          "{}|{}", cell,
+          reinterpret_cast<Foot const*>(wrapper->mode())->max_duration());
+    case Mode_Bike:
+      return fmt::format(
+          "{}|{}", cell,
+          reinterpret_cast<Bike const*>(wrapper->mode())->max_duration());
+    case Mode_Car:
+      return fmt::format(
+          "{}|{}", cell,
+          reinterpret_cast<Car const*>(wrapper->mode())->max_duration());
+    case Mode_FootPPR:
+      return fmt::format(
+          "{}|{}", cell,
+          ppr_key(reinterpret_cast<FootPPR const*>(wrapper->mode())
+                      ->search_options()));
+    case Mode_CarParking: {
+      auto const cp = reinterpret_cast<CarParking const*>(wrapper->mode());
+      return fmt::format("{}|{}|{}", cell, cp->max_car_duration(),
+                         ppr_key(cp->ppr_search_options()));
+    }
+    case Mode_GBFS: {
+      auto const gbfs = reinterpret_cast<GBFS const*>(wrapper->mode());
+      return fmt::format("{}|{}|{}|{}", cell, gbfs->provider()->str(),
+                         gbfs->max_walk_duration(), gbfs->max_ride_duration());
+    }
+    default: return std::nullopt;
+  }
+}
+
+std::vector<stats_category> cache_hit_stats(
+    mumo_edge_cache::entry const& e) {
+  auto stats = e.stats_;
+  for (auto& category : stats) {
+    for (auto& entry : category.entries_) {
+      entry.value_ = 0U;
+    }
+    category.entries_.emplace_back("edge_cache_hit", 1U);
+  }
+  return stats;
+}
+
+}  // namespace motis::intermodal
@@ -0,0 +1,68 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "motis/intermodal/mumo_edge_cache.h"
+
+using namespace motis::intermodal;
+
+namespace {
+
+mumo_edge_cache::entry_ptr make_entry(std::string const& station) {
+  auto e = std::make_shared<mumo_edge_cache::entry>();
+  e->edges_.emplace_back("", station, geo::latlng{}, geo::latlng{}, 10, 0,
+                         mumo_type::FOOT, 0);
+  return e;
+}
+
+}  // namespace
+
+TEST(intermodal_mumo_edge_cache, lru_eviction) {
+  mumo_edge_cache cache{2U, 4U, std::chrono::hours{1}, std::chrono::hours{1}};
+  cache.put("a", Mode_Foot, make_entry("A"));
+  cache.put("b", Mode_Foot, make_entry("B"));
+  ASSERT_NE(nullptr, cache.get("a"));  // a is now most recently used
+  cache.put("c", Mode_Foot, make_entry("C"));
+
+  ASSERT_NE(nullptr, cache.get("a"));
+  EXPECT_EQ("A", cache.get("a")->edges_.front().to_);
+  EXPECT_EQ(nullptr, cache.get("b"));
+  EXPECT_NE(nullptr, cache.get("c"));
+
+  cache.clear();
+  EXPECT_EQ(nullptr, cache.get("a"));
+}
+
+TEST(intermodal_mumo_edge_cache, ttl) {
+  mumo_edge_cache cache{10U, 4U, std::chrono::hours{1},
+                        std::chrono::seconds{0}};
+  cache.put("foot", Mode_Foot, make_entry("A"));
+  cache.put("gbfs", Mode_GBFS, make_entry("B"));
+  EXPECT_NE(nullptr, cache.get("foot"));
+  EXPECT_EQ(nullptr, cache.get("gbfs"));
+
+  mumo_edge_cache expired{10U, 4U, std::chrono::nanoseconds{1},
+                          std::chrono::nanoseconds{1}};
+  expired.put("foot", Mode_Foot, make_entry("A"));
+  std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  EXPECT_EQ(nullptr, expired.get("foot"));
+}
+
+TEST(intermodal_mumo_edge_cache, hit_stats) {
+  auto e = mumo_edge_cache::entry{};
+  e.stats_.emplace_back(
+      "intermodal.start.ppr",
+      std::vector<motis::stats_entry>{{"total_time", 12U}, {"routes", 3U}});
+
+  auto const stats = cache_hit_stats(e);
+  ASSERT_EQ(1U, stats.size());
+  EXPECT_EQ("intermodal.start.ppr", stats[0].key_);
+  ASSERT_EQ(3U, stats[0].entries_.size());
+  EXPECT_EQ(0U, stats[0].entries_[0].value_);
+  EXPECT_EQ(0U, stats[0].entries_[1].value_);
+  EXPECT_EQ("edge_cache_hit", stats[0].entries_[2].key_);
+  EXPECT_EQ(1U, stats[0].entries_[2].value_);
+
+  // the cached statistics stay unchanged for the next miss report
+  EXPECT_EQ(12U, e.stats_[0].entries_[0].value_);
+}
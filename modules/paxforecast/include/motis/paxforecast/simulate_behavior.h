@@ -41,7 +41,7 @@ inline void add_group_to_alternative(schedule const& sched,
                                      motis::paxmon::passenger_group const& grp,
                                      alternative const& alt,
                                      float const probability) {
-  auto const total_probability = grp.probability_ * probability;
+  auto const total_probability = grp.probability() * probability;
   for_each_edge(
       sched, caps, uv, alt.compact_journey_,
       [&](motis::paxmon::journey_leg const&, motis::paxmon::edge const* e) {
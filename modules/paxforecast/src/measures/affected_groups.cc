@@ -47,7 +47,8 @@ void add_affected_groups(schedule const& sched, universe& uv,
                          CheckFn const& check_fn) {
   // TODO(pablo): performance optimizations - currently localizing every group
   for (auto const* pg : uv.passenger_groups_) {
-    if (pg == nullptr || !pg->valid() || pg->probability_ == 0.0F) {
+    if (pg == nullptr || !uv.passenger_groups_.valid(pg->id_) ||
+        pg->probability() == 0.0F) {
       continue;
     }
     auto const loc = localize(sched, uv, result, pg, loc_time);
@@ -244,11 +244,11 @@ void update_tracked_groups(
 
       groups_to_add.emplace_back(to_fbs(
           sched, add_groups_mc,
-          make_passenger_group(std::move(new_journey), pg->source_,
-                               pg->passengers_, pg->planned_arrival_time_,
-                               pg->source_flags_ | group_source_flags::FORECAST,
-                               prob, system_time, pg->id_,
-                               pg->generation_ + 1)));
+          make_passenger_group(
+              std::move(new_journey), pg->source_, pg->passengers(),
+              pg->planned_arrival_time(),
+              pg->source_flags() | group_source_flags::FORECAST, prob,
+              system_time, pg->id_, pg->generation_ + 1)));
       ++add_group_count;
     }
 
@@ -338,13 +338,13 @@ void paxforecast::on_monitoring_event(msg_ptr const& msg) {
     if (cpg == end(destination_groups)) {
       destination_groups.emplace_back(
           combined_passenger_group{destination_station_id,
-                                   pg->passengers_,
+                                   pg->passengers(),
                                    major_delay,
                                    localization,
                                    {pg},
                                    {}});
     } else {
-      cpg->passengers_ += pg->passengers_;
+      cpg->passengers_ += pg->passengers();
       cpg->groups_.push_back(pg);
       if (major_delay) {
         cpg->has_major_delay_groups_ = true;
@@ -677,7 +677,7 @@ msg_ptr paxforecast::apply_measures(msg_ptr const& msg) {
       }
       auto& cpg = combined[{loc, remaining_planned_journey}];
       cpg.groups_.emplace_back(pg);
-      cpg.passengers_ += pg->passengers_;
+      cpg.passengers_ += pg->passengers();
       cpg.localization_ = loc;
     }
 
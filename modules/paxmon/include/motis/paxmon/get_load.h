@@ -14,34 +14,14 @@
 #include "utl/enumerate.h"
 #include "utl/verify.h"
 
-#include "cista/reflection/comparable.h"
-
 #include "motis/paxmon/passenger_group.h"
 #include "motis/paxmon/passenger_group_container.h"
+#include "motis/paxmon/pax_distribution.h"
 #include "motis/paxmon/pci_container.h"
 #include "motis/paxmon/universe.h"
 
 namespace motis::paxmon {
 
-struct pax_limits {
-  CISTA_COMPARABLE()
-
-  std::uint16_t min_{};
-  std::uint16_t max_{};
-};
-
-struct pax_pdf {
-  CISTA_COMPARABLE()
-
-  std::vector<float> data_;
-};
-
-struct pax_cdf {
-  CISTA_COMPARABLE()
-
-  std::vector<float> data_;
-};
-
 struct pax_stats {
   pax_limits limits_{};
   std::uint16_t q5_{};
@@ -54,14 +34,15 @@ using lf_df_t = std::map<float, float>;
 template <typename Groups>
 inline pax_limits get_pax_limits(passenger_group_container const& pgc,
                                  Groups const& groups) {
+  auto const& cols = pgc.columns_;
   auto limits = pax_limits{};
   for (auto const grp_id : groups) {
-    auto const* grp = pgc[grp_id];
-    auto const pax = grp->passengers_;
-    if (grp->probability_ == 1.0F) {
+    auto const pax = cols.passengers_[grp_id];
+    auto const probability = cols.probability_[grp_id];
+    if (probability == 1.0F) {
       limits.min_ += pax;
     }
-    if (grp->probability_ != 0.0F) {
+    if (probability != 0.0F) {
       limits.max_ += pax;
     }
   }
@@ -71,11 +52,11 @@ inline pax_limits get_pax_limits(passenger_group_container const& pgc,
 template <typename Groups>
 inline std::uint16_t get_base_load(passenger_group_container const& pgc,
                                    Groups const& groups) {
+  auto const& cols = pgc.columns_;
   std::uint16_t load = 0;
   for (auto const grp_id : groups) {
-    auto const* grp = pgc[grp_id];
-    if (grp->probability_ == 1.0F) {
-      load += grp->passengers_;
+    if (cols.probability_[grp_id] == 1.0F) {
+      load += cols.passengers_[grp_id];
     }
   }
   return load;
@@ -108,10 +89,11 @@ inline pax_pdf get_load_pdf_base(passenger_group_container const& pgc,
   auto pdf = pax_pdf{};
   pdf.data_.resize(limits.max_ + 1);
   pdf.data_[limits.min_] = 1.0F;
+  auto const& cols = pgc.columns_;
   for (auto const grp_id : groups) {
-    auto const* grp = pgc[grp_id];
-    if (grp->probability_ != 1.0F && grp->probability_ != 0.0F) {
-      convolve_base(pdf, grp->passengers_, grp->probability_);
+    auto const probability = cols.probability_[grp_id];
+    if (probability != 1.0F && probability != 0.0F) {
+      convolve_base(pdf, cols.passengers_[grp_id], probability);
     }
   }
   return pdf;
@@ -171,10 +153,11 @@ inline pax_pdf get_load_pdf_avx(passenger_group_container const& pgc,
   pdf.data_[limits.min_] = 1.0F;
   auto buf = std::vector<float>(pdf.data_.size() + 8);
 
+  auto const& cols = pgc.columns_;
   for (auto const grp_id : groups) {
-    auto const* grp = pgc[grp_id];
-    if (grp->probability_ != 1.0F && grp->probability_ != 0.0F) {
-      convolve_avx(pdf, grp->passengers_, grp->probability_, limits, buf);
+    auto const probability = cols.probability_[grp_id];
+    if (probability != 1.0F && probability != 0.0F) {
+      convolve_avx(pdf, cols.passengers_[grp_id], probability, limits, buf);
     }
   }
 
@@ -208,14 +191,22 @@ inline std::uint16_t get_mean_load(passenger_group_container const& pgc,
   if (groups.empty()) {
     return 0;
   }
+  auto const& cols = pgc.columns_;
   auto mean = 0.0F;
   for (auto const grp_id : groups) {
-    auto const* grp = pgc[grp_id];
-    mean += static_cast<float>(grp->passengers_) * grp->probability_;
+    mean += static_cast<float>(cols.passengers_[grp_id]) *
+            cols.probability_[grp_id];
   }
   return static_cast<std::uint16_t>(mean);
 }
 
+pci_load_summary get_load_summary(pax_cdf const& cdf, pax_limits const& limits);
+
+// Load summary of a pci. Cached in the pci_container until the groups on the
+// pci change (see pci_container::invalidate_load). The reference stays valid
+// as long as the pci_container is not modified.
+pci_load_summary const& get_load_summary(universe const& uv, pci_index idx);
+
 std::uint16_t get_pax_quantile(pax_cdf const& cdf, float q);
 std::uint16_t get_median_load(pax_cdf const& cdf);
 pax_stats get_pax_stats(pax_cdf const& cdf);
@@ -231,6 +222,8 @@ bool load_factor_possibly_ge(pax_pdf const& pdf, std::uint16_t capacity,
                              float threshold);
 bool load_factor_possibly_ge(pax_cdf const& cdf, std::uint16_t capacity,
                              float threshold);
+bool load_factor_possibly_ge(pci_load_summary const& summary,
+                             std::uint16_t capacity, float threshold);
 bool load_factor_possibly_ge(lf_df_t const& lf_df, float threshold);
 
 inline float get_pax_le_probability(pax_cdf const& cdf, std::uint16_t limit) {
@@ -29,9 +29,12 @@ trip_data_index get_or_add_trip(schedule const& sched,
 
 trip_data_index get_trip(universe const& uv, trip_idx_t trip_idx);
 
+// Only touches the nodes of the updated trip, counters are added to stats
+// (may be called concurrently for different trips).
 void update_event_times(schedule const& sched, universe& uv,
                         motis::rt::RtDelayUpdate const* du,
-                        std::vector<edge_index>& updated_interchange_edges);
+                        std::vector<edge_index>& updated_interchange_edges,
+                        system_statistics& stats);
 
 void update_trip_route(schedule const& sched, capacity_maps const& caps,
                        universe& uv, motis::rt::RtRerouteUpdate const* ru,
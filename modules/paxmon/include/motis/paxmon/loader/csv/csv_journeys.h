@@ -2,6 +2,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
+
+#include "cista/reflection/comparable.h"
 
 #include "motis/core/schedule/schedule.h"
 #include "motis/core/journey/journey.h"
@@ -11,9 +14,33 @@
 
 namespace motis::paxmon::loader::csv {
 
+struct csv_journey_options {
+  // Candidate trips are looked up in a per-station departure index.
+  // Otherwise, all route edges of the departure station are scanned.
+  bool use_departure_index_{true};
+
+  // Rows are parsed and matched in chunks of about this size (in parallel),
+  // then merged into journeys in file order.
+  std::size_t chunk_size_{std::size_t{8U} * 1024U * 1024U};
+};
+
+struct csv_journey_stats {
+  CISTA_COMPARABLE()
+
+  std::size_t journeys_with_invalid_legs_{};
+  std::size_t journeys_with_no_valid_legs_{};
+  std::size_t journeys_with_inexact_matches_{};
+  std::size_t journeys_with_missing_trips_{};
+  std::size_t journeys_with_missing_transfers_{};
+  std::size_t journeys_with_invalid_transfer_times_{};
+  std::size_t journeys_too_long_{};
+};
+
 loader_result load_journeys(schedule const& sched, universe& uv,
                             std::string const& journey_file,
                             std::string const& match_log_file,
-                            duration match_tolerance);
+                            duration match_tolerance,
+                            csv_journey_options const& opt = {},
+                            csv_journey_stats* stats = nullptr);
 
 }  // namespace motis::paxmon::loader::csv
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "motis/core/schedule/time.h"
 
@@ -16,4 +18,11 @@ struct unmatched_journey {
   std::uint16_t passengers_{};
 };
 
+// Groups unmatched journeys that result in the same reroute query (same
+// start, destination and departure time). Returns one entry per distinct
+// query with the indices of its journeys in input order; queries are sorted
+// by (start, destination, departure time).
+std::vector<std::vector<std::size_t>> group_identical_queries(
+    std::vector<unmatched_journey> const& unmatched_journeys);
+
 }  // namespace motis::paxmon::loader
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <optional>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "cista/reflection/comparable.h"
@@ -60,8 +61,40 @@ inline constexpr group_source_flags operator&=(group_source_flags& a,
   return a;
 }
 
+struct passenger_group_columns;
+struct passenger_group_container;
+
 struct passenger_group {
-  inline bool valid() const { return !edges_.empty(); }
+  passenger_group() = default;
+
+  passenger_group(compact_journey&& cj, passenger_group_index const id,
+                  data_source const source, std::uint16_t const passengers,
+                  motis::time const planned_arrival_time,
+                  group_source_flags const source_flags, bool const ok,
+                  motis::time const added_time, float const probability,
+                  std::int16_t const estimated_delay,
+                  std::uint8_t const generation,
+                  std::uint64_t const previous_version)
+      : compact_planned_journey_{std::move(cj)},
+        id_{id},
+        source_{source},
+        ok_{ok},
+        added_time_{added_time},
+        generation_{generation},
+        previous_version_{previous_version},
+        passengers_{passengers},
+        planned_arrival_time_{planned_arrival_time},
+        source_flags_{source_flags},
+        probability_{probability},
+        estimated_delay_{estimated_delay} {}
+
+  inline std::uint16_t passengers() const { return passengers_; }
+  inline float probability() const { return probability_; }
+  inline group_source_flags source_flags() const { return source_flags_; }
+
+  inline motis::time planned_arrival_time() const {
+    return planned_arrival_time_;
+  }
 
   inline std::uint16_t estimated_delay() const { return estimated_delay_; }
 
@@ -75,16 +108,22 @@ struct passenger_group {
   compact_journey compact_planned_journey_;
   passenger_group_index id_{};
   data_source source_{};
+  bool ok_{true};
+  motis::time added_time_{INVALID_TIME};
+  std::uint8_t generation_{};
+  std::uint64_t previous_version_{};
+
+private:
+  // Also stored in passenger_group_container::columns_ once the group is
+  // added to a container, only the container may modify them.
+  friend passenger_group_columns;
+  friend passenger_group_container;
+
   std::uint16_t passengers_{1};
   motis::time planned_arrival_time_{INVALID_TIME};
   group_source_flags source_flags_{group_source_flags::NONE};
-  bool ok_{true};
-  motis::time added_time_{INVALID_TIME};
   float probability_{1.0F};
   std::int16_t estimated_delay_{};
-  std::uint8_t generation_{};
-  std::uint64_t previous_version_{};
-  std::vector<edge_index> edges_{};
 };
 
 inline passenger_group make_passenger_group(
@@ -106,14 +145,13 @@ inline passenger_group make_passenger_group(
                          probability,
                          estimated_delay,
                          generation,
-                         previous_version.value_or(id),
-                         {}};
+                         previous_version.value_or(id)};
 }
 
 inline bool is_planned_group(passenger_group const* grp) {
-  return ((grp->source_flags_ & group_source_flags::FORECAST) !=
+  return ((grp->source_flags() & group_source_flags::FORECAST) !=
           group_source_flags::FORECAST) &&
-         grp->probability_ == 1.0F;
+         grp->probability() == 1.0F;
 }
 
 }  // namespace motis::paxmon
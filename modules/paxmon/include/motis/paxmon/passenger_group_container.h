@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "utl/erase.h"
@@ -10,13 +13,76 @@
 #include "motis/hash_map.h"
 #include "motis/vector.h"
 
+#include "motis/core/common/dynamic_fws_multimap.h"
+
 #include "motis/paxmon/allocator.h"
+#include "motis/paxmon/graph_index.h"
 #include "motis/paxmon/passenger_group.h"
 
 namespace motis::paxmon {
 
+using group_edges = dynamic_fws_multimap<edge_index>::const_bucket;
+
+// Frequently scanned group fields, one array per field (indexed by
+// passenger_group_index). Used by load calculations and group filters to
+// avoid loading the (heap allocated) passenger_group objects.
+struct passenger_group_columns {
+  void add(passenger_group const& pg) {
+    passengers_.emplace_back(pg.passengers());
+    probability_.emplace_back(pg.probability());
+    source_flags_.emplace_back(pg.source_flags());
+    planned_arrival_time_.emplace_back(pg.planned_arrival_time());
+    estimated_delay_.emplace_back(pg.estimated_delay_);
+    valid_.emplace_back(false);
+  }
+
+  void add_empty() {
+    passengers_.emplace_back(0U);
+    probability_.emplace_back(0.0F);
+    source_flags_.emplace_back(group_source_flags::NONE);
+    planned_arrival_time_.emplace_back(INVALID_TIME);
+    estimated_delay_.emplace_back(0);
+    valid_.emplace_back(false);
+  }
+
+  void reserve(std::size_t const size) {
+    passengers_.reserve(size);
+    probability_.reserve(size);
+    source_flags_.reserve(size);
+    planned_arrival_time_.reserve(size);
+    estimated_delay_.reserve(size);
+    valid_.reserve(size);
+  }
+
+  inline motis::time estimated_arrival_time(
+      passenger_group_index const idx) const {
+    return planned_arrival_time_[idx] != INVALID_TIME
+               ? static_cast<motis::time>(planned_arrival_time_[idx] +
+                                          estimated_delay_[idx])
+               : INVALID_TIME;
+  }
+
+  std::size_t allocated_size() const {
+    return passengers_.capacity() * sizeof(std::uint16_t) +
+           probability_.capacity() * sizeof(float) +
+           source_flags_.capacity() * sizeof(group_source_flags) +
+           planned_arrival_time_.capacity() * sizeof(motis::time) +
+           estimated_delay_.capacity() * sizeof(std::int16_t) +
+           valid_.capacity() * sizeof(std::uint8_t);
+  }
+
+  std::vector<std::uint16_t> passengers_;
+  std::vector<float> probability_;
+  std::vector<group_source_flags> source_flags_;
+  std::vector<motis::time> planned_arrival_time_;
+  std::vector<std::int16_t> estimated_delay_;
+  // group is currently part of the graph (has edges)
+  std::vector<std::uint8_t> valid_;
+};
+
 struct passenger_group_container {
   using group_pointer = typename allocator<passenger_group>::pointer;
+  using edge_pool = dynamic_fws_multimap<edge_index>;
 
   template <bool Const>
   struct group_iterator {
@@ -144,11 +210,20 @@ struct passenger_group_container {
     auto [g_ptr, m_ptr] = allocator_.create(std::move(pg));
     groups_.emplace_back(g_ptr);
     m_ptr->id_ = id;
+    columns_.add(*m_ptr);
+    edges_.emplace_back();
     groups_by_source_[m_ptr->source_].emplace_back(id);
     ++active_groups_;
     return m_ptr;
   }
 
+  // Adds an unused index (used when restoring a universe snapshot).
+  inline void add_released() {
+    groups_.emplace_back();
+    columns_.add_empty();
+    edges_.emplace_back();
+  }
+
   inline void release(passenger_group_index const id) {
     auto const ptr = groups_.at(id);
     if (ptr) {
@@ -156,10 +231,68 @@ struct passenger_group_container {
       utl::erase(groups_by_source_[m_ptr->source_], id);
       allocator_.release(ptr);
       groups_[id] = {};
+      columns_.passengers_[id] = 0U;
+      columns_.probability_[id] = 0.0F;
+      clear_edges(id);
       --active_groups_;
     }
   }
 
+  // Fields that are also stored in columns_ must be updated using these.
+  void set_probability(passenger_group* pg, float const probability) {
+    pg->probability_ = probability;
+    columns_.probability_[pg->id_] = probability;
+  }
+
+  void set_estimated_delay(passenger_group* pg,
+                           std::int16_t const estimated_delay) {
+    pg->estimated_delay_ = estimated_delay;
+    columns_.estimated_delay_[pg->id_] = estimated_delay;
+  }
+
+  // Edges of a group are stored in a shared pool (edges_). Modifications
+  // keep columns_.valid_ in sync. The pool is reallocated on growth: edges
+  // may be read in parallel, but not modified.
+  group_edges edges(passenger_group_index const id) const {
+    return edges_[static_cast<edge_pool::size_type>(id)];
+  }
+
+  void add_edge(passenger_group_index const id, edge_index const& ei) {
+    edges_[static_cast<edge_pool::size_type>(id)].emplace_back(ei);
+    columns_.valid_[id] = true;
+  }
+
+  void remove_edge(passenger_group_index const id, edge_index const& ei) {
+    auto bucket = edges_[static_cast<edge_pool::size_type>(id)];
+    bucket.erase(std::remove(begin(bucket), end(bucket), ei), end(bucket));
+    columns_.valid_[id] = !bucket.empty();
+  }
+
+  void clear_edges(passenger_group_index const id) {
+    edges_[static_cast<edge_pool::size_type>(id)].clear();
+    columns_.valid_[id] = false;
+  }
+
+  template <typename Edges>
+  void set_edges(passenger_group_index const id, Edges const& edges) {
+    auto bucket = edges_[static_cast<edge_pool::size_type>(id)];
+    bucket.clear();
+    bucket.reserve(static_cast<edge_pool::size_type>(edges.size()));
+    for (auto const& ei : edges) {
+      bucket.emplace_back(ei);
+    }
+    columns_.valid_[id] = !bucket.empty();
+  }
+
+  bool valid(passenger_group_index const id) const {
+    return columns_.valid_[id] != 0U;
+  }
+
+  // Group exists (has not been released).
+  bool exists(passenger_group_index const id) const {
+    return static_cast<bool>(groups_[id]);
+  }
+
   passenger_group* operator[](passenger_group_index const index) {
     auto const ptr = groups_[index];
     return ptr ? allocator_.get(ptr) : nullptr;
@@ -199,10 +332,20 @@ struct passenger_group_container {
   std::size_t size() const { return groups_.size(); }
   std::size_t active_groups() const { return active_groups_; }
 
-  void reserve(std::size_t size) { groups_.reserve(size); }
+  void reserve(std::size_t size) {
+    groups_.reserve(size);
+    columns_.reserve(size);
+  }
+
+  std::size_t allocated_size() const {
+    return groups_.capacity() * sizeof(group_pointer) +
+           columns_.allocated_size() + edges_.allocated_size();
+  }
 
   allocator<passenger_group> allocator_;
   std::vector<group_pointer> groups_;
+  passenger_group_columns columns_;
+  edge_pool edges_;
   mcd::hash_map<data_source, mcd::vector<passenger_group_index>>
       groups_by_source_;
   std::size_t active_groups_{};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "cista/reflection/comparable.h"
+
+namespace motis::paxmon {
+
+struct pax_limits {
+  CISTA_COMPARABLE()
+
+  std::uint16_t min_{};
+  std::uint16_t max_{};
+};
+
+struct pax_pdf {
+  CISTA_COMPARABLE()
+
+  std::vector<float> data_;
+};
+
+struct pax_cdf {
+  CISTA_COMPARABLE()
+
+  std::vector<float> data_;
+};
+
+}  // namespace motis::paxmon
@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include "cista/hash.h"
+
 #include "conf/date_time.h"
 
 #include "motis/module/module.h"
@@ -36,6 +38,7 @@ struct paxmon : public motis::module::module {
 
 private:
   void load_journeys();
+  cista::hash_t universe_snapshot_input_hash() const;
   loader::loader_result load_journeys(std::string const& file);
   void load_capacity_files();
   motis::module::msg_ptr rt_update(motis::module::msg_ptr const& msg);
@@ -59,6 +62,7 @@ private:
   int time_step_{60};
   std::uint16_t match_tolerance_{0};
   bool reroute_unmatched_{false};
+  unsigned initial_reroute_max_parallel_{1000};
   int arrival_delay_threshold_{20};
   int preparation_time_{15};
   bool check_graph_times_{false};
@@ -68,6 +72,7 @@ private:
   bool mcfp_scenario_include_trip_info_{false};
   bool keep_group_history_{false};
   bool reuse_groups_{true};
+  bool universe_snapshot_{false};
 
   paxmon_data data_;
   std::unique_ptr<stats_writer> stats_writer_;
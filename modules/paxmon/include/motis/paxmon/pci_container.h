@@ -1,7 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <deque>
 #include <mutex>
+#include <vector>
+
+#include "cista/reflection/comparable.h"
 
 #include "utl/verify.h"
 
@@ -11,6 +17,7 @@
 #include "motis/core/common/dynamic_fws_multimap.h"
 
 #include "motis/paxmon/passenger_group.h"
+#include "motis/paxmon/pax_distribution.h"
 
 namespace motis::paxmon {
 
@@ -20,21 +27,41 @@ using pci_groups = dynamic_fws_multimap<passenger_group_index>::const_bucket;
 using mutable_pci_groups =
     dynamic_fws_multimap<passenger_group_index>::mutable_bucket;
 
+// Compact load summary of the groups of one pci, see get_load_summary().
+// cdf_ge_95_ / cdf_gt_95_ are the smallest loads with cdf >= 0.95 / > 0.95
+// (limits_.max_ + 1 if there is none), which is all that is needed to
+// check load thresholds (see load_factor_possibly_ge).
+struct pci_load_summary {
+  CISTA_COMPARABLE()
+
+  pax_limits limits_{};
+  std::uint16_t cdf_ge_95_{};
+  std::uint16_t cdf_gt_95_{};
+};
+
 struct pci_container {
   pci_container() = default;
   ~pci_container() = default;
 
   pci_container(pci_container const& c)
-      : groups_{c.groups_}, expected_load_{c.expected_load_} {}
+      : groups_{c.groups_},
+        expected_load_{c.expected_load_},
+        load_summaries_{c.load_summaries_} {
+    copy_load_valid(c);
+  }
 
   pci_container(pci_container&& c) noexcept
       : groups_{std::move(c.groups_)},
-        expected_load_{std::move(c.expected_load_)} {}
+        expected_load_{std::move(c.expected_load_)},
+        load_summaries_{std::move(c.load_summaries_)},
+        load_valid_{std::move(c.load_valid_)} {}
 
   pci_container& operator=(pci_container const& c) {
     if (this != &c) {
       groups_ = c.groups_;
       expected_load_ = c.expected_load_;
+      load_summaries_ = c.load_summaries_;
+      copy_load_valid(c);
     }
     return *this;
   }
@@ -42,6 +69,8 @@ struct pci_container {
   pci_container& operator=(pci_container&& c) noexcept {
     groups_ = std::move(c.groups_);
     expected_load_ = std::move(c.expected_load_);
+    load_summaries_ = std::move(c.load_summaries_);
+    load_valid_ = std::move(c.load_valid_);
     return *this;
   }
 
@@ -49,16 +78,24 @@ struct pci_container {
     auto const idx = static_cast<pci_index>(expected_load_.size());
     expected_load_.push_back(0U);
     groups_[idx];
+    load_summaries_.emplace_back();
+    load_valid_.emplace_back(false);
     return idx;
   }
 
+  // Must be called whenever the groups of a pci or their probabilities
+  // change, the cached load summary is then recomputed on the next access.
+  void invalidate_load(pci_index const idx) {
+    load_valid_[idx].store(false, std::memory_order_relaxed);
+  }
+
   void init_expected_load(passenger_group_container const& pgc,
                           pci_index const idx) {
     auto expected = std::uint16_t{};
     for (auto const grp_id : groups_[idx]) {
       auto const* grp = pgc[grp_id];
       if (is_planned_group(grp)) {
-        expected += grp->passengers_;
+        expected += grp->passengers();
       }
     }
     expected_load_[idx] = expected;
@@ -76,12 +113,29 @@ struct pci_container {
 
   std::size_t allocated_size() const {
     return groups_.allocated_size() +
-           expected_load_.allocated_size_ * sizeof(std::uint16_t);
+           expected_load_.allocated_size_ * sizeof(std::uint16_t) +
+           load_summaries_.capacity() * sizeof(pci_load_summary) +
+           load_valid_.size() * sizeof(std::atomic_bool);
   }
 
   dynamic_fws_multimap<passenger_group_index> groups_;
   mcd::vector<std::uint16_t> expected_load_;
   std::mutex mutex_;
+
+  // load summary cache, filled lazily by (concurrent) readers:
+  // an entry is only written while it is invalid (under load_mutex_) and
+  // only read after its valid flag has been set
+  mutable std::vector<pci_load_summary> load_summaries_;
+  mutable std::deque<std::atomic_bool> load_valid_;
+  mutable std::mutex load_mutex_;
+
+private:
+  void copy_load_valid(pci_container const& c) {
+    load_valid_.clear();
+    for (auto const& valid : c.load_valid_) {
+      load_valid_.emplace_back(valid.load(std::memory_order_acquire));
+    }
+  }
 };
 
 }  // namespace motis::paxmon
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 #include "motis/core/schedule/schedule.h"
@@ -11,9 +12,19 @@
 
 namespace motis::paxmon {
 
+// Parallelization of handle_rt_update (the results do not depend on it).
+struct rt_update_options {
+  // Delay updates (grouped by trip) and interchange checks are split into
+  // at most max_tasks_ tasks: 0 = one per hardware thread, 1 = serial.
+  unsigned max_tasks_{0U};
+  // Interchange checks are only split if each task gets this many edges.
+  std::size_t min_edges_per_task_{256U};
+};
+
 void handle_rt_update(universe& uv, capacity_maps const& caps,
                       schedule const& sched, motis::rt::RtUpdates const* update,
-                      int arrival_delay_threshold);
+                      int arrival_delay_threshold,
+                      rt_update_options const& opt = {});
 
 std::vector<motis::module::msg_ptr> update_affected_groups(
     universe& uv, schedule const& sched, int arrival_delay_threshold,
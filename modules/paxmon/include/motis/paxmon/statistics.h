@@ -73,6 +73,8 @@ struct tick_statistics {
   std::uint64_t t_fbs_events_{};
   std::uint64_t t_publish_{};
   std::uint64_t t_rt_updates_applied_total_{};
+  std::uint64_t t_rt_graph_update_{};
+  std::uint64_t t_broken_interchanges_{};
 };
 
 struct graph_statistics {
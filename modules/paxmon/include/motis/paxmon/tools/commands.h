@@ -5,5 +5,6 @@ namespace motis::paxmon::tools {
 int convert(int argc, char const** argv);
 int generate(int argc, char const** argv);
 int gen_groups(int argc, char const** argv);
+int bench_groups(int argc, char const** argv);
 
 }  // namespace motis::paxmon::tools
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "cista/hash.h"
+
+#include "motis/vector.h"
+
+#include "motis/core/schedule/time.h"
+#include "motis/core/schedule/trip.h"
+
+#include "motis/paxmon/universe.h"
+
+namespace motis::paxmon {
+
+// Flattened dynamic_fws_multimap: bucket i = data_[offsets_[i], offsets_[i+1])
+template <typename T>
+struct snapshot_multimap {
+  mcd::vector<std::uint64_t> offsets_;
+  mcd::vector<T> data_;
+};
+
+struct snapshot_leg {
+  trip_idx_t trip_idx_{};
+  unsigned enter_station_id_{};
+  unsigned exit_station_id_{};
+  motis::time enter_time_{};
+  motis::time exit_time_{};
+  bool has_enter_transfer_{};
+  duration enter_transfer_duration_{};
+  transfer_info::type enter_transfer_type_{};
+};
+
+struct snapshot_group {
+  bool valid_{};  // false: released group (index not in use)
+  data_source source_{};
+  std::uint16_t passengers_{};
+  motis::time planned_arrival_time_{INVALID_TIME};
+  group_source_flags source_flags_{group_source_flags::NONE};
+  bool ok_{true};
+  motis::time added_time_{INVALID_TIME};
+  float probability_{1.0F};
+  std::int16_t estimated_delay_{};
+  std::uint8_t generation_{};
+  std::uint64_t previous_version_{};
+};
+
+// Snapshot of a universe after the initial import (journeys matched /
+// rerouted and added to the graph). Only valid for the schedule and input
+// files it was created from (schedule_hash_, input_hash_).
+struct universe_snapshot {
+  cista::hash_t schedule_hash_{};
+  cista::hash_t input_hash_{};
+
+  mcd::vector<event_node> nodes_;
+  snapshot_multimap<edge> edges_;  // outgoing edges of each node
+
+  mcd::vector<trip_idx_t> trips_;  // trip_data_index -> trip_idx
+  snapshot_multimap<edge_index> trip_edges_;
+  snapshot_multimap<event_node_index> trip_canceled_nodes_;
+  mcd::vector<event_node_index> trip_enter_exit_nodes_;
+
+  snapshot_multimap<passenger_group_index> pci_groups_;
+  mcd::vector<std::uint16_t> pci_expected_load_;
+
+  snapshot_multimap<edge_index> interchanges_at_station_;
+
+  mcd::vector<snapshot_group> groups_;  // passenger_group_index -> group
+  snapshot_multimap<snapshot_leg> group_legs_;
+  snapshot_multimap<edge_index> group_edges_;
+};
+
+void write_universe_snapshot(universe const& uv, std::string const& path,
+                             cista::hash_t schedule_hash,
+                             cista::hash_t input_hash);
+
+// Restores the snapshot into an empty universe. Returns false (universe
+// unchanged) if there is no usable snapshot for the given hashes.
+bool read_universe_snapshot(universe& uv, std::string const& path,
+                            cista::hash_t schedule_hash,
+                            cista::hash_t input_hash);
+
+}  // namespace motis::paxmon
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <set>
+#include <vector>
 
 #include "motis/paxmon/localization.h"
 #include "motis/paxmon/passenger_group.h"
@@ -9,7 +9,13 @@
 
 namespace motis::paxmon {
 
-void update_load(passenger_group* pg, reachability_info const& reachability,
-                 passenger_localization const& localization, universe& uv);
+// Moves the group to the edges of its current route and returns these edges.
+// The edges stored for the group (passenger_groups_.edges) are not modified,
+// the caller has to set them to the returned edges (update_load only reads
+// the group edge pool, so it can run in parallel for different groups).
+std::vector<edge_index> update_load(passenger_group* pg,
+                                    reachability_info const& reachability,
+                                    passenger_localization const& localization,
+                                    universe& uv);
 
 }  // namespace motis::paxmon
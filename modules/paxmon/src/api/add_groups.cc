@@ -33,14 +33,12 @@ msg_ptr add_groups(paxmon_data& data, bool const allow_reuse,
         utl::verify(pg_fbs->planned_journey()->legs()->size() != 0,
                     "trying to add empty passenger group");
         auto input_pg = from_fbs(sched, pg_fbs);
-        if (input_pg.probability_ !=
-            std::clamp(input_pg.probability_, 0.F, 1.F)) {
+        auto const probability = std::clamp(input_pg.probability(), 0.F, 1.F);
+        if (input_pg.probability() != probability) {
           LOG(warn) << "add_groups: out of bounds probability: "
-                    << input_pg.probability_ << " => "
-                    << std::clamp(input_pg.probability_, 0.F, 1.F);
+                    << input_pg.probability() << " => " << probability;
         }
-        input_pg.probability_ = std::clamp(input_pg.probability_, 0.F, 1.F);
-        if (input_pg.probability_ == 0.F) {
+        if (probability == 0.F) {
           LOG(warn) << "adding passenger group with 0 probability";
         }
         if (allow_reuse) {
@@ -49,12 +47,16 @@ msg_ptr add_groups(paxmon_data& data, bool const allow_reuse,
               it != end(uv.passenger_groups_.groups_by_source_)) {
             for (auto const id : it->second) {
               auto existing_pg = uv.passenger_groups_.at(id);
-              if (existing_pg != nullptr && existing_pg->valid() &&
+              if (existing_pg != nullptr && uv.passenger_groups_.valid(id) &&
                   existing_pg->compact_planned_journey_ ==
                       input_pg.compact_planned_journey_) {
                 uv.update_tracker_.before_group_reused(existing_pg);
-                existing_pg->probability_ = std::min(
-                    1.F, existing_pg->probability_ + input_pg.probability_);
+                uv.passenger_groups_.set_probability(
+                    existing_pg,
+                    std::min(1.F, existing_pg->probability() + probability));
+                for (auto const& ei : uv.passenger_groups_.edges(id)) {
+                  uv.pax_connection_info_.invalidate_load(ei.get(uv)->pci_);
+                }
                 ++reused_groups;
                 uv.update_tracker_.after_group_reused(existing_pg);
                 return existing_pg;
@@ -63,6 +65,7 @@ msg_ptr add_groups(paxmon_data& data, bool const allow_reuse,
           }
         }
         auto pg = uv.passenger_groups_.add(std::move(input_pg));
+        uv.passenger_groups_.set_probability(pg, probability);
         uv.update_tracker_.before_group_added(pg);
         add_passenger_group_to_graph(sched, data.capacity_maps_, uv, *pg);
         return pg;
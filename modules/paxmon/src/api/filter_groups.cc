@@ -49,48 +49,51 @@ msg_ptr filter_groups(paxmon_data& data, msg_ptr const& msg) {
   std::vector<passenger_localization> localizations;
   mcd::hash_set<data_source> selected_ds;
 
-  for (auto const pg : uv.passenger_groups_) {
-    if (pg == nullptr || (only_active && !pg->valid())) {
+  // only the group columns are scanned, groups are only loaded for
+  // localization and for the selected groups
+  auto const& pgc = uv.passenger_groups_;
+  auto const& cols = pgc.columns_;
+  for (auto pgi = passenger_group_index{0}; pgi < pgc.size(); ++pgi) {
+    if (!pgc.exists(pgi) || (only_active && !pgc.valid(pgi))) {
       continue;
     }
     ++total_tracked_groups;
-    auto const est_arrival = pg->estimated_arrival_time();
+    auto const est_arrival = cols.estimated_arrival_time(pgi);
     if (est_arrival != INVALID_TIME && est_arrival <= current_time) {
       continue;
     }
     ++total_active_groups;
 
-    if (only_delayed && pg->estimated_delay() < min_delay) {
+    if (only_delayed &&
+        static_cast<std::uint16_t>(cols.estimated_delay_[pgi]) < min_delay) {
+      continue;
+    }
+
+    auto const is_forecast =
+        (cols.source_flags_[pgi] & group_source_flags::FORECAST) ==
+        group_source_flags::FORECAST;
+    if ((is_forecast && only_original) || (!is_forecast && only_forecast)) {
       continue;
     }
 
     passenger_localization localization;
     if (localization_needed) {
-      auto const reachability =
-          get_reachability(uv, pg->compact_planned_journey_);
-      localization = localize(sched, reachability, search_time);
+      auto const& cj = pgc[pgi]->compact_planned_journey_;
+      localization = localize(sched, get_reachability(uv, cj), search_time);
       if (only_with_alternative_potential &&
-          localization.at_station_->index_ ==
-              pg->compact_planned_journey_.destination_station_id()) {
+          localization.at_station_->index_ == cj.destination_station_id()) {
         continue;
       }
     }
 
-    if ((pg->source_flags_ & group_source_flags::FORECAST) ==
-        group_source_flags::FORECAST) {
-      if (only_original) {
-        continue;
-      }
+    if (is_forecast) {
       ++filtered_forecast_groups;
     } else {
-      if (only_forecast) {
-        continue;
-      }
       ++filtered_original_groups;
     }
 
-    selected_group_ids.emplace_back(pg->id_);
-    selected_ds.insert(pg->source_);
+    selected_group_ids.emplace_back(pgi);
+    selected_ds.insert(pgc[pgi]->source_);
     if (include_localization) {
       localizations.emplace_back(localization);
     }
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iterator>
 #include <tuple>
+#include <utility>
 
 #include "utl/to_vec.h"
 #include "utl/verify.h"
@@ -78,6 +79,10 @@ msg_ptr filter_trips(paxmon_data& data, msg_ptr const& msg) {
   auto total_critical_sections = 0ULL;
   std::vector<trip_info> selected_trips;
 
+  // No precomputed criticality order: thresholds, time filters and
+  // ignore_past_sections are request parameters and the response counts all
+  // matching trips, so every trip is visited. Sections only read their
+  // cached load summary (no load distributions unless include_edges is set).
   for (auto const& [trp_idx, tdi] : uv.trip_data_.mapping_) {
     auto ti = trip_info{trp_idx};
     auto const trip_edges = uv.trip_data_.edges(tdi);
@@ -135,18 +140,19 @@ msg_ptr filter_trips(paxmon_data& data, msg_ptr const& msg) {
       if (!include_edges && ignore_section) {
         continue;
       }
-      auto const groups = uv.pax_connection_info_.groups_[e->pci_];
-      auto const pdf = get_load_pdf(uv.passenger_groups_, groups);
-      auto const cdf = get_cdf(pdf);
+      auto const& summary = get_load_summary(uv, e->pci_);
+      auto const& pax_limits = summary.limits_;
       auto const capacity = e->capacity();
-      auto const pax_limits = get_pax_limits(uv.passenger_groups_, groups);
       auto const expected_pax = get_expected_load(uv, e->pci_);
       ti.max_pax_range_ = std::max(
           ti.max_pax_range_,
           static_cast<std::uint16_t>(pax_limits.max_ - pax_limits.min_));
       if (include_edges) {
-        ti.edge_load_infos_.emplace_back(
-            make_edge_load_info(uv, e, pdf, cdf, false));
+        auto pdf = get_load_pdf(uv.passenger_groups_,
+                                uv.pax_connection_info_.groups_[e->pci_]);
+        auto cdf = get_cdf(pdf);
+        ti.edge_load_infos_.emplace_back(make_edge_load_info(
+            uv, e, std::move(pdf), std::move(cdf), false));
         if (ignore_section) {
           continue;
         }
@@ -157,20 +163,20 @@ msg_ptr filter_trips(paxmon_data& data, msg_ptr const& msg) {
         continue;
       }
       if (!include &&
-          load_factor_possibly_ge(cdf, capacity, include_load_threshold)) {
+          load_factor_possibly_ge(summary, capacity, include_load_threshold)) {
         include = true;
       }
       auto const load =
           static_cast<float>(pax_limits.max_) / static_cast<float>(capacity);
       ti.max_load_ = std::max(ti.max_load_, load);
-      if (load_factor_possibly_ge(cdf, capacity, critical_load_threshold)) {
+      if (load_factor_possibly_ge(summary, capacity, critical_load_threshold)) {
         ++ti.critical_sections_;
         ++total_critical_sections;
         if (ti.first_critical_time_ == INVALID_TIME) {
           ti.first_critical_load_ = load;
           ti.first_critical_time_ = e->from(uv)->current_time();
         }
-      } else if (load_factor_possibly_ge(cdf, capacity,
+      } else if (load_factor_possibly_ge(summary, capacity,
                                          crowded_load_threshold)) {
         ++ti.crowded_sections_;
       }
@@ -205,7 +205,7 @@ msg_ptr get_addressable_groups(paxmon_data& data, msg_ptr const& msg) {
 
     for (auto const pgi : uv.pax_connection_info_.groups_[e->pci_]) {
       auto const* pg = uv.passenger_groups_.at(pgi);
-      if (pg->probability_ == 0.0F) {
+      if (pg->probability() == 0.0F) {
         continue;
       }
       auto skip = true;
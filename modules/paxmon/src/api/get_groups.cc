@@ -39,7 +39,7 @@ msg_ptr get_groups(paxmon_data& data, msg_ptr const& msg) {
         it != end(uv.passenger_groups_.groups_by_source_)) {
       for (auto const pgid : it->second) {
         if (auto const pg = uv.passenger_groups_.at(pgid); pg != nullptr) {
-          if (!all_generations && !pg->valid()) {
+          if (!all_generations && !uv.passenger_groups_.valid(pgid)) {
             continue;
           }
           groups.emplace_back(to_fbs(sched, mc, *pg));
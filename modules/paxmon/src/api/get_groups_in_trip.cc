@@ -33,7 +33,7 @@ struct grouped_key {
 std::pair<std::uint32_t /*station*/, time> get_group_entry(
     universe const& uv, schedule const& sched, passenger_group const* pg,
     trip_idx_t const ti) {
-  for (auto const& ei : pg->edges_) {
+  for (auto const& ei : uv.passenger_groups_.edges(pg->id_)) {
     auto const* e = ei.get(uv);
     for (auto const& trp : e->get_trips(sched)) {
       if (trp->trip_idx_ == ti) {
@@ -184,7 +184,7 @@ motis::module::msg_ptr get_groups_in_trip(paxmon_data& data,
 
     for (auto const pgi : uv.pax_connection_info_.groups_[e->pci_]) {
       auto const* pg = uv.passenger_groups_.at(pgi);
-      if (pg->probability_ == 0.0F) {
+      if (pg->probability() == 0.0F) {
         continue;
       }
       trip const* other_trp = nullptr;
@@ -213,11 +213,11 @@ motis::module::msg_ptr get_groups_in_trip(paxmon_data& data,
       auto const key = get_key(pg, other_trp);
       auto& gg = grouped[key];
       gg.groups_.emplace_back(pgi);
-      gg.max_pax_ += pg->passengers_;
-      if (pg->probability_ == 1.0F) {
-        gg.min_pax_ += pg->passengers_;
+      gg.max_pax_ += pg->passengers();
+      if (pg->probability() == 1.0F) {
+        gg.min_pax_ += pg->passengers();
       }
-      gg.avg_pax_ += pg->passengers_ * pg->probability_;
+      gg.avg_pax_ += pg->passengers() * pg->probability();
     }
 
     for (auto& [key, gbd] : grouped) {
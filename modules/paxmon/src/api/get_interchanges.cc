@@ -98,7 +98,7 @@ msg_ptr get_interchanges(paxmon_data& data, msg_ptr const& msg) {
       if (include_group_infos) {
         for (auto const pgi : uv.pax_connection_info_.groups_[ic_edge->pci_]) {
           auto const* pg = uv.passenger_groups_.at(pgi);
-          if (pg->probability_ != 0.0F) {
+          if (pg->probability() != 0.0F) {
             group_infos.emplace_back(to_fbs_base_info(mc, *pg));
           }
         }
@@ -23,7 +23,7 @@ void add_interchange(event_node_index from, event_node_index to,
     if (e.type_ == edge_type::INTERCHANGE && e.to_ == to &&
         e.transfer_time() == transfer_time) {
       add_passenger_group_to_edge(uv, &e, grp);
-      grp->edges_.emplace_back(get_edge_index(uv, &e));
+      uv.passenger_groups_.add_edge(grp->id_, get_edge_index(uv, &e));
       return;
     }
   }
@@ -33,7 +33,7 @@ void add_interchange(event_node_index from, event_node_index to,
   auto const* e =
       add_edge(uv, make_interchange_edge(from, to, transfer_time, pci));
   auto const ei = get_edge_index(uv, e);
-  grp->edges_.emplace_back(ei);
+  uv.passenger_groups_.add_edge(grp->id_, ei);
 
   auto const from_station = uv.graph_.nodes_[from].station_idx();
   auto const to_station = uv.graph_.nodes_[to].station_idx();
@@ -48,7 +48,8 @@ void add_interchange(event_node_index from, event_node_index to,
 void add_passenger_group_to_graph(schedule const& sched,
                                   capacity_maps const& caps, universe& uv,
                                   passenger_group& grp) {
-  utl::verify(grp.edges_.empty(), "group already added to graph");
+  utl::verify(uv.passenger_groups_.edges(grp.id_).empty(),
+              "group already added to graph");
   auto exit_node = INVALID_EVENT_NODE_INDEX;
   auto last_trip = INVALID_TRIP_DATA_INDEX;
 
@@ -87,7 +88,7 @@ void add_passenger_group_to_graph(schedule const& sched,
       if (in_trip) {
         auto* e = ei.get(uv);
         add_passenger_group_to_edge(uv, e, &grp);
-        grp.edges_.emplace_back(ei);
+        uv.passenger_groups_.add_edge(grp.id_, ei);
         auto const to = e->to(uv);
         if (to->station_ == leg.exit_station_id_ &&
             to->schedule_time_ == leg.exit_time_) {
@@ -99,11 +100,11 @@ void add_passenger_group_to_graph(schedule const& sched,
       }
     }
     if (!enter_found || !exit_found) {
-      for (auto const& ei : grp.edges_) {
+      for (auto const& ei : uv.passenger_groups_.edges(grp.id_)) {
         auto* e = ei.get(uv);
         remove_passenger_group_from_edge(uv, e, &grp);
       }
-      grp.edges_.clear();
+      uv.passenger_groups_.clear_edges(grp.id_);
 
       std::cout << "add_passenger_group_to_graph: enter_found=" << enter_found
                 << ", exit_found=" << exit_found << "\n";
@@ -132,16 +133,17 @@ void add_passenger_group_to_graph(schedule const& sched,
                     0, uv);
   }
 
-  utl::verify(!grp.edges_.empty(), "empty passenger group edges");
+  utl::verify(uv.passenger_groups_.valid(grp.id_),
+              "empty passenger group edges");
 }
 
 void remove_passenger_group_from_graph(universe& uv, passenger_group* pg) {
-  for (auto const& ei : pg->edges_) {
+  for (auto const& ei : uv.passenger_groups_.edges(pg->id_)) {
     auto* e = ei.get(uv);
     auto guard = std::lock_guard{uv.pax_connection_info_.mutex(e->pci_)};
     remove_passenger_group_from_edge(uv, e, pg);
   }
-  pg->edges_.clear();
+  uv.passenger_groups_.clear_edges(pg->id_);
 }
 
 build_graph_stats build_graph_from_journeys(schedule const& sched,
@@ -158,7 +160,7 @@ build_graph_stats build_graph_from_journeys(schedule const& sched,
                 "empty passenger group");
     try {
       add_passenger_group_to_graph(sched, caps, uv, *pg);
-      if (pg->edges_.empty()) {
+      if (!uv.passenger_groups_.valid(pg->id_)) {
         uv.passenger_groups_.release(pg->id_);
       }
     } catch (std::system_error const& e) {
@@ -24,7 +24,7 @@ bool check_graph_integrity(universe const& uv, schedule const& sched) {
     for (auto const& e : n.outgoing_edges(uv)) {
       for (auto const pg_id : uv.pax_connection_info_.groups_[e.pci_]) {
         auto const* pg = uv.passenger_groups_.at(pg_id);
-        if (pg->probability_ <= 0.0 || pg->passengers_ >= 200) {
+        if (pg->probability() <= 0.0 || pg->passengers() >= 200) {
           std::cout << "!! invalid psi @" << e.type() << ": id=" << pg->id_
                     << "\n";
           ok = false;
@@ -32,9 +32,10 @@ bool check_graph_integrity(universe const& uv, schedule const& sched) {
         if (!e.is_trip()) {
           continue;
         }
-        if (std::find_if(begin(pg->edges_), end(pg->edges_),
+        auto const pg_edges = uv.passenger_groups_.edges(pg_id);
+        if (std::find_if(begin(pg_edges), end(pg_edges),
                          [&](auto const& ei) { return ei.get(uv) == &e; }) ==
-            end(pg->edges_)) {
+            end(pg_edges)) {
           std::cout << "!! edge missing in pg.edges @" << e.type() << "\n";
           ok = false;
         }
@@ -159,7 +160,7 @@ bool check_graph_integrity(universe const& uv, schedule const& sched) {
     if (pg == nullptr) {
       continue;
     }
-    for (auto const& ei : pg->edges_) {
+    for (auto const& ei : uv.passenger_groups_.edges(pg->id_)) {
       auto const* e = ei.get(uv);
       auto const groups = uv.pax_connection_info_.groups_[e->pci_];
       if (std::find(begin(groups), end(groups), pg->id_) == end(groups)) {
@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <mutex>
 #include <numeric>
 
 #include "utl/enumerate.h"
@@ -19,6 +20,44 @@ std::uint16_t get_expected_load(universe const& uv, pci_index const idx) {
   return uv.pax_connection_info_.expected_load_[idx];
 }
 
+pci_load_summary get_load_summary(pax_cdf const& cdf,
+                                  pax_limits const& limits) {
+  auto const none = static_cast<std::uint16_t>(limits.max_ + 1U);
+  auto summary = pci_load_summary{limits, none, none};
+  auto ge_found = false;
+  for (auto const& [pax, prob] : utl::enumerate(cdf.data_)) {
+    if (!ge_found && prob >= 0.95F) {
+      summary.cdf_ge_95_ = static_cast<std::uint16_t>(pax);
+      ge_found = true;
+    }
+    if (prob > 0.95F) {
+      summary.cdf_gt_95_ = static_cast<std::uint16_t>(pax);
+      break;
+    }
+  }
+  return summary;
+}
+
+pci_load_summary const& get_load_summary(universe const& uv,
+                                         pci_index const idx) {
+  auto const& pcis = uv.pax_connection_info_;
+  if (pcis.load_valid_[idx].load(std::memory_order_acquire)) {
+    return pcis.load_summaries_[idx];
+  }
+
+  auto const groups = pcis.groups_[idx];
+  auto const summary =
+      get_load_summary(get_load_cdf(uv.passenger_groups_, groups),
+                       get_pax_limits(uv.passenger_groups_, groups));
+
+  auto const guard = std::lock_guard{pcis.load_mutex_};
+  if (!pcis.load_valid_[idx].load(std::memory_order_relaxed)) {
+    pcis.load_summaries_[idx] = summary;
+    pcis.load_valid_[idx].store(true, std::memory_order_release);
+  }
+  return pcis.load_summaries_[idx];
+}
+
 std::uint16_t get_pax_quantile(pax_cdf const& cdf, float const q) {
   for (auto const& [pax, prob] : utl::enumerate(cdf.data_)) {
     if (prob >= q) {
@@ -106,7 +145,9 @@ std::size_t get_max_new_pax(
         additional_groups) {
   return std::accumulate(
       begin(additional_groups), end(additional_groups), 0ULL,
-      [](auto const sum, auto const& p) { return sum + p.first->passengers_; });
+      [](auto const sum, auto const& p) {
+        return sum + p.first->passengers();
+      });
 }
 
 void add_additional_groups_base(
@@ -116,7 +157,7 @@ void add_additional_groups_base(
   auto const max_new_pax = get_max_new_pax(additional_groups);
   pdf.data_.resize(pdf.data_.size() + max_new_pax);
   for (auto const& [grp, grp_probability] : additional_groups) {
-    convolve_base(pdf, grp->passengers_, grp_probability);
+    convolve_base(pdf, grp->passengers(), grp_probability);
   }
 }
 
@@ -132,12 +173,12 @@ void add_additional_groups_avx(
   auto limits = pax_limits{
       std::min_element(begin(additional_groups), end(additional_groups),
                        [](auto const& p1, auto const& p2) {
-                         return p1.first->passengers_ < p2.first->passengers_;
+                         return p1.first->passengers() < p2.first->passengers();
                        })
-          ->first->passengers_,
+          ->first->passengers(),
       0};
   for (auto const& [grp, grp_probability] : additional_groups) {
-    convolve_avx(pdf, grp->passengers_, grp_probability, limits, buf);
+    convolve_avx(pdf, grp->passengers(), grp_probability, limits, buf);
   }
   pdf.data_.resize(pdf_size);
 }
@@ -191,6 +232,20 @@ bool load_factor_possibly_ge(pax_cdf const& cdf, std::uint16_t capacity,
   }
 }
 
+bool load_factor_possibly_ge(pci_load_summary const& summary,
+                             std::uint16_t capacity, float threshold) {
+  auto const pax_threshold =
+      static_cast<std::uint16_t>(static_cast<float>(capacity) * threshold);
+
+  // same result as for the cdf: cdf[t] <= 0.95 || cdf[t - 1] < 0.95
+  if (pax_threshold > summary.limits_.max_) {
+    return false;
+  } else {
+    return pax_threshold < summary.cdf_gt_95_ ||
+           (pax_threshold > 0 && pax_threshold <= summary.cdf_ge_95_);
+  }
+}
+
 bool load_factor_possibly_ge(lf_df_t const& lf_df, float threshold) {
   return lf_df.lower_bound(threshold) != end(lf_df);
 }
@@ -214,14 +214,14 @@ trip_data_index get_trip(universe const& uv, trip_idx_t const trip_idx) {
 
 void add_interchange_edges(event_node* evn,
                            std::vector<edge_index>& updated_interchange_edges,
-                           universe& uv) {
+                           universe& uv, system_statistics& stats) {
   if (evn->type_ == event_type::ARR) {
     auto oe = evn->outgoing_edges(uv);
     return utl::all(oe)  //
            | utl::remove_if(
                  [](auto&& e) { return e.type_ != edge_type::INTERCHANGE; })  //
            | utl::for_each([&](auto&& e) {
-               ++uv.system_stats_.total_updated_interchange_edges_;
+               ++stats.total_updated_interchange_edges_;
                updated_interchange_edges.push_back(get_edge_index(uv, &e));
              });
   } else /*if (evn->type_ == event_type::DEP)*/ {
@@ -230,7 +230,7 @@ void add_interchange_edges(event_node* evn,
            | utl::remove_if(
                  [](auto&& e) { return e.type_ != edge_type::INTERCHANGE; })  //
            | utl::for_each([&](auto&& e) {
-               ++uv.system_stats_.total_updated_interchange_edges_;
+               ++stats.total_updated_interchange_edges_;
                updated_interchange_edges.push_back(get_edge_index(uv, &e));
              });
   }
@@ -238,14 +238,15 @@ void add_interchange_edges(event_node* evn,
 
 void update_event_times(schedule const& sched, universe& uv,
                         RtDelayUpdate const* du,
-                        std::vector<edge_index>& updated_interchange_edges) {
+                        std::vector<edge_index>& updated_interchange_edges,
+                        system_statistics& stats) {
   auto const trp = from_fbs(sched, du->trip());
   auto const tdi = uv.trip_data_.find_index(trp->trip_idx_);
   if (tdi == INVALID_TRIP_DATA_INDEX) {
     return;
   }
   auto trip_edges = uv.trip_data_.edges(tdi);
-  ++uv.system_stats_.update_event_times_trip_edges_found_;
+  ++stats.update_event_times_trip_edges_found_;
   for (auto const& ue : *du->events()) {
     auto const station_id =
         get_station(sched, ue->base()->station_id()->str())->index_;
@@ -258,17 +259,17 @@ void update_event_times(schedule const& sched, universe& uv,
       if (ue->base()->event_type() == EventType_DEP &&
           from->type_ == event_type::DEP && from->station_ == station_id &&
           from->schedule_time_ == schedule_time) {
-        ++uv.system_stats_.update_event_times_dep_updated_;
+        ++stats.update_event_times_dep_updated_;
         from->time_ =
             unix_to_motistime(sched.schedule_begin_, ue->updated_time());
-        add_interchange_edges(from, updated_interchange_edges, uv);
+        add_interchange_edges(from, updated_interchange_edges, uv, stats);
       } else if (ue->base()->event_type() == EventType_ARR &&
                  to->type_ == event_type::ARR && to->station_ == station_id &&
                  to->schedule_time_ == schedule_time) {
-        ++uv.system_stats_.update_event_times_arr_updated_;
+        ++stats.update_event_times_arr_updated_;
         to->time_ =
             unix_to_motistime(sched.schedule_begin_, ue->updated_time());
-        add_interchange_edges(to, updated_interchange_edges, uv);
+        add_interchange_edges(to, updated_interchange_edges, uv, stats);
       }
     }
   }
@@ -298,6 +299,7 @@ void add_passenger_group_to_edge(universe& uv, edge* e, passenger_group* pg) {
   auto it = std::lower_bound(begin(groups), end(groups), pg->id_);
   if (it == end(groups) || *it != pg->id_) {
     groups.insert(it, pg->id_);
+    uv.pax_connection_info_.invalidate_load(e->pci_);
   }
 }
 
@@ -307,6 +309,7 @@ void remove_passenger_group_from_edge(universe& uv, edge* e,
   auto it = std::lower_bound(begin(groups), end(groups), pg->id_);
   if (it != end(groups) && *it == pg->id_) {
     groups.erase(it);
+    uv.pax_connection_info_.invalidate_load(e->pci_);
   }
 }
 
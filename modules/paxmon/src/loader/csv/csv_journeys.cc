@@ -6,17 +6,26 @@
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <regex>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "cista/mmap.h"
 
 #include "fmt/ostream.h"
 
 #include "utl/nwise.h"
 #include "utl/parser/buf_reader.h"
 #include "utl/parser/csv_range.h"
-#include "utl/parser/file.h"
 #include "utl/parser/line_range.h"
 #include "utl/pipes/for_each.h"
 #include "utl/to_vec.h"
@@ -27,6 +36,7 @@
 #include "motis/core/access/station_access.h"
 #include "motis/core/access/trip_iterator.h"
 #include "motis/core/conv/trip_conv.h"
+#include "motis/module/context/motis_parallel_for.h"
 
 #include "motis/paxmon/compact_journey_util.h"
 #include "motis/paxmon/loader/csv/row.h"
@@ -35,6 +45,7 @@
 
 using namespace motis::logging;
 using namespace motis::paxmon::util;
+namespace fs = boost::filesystem;
 
 template <>
 struct fmt::formatter<std::optional<std::pair<std::uint64_t, std::uint64_t>>>
@@ -111,31 +122,122 @@ std::uint32_t get_train_nr(light_connection const* lc, std::uint32_t expected) {
   return first_train_nr;
 }
 
-void enum_trip_candidates(schedule const& sched, std::uint32_t from_station_idx,
+struct station_departure {
+  time d_time_{};
+  // position in route node -> route edge -> connection order
+  std::uint32_t order_{};
+  light_connection const* lcon_{};
+};
+
+// All route edge departures of a station, sorted by departure time.
+// Replaces scanning every route edge of the station for each leg. order_
+// restores the route edge scan order for the candidates of a leg, so
+// the selected trip (first best candidate) does not change.
+// Stations are indexed on first use, i.e. only stations used in the file.
+struct departure_index {
+  explicit departure_index(schedule const& sched)
+      : sched_{sched},
+        departures_(sched.station_nodes_.size()),
+        indexed_(sched.station_nodes_.size()) {}
+
+  std::vector<station_departure const*> get_departures(
+      std::uint32_t const station_idx, time const earliest_dep,
+      time const latest_dep) const {
+    std::call_once(indexed_.at(station_idx),
+                   [&]() { index_station(station_idx); });
+    auto const& deps = departures_[station_idx];
+    auto result = std::vector<station_departure const*>{};
+    for (auto it = std::lower_bound(begin(deps), end(deps), earliest_dep,
+                                    [](station_departure const& d,
+                                       time const t) { return d.d_time_ < t; });
+         it != end(deps) && it->d_time_ <= latest_dep; ++it) {
+      result.emplace_back(&*it);
+    }
+    std::sort(begin(result), end(result),
+              [](station_departure const* a, station_departure const* b) {
+                return a->order_ < b->order_;
+              });
+    return result;
+  }
+
+private:
+  void index_station(std::uint32_t const station_idx) const {
+    auto& deps = departures_[station_idx];
+    sched_.station_nodes_[station_idx]->for_each_route_node(
+        [&](node const* route_node) {
+          for (auto const& e : route_node->edges_) {
+            if (e.type() != ::motis::edge::ROUTE_EDGE) {
+              continue;
+            }
+            for (auto const& lc : e.m_.route_edge_.conns_) {
+              deps.emplace_back(station_departure{
+                  lc.d_time_, static_cast<std::uint32_t>(deps.size()), &lc});
+            }
+          }
+        });
+    std::stable_sort(
+        begin(deps), end(deps),
+        [](station_departure const& a, station_departure const& b) {
+          return a.d_time_ < b.d_time_;
+        });
+  }
+
+  schedule const& sched_;
+  mutable std::vector<std::vector<station_departure>> departures_;
+  mutable std::vector<std::once_flag> indexed_;
+};
+
+// Calls fn(lcon) for the departures at the station in
+// [earliest_dep, latest_dep] in route edge order until fn returns false.
+// Without a departure index, the route edges of the station are scanned.
+template <typename Fn>
+void for_each_departure(schedule const& sched, departure_index const* deps,
+                        std::uint32_t const station_idx,
+                        time const earliest_dep, time const latest_dep,
+                        Fn&& fn) {
+  if (deps != nullptr) {
+    for (auto const* dep :
+         deps->get_departures(station_idx, earliest_dep, latest_dep)) {
+      if (!fn(dep->lcon_)) {
+        return;
+      }
+    }
+    return;
+  }
+
+  auto keep_going = true;
+  sched.station_nodes_.at(station_idx)
+      ->for_each_route_node([&](node const* route_node) {
+        for (auto const& e : route_node->edges_) {
+          if (e.type() != ::motis::edge::ROUTE_EDGE) {
+            continue;
+          }
+          auto const& conns = e.m_.route_edge_.conns_;
+          for (auto lc = std::lower_bound(begin(conns), end(conns),
+                                          light_connection{earliest_dep});
+               keep_going && lc != end(conns) && lc->d_time_ <= latest_dep;
+               lc = std::next(lc)) {
+            keep_going = fn(&*lc);
+          }
+        }
+      });
+}
+
+void enum_trip_candidates(schedule const& sched, departure_index const* deps,
+                          std::uint32_t from_station_idx,
                           std::uint32_t to_station_idx, time enter_time,
                           time exit_time, std::uint32_t train_nr,
                           duration max_time_diff,
                           std::function<bool(trip_candidate&&)> const& cb) {
-  auto const from_station = sched.station_nodes_.at(from_station_idx).get();
   auto const dep_interval = get_interval(enter_time, max_time_diff);
   auto const earliest_dep = dep_interval.first;
   auto const latest_dep = dep_interval.second;
   auto const expected_travel_time = static_cast<int>(exit_time - enter_time);
-  auto keep_going = true;
-  from_station->for_each_route_node([&](node const* route_node) {
-    if (!keep_going) {
-      return;
-    }
-    for (auto const& e : route_node->edges_) {
-      if (e.type() != ::motis::edge::ROUTE_EDGE) {
-        continue;
-      }
-      auto const& conns = e.m_.route_edge_.conns_;
-      for (auto lc = std::lower_bound(begin(conns), end(conns),
-                                      light_connection{earliest_dep});
-           lc != end(conns) && lc->d_time_ <= latest_dep; lc = std::next(lc)) {
+  for_each_departure(
+      sched, deps, from_station_idx, earliest_dep, latest_dep,
+      [&](light_connection const* lc) {
         if (lc->valid_ == 0) {
-          continue;
+          return true;
         }
         auto const current_train_nr = get_train_nr(lc, train_nr);
         auto const& current_category =
@@ -144,7 +246,8 @@ void enum_trip_candidates(schedule const& sched, std::uint32_t from_station_idx,
 
         for (auto trp : *sched.merged_trips_.at(lc->trips_)) {
           for (auto const& stop : access::stops(trp)) {
-            if (stop.get_station_id() == to_station_idx && stop.has_arrival()) {
+            if (stop.get_station_id() == to_station_idx &&
+                stop.has_arrival()) {
               auto const arrival_time = stop.arr_lcon().a_time_;
               auto const exit_diff = static_cast<int>(arrival_time) - exit_time;
               auto const travel_time =
@@ -152,22 +255,23 @@ void enum_trip_candidates(schedule const& sched, std::uint32_t from_station_idx,
               if (travel_time < 0 || std::abs(exit_diff) > max_time_diff) {
                 continue;
               }
-              keep_going = cb(trip_candidate{
-                  trp, lc->d_time_, arrival_time, current_train_nr,
-                  current_train_nr == train_nr, enter_diff, exit_diff,
-                  expected_travel_time - travel_time, current_category});
-              if (!keep_going) {
-                return;
+              if (!cb(trip_candidate{trp, lc->d_time_, arrival_time,
+                                     current_train_nr,
+                                     current_train_nr == train_nr, enter_diff,
+                                     exit_diff,
+                                     expected_travel_time - travel_time,
+                                     current_category})) {
+                return false;
               }
             }
           }
         }
-      }
-    }
-  });
+        return true;
+      });
 }
 
 trip_candidate get_best_trip_candidate(schedule const& sched,
+                                       departure_index const* deps,
                                        std::uint32_t from_station_idx,
                                        std::uint32_t to_station_idx,
                                        time enter_time, time exit_time,
@@ -175,8 +279,8 @@ trip_candidate get_best_trip_candidate(schedule const& sched,
                                        duration max_time_diff) {
   auto best = trip_candidate{};
 
-  enum_trip_candidates(sched, from_station_idx, to_station_idx, enter_time,
-                       exit_time, train_nr, max_time_diff,
+  enum_trip_candidates(sched, deps, from_station_idx, to_station_idx,
+                       enter_time, exit_time, train_nr, max_time_diff,
                        [&](trip_candidate&& candidate) {
                          if (candidate.is_better_than(best)) {
                            best = candidate;
@@ -187,7 +291,8 @@ trip_candidate get_best_trip_candidate(schedule const& sched,
   return best;
 }
 
-void debug_trip_match(schedule const& sched, std::uint32_t from_station_idx,
+void debug_trip_match(schedule const& sched, departure_index const* deps,
+                      std::uint32_t from_station_idx,
                       std::uint32_t to_station_idx, time enter_time,
                       time exit_time, std::uint32_t train_nr,
                       std::string_view category, std::ofstream& match_log,
@@ -202,8 +307,8 @@ void debug_trip_match(schedule const& sched, std::uint32_t from_station_idx,
             << "], expected travel_time=" << expected_travel_time << ":\n";
 
   enum_trip_candidates(
-      sched, from_station_idx, to_station_idx, enter_time, exit_time, train_nr,
-      max_time_diff, [&](trip_candidate&& candidate) {
+      sched, deps, from_station_idx, to_station_idx, enter_time, exit_time,
+      train_nr, max_time_diff, [&](trip_candidate&& candidate) {
         fmt::print(
             match_log,
             "    dep={} [{:+3}], train_nr={:6} [{}], "
@@ -279,11 +384,27 @@ void set_transfer_info(schedule const& sched,
                               departure_station, departure_track);
 }
 
+// A csv row, matched independently of the other rows of its journey.
+struct parsed_row {
+  std::pair<std::uint32_t, std::uint32_t> id_{};
+  std::uint16_t passengers_{};
+  bool foot_{};
+  input_journey_leg leg_;
+
+  std::time_t enter_{};
+  std::time_t exit_{};
+  std::uint32_t train_nr_{};
+  // only set if a match log is written
+  std::string from_;
+  std::string to_;
+  std::string category_;
+};
+
 void write_match_log(
     std::ofstream& match_log, schedule const& sched,
-    input_journey_leg const& leg,
+    departure_index const* deps, input_journey_leg const& leg,
     std::optional<std::pair<std::uint64_t, std::uint64_t>> const& current_id,
-    struct row const& row,
+    parsed_row const& row,
     std::vector<input_journey_leg> const& current_input_legs,
     duration const debug_match_tolerance) {
   if (!match_log) {
@@ -292,62 +413,150 @@ void write_match_log(
   if (!leg.stations_found()) {
     if (!leg.from_station_idx_) {
       fmt::print(match_log, "[{}] Station not found: {}\n", current_id,
-                 row.from_.val().view());
+                 row.from_);
     }
     if (!leg.to_station_idx_) {
       fmt::print(match_log, "[{}] Station not found: {}\n", current_id,
-                 row.to_.val().view());
+                 row.to_);
     }
   }
   if (!leg.valid_times()) {
     if (leg.enter_time_ == INVALID_TIME) {
       fmt::print(match_log, "[{}] Invalid enter timestamp: {}\n", current_id,
-                 format_unix_time(row.enter_.val()));
+                 format_unix_time(row.enter_));
     }
     if (leg.exit_time_ == INVALID_TIME) {
       fmt::print(match_log, "[{}] Invalid exit timestamp: {}\n", current_id,
-                 format_unix_time(row.exit_.val()));
+                 format_unix_time(row.exit_));
     }
   }
   if (!leg.trip_found()) {
     fmt::print(match_log,
                "[{}] Trip not found: from={:7}, to={:7}, enter={}, "
                "exit={}, train_nr={:6}, category={:6}, leg={}\n",
-               current_id, row.from_.val().view(), row.to_.val().view(),
-               format_unix_time(row.enter_.val()),
-               format_unix_time(row.exit_.val()), row.train_nr_.val(),
-               row.category_.val().view(), current_input_legs.size());
+               current_id, row.from_, row.to_, format_unix_time(row.enter_),
+               format_unix_time(row.exit_), row.train_nr_, row.category_,
+               current_input_legs.size());
     if (leg.stations_found() && leg.valid_times()) {
-      debug_trip_match(
-          sched, leg.from_station_idx_.value(), leg.to_station_idx_.value(),
-          leg.enter_time_, leg.exit_time_, row.train_nr_.val(),
-          row.category_.val().view(), match_log, debug_match_tolerance);
+      debug_trip_match(sched, deps, leg.from_station_idx_.value(),
+                       leg.to_station_idx_.value(), leg.enter_time_,
+                       leg.exit_time_, row.train_nr_, row.category_,
+                       match_log, debug_match_tolerance);
     }
   }
 }
 
+struct journey_chunk {
+  std::string_view rows_;  // complete lines, without the header
+  std::vector<parsed_row> parsed_;
+};
+
+std::vector<journey_chunk> split_into_chunks(std::string_view const rows,
+                                             std::size_t const chunk_size) {
+  auto chunks = std::vector<journey_chunk>{};
+  auto start = std::size_t{0U};
+  while (start < rows.size()) {
+    auto end = rows.find('\n', std::min(start + chunk_size, rows.size() - 1));
+    end = end == std::string_view::npos ? rows.size() : end + 1;
+    chunks.emplace_back(journey_chunk{rows.substr(start, end - start), {}});
+    start = end;
+  }
+  return chunks;
+}
+
+// Lines of a chunk for utl::csv<row>: the header line (needed to find the
+// columns) followed by the rows of the chunk, both read directly from the
+// mapped file.
+struct chunk_reader {
+  utl::cstr read_line() {
+    if (!header_read_) {
+      header_read_ = true;
+      return header_.read_line();
+    }
+    return rows_.read_line();
+  }
+
+  utl::buf_reader header_;
+  utl::buf_reader rows_;
+  bool header_read_{false};
+};
+
+void parse_chunk(schedule const& sched, departure_index const* deps,
+                 std::string_view const header, journey_chunk& chunk,
+                 duration const match_tolerance, bool const keep_strings) {
+  utl::line_range<chunk_reader>{
+      chunk_reader{utl::buf_reader{utl::cstr{header.data(), header.size()}},
+                   utl::buf_reader{utl::cstr{chunk.rows_.data(),
+                                             chunk.rows_.size()}}}}  //
+      | utl::csv<row>()  //
+      | utl::for_each([&](auto&& row) {
+          auto& pr = chunk.parsed_.emplace_back();
+          pr.id_ = std::make_pair(row.id_.val(), row.secondary_id_.val());
+          pr.passengers_ = row.passengers_.val();
+          pr.foot_ = row.leg_type_.val() == "FOOT";
+          if (pr.foot_) {
+            return;
+          }
+          pr.enter_ = row.enter_.val();
+          pr.exit_ = row.exit_.val();
+          pr.train_nr_ = row.train_nr_.val();
+          if (keep_strings) {
+            pr.from_ = row.from_.val().view();
+            pr.to_ = row.to_.val().view();
+            pr.category_ = row.category_.val().view();
+          }
+
+          auto& leg = pr.leg_;
+          leg.from_station_idx_ =
+              get_station_idx(sched, row.from_.val().view());
+          leg.to_station_idx_ = get_station_idx(sched, row.to_.val().view());
+          leg.enter_time_ = unix_to_motistime(sched.schedule_begin_, pr.enter_);
+          leg.exit_time_ = unix_to_motistime(sched.schedule_begin_, pr.exit_);
+          if (leg.stations_found() && leg.valid_times()) {
+            leg.trp_candidate_ = get_best_trip_candidate(
+                sched, deps, leg.from_station_idx_.value(),
+                leg.to_station_idx_.value(), leg.enter_time_, leg.exit_time_,
+                pr.train_nr_, match_tolerance);
+          }
+        });
+}
+
 loader_result load_journeys(schedule const& sched, universe& uv,
                             std::string const& journey_file,
                             std::string const& match_log_file,
-                            duration const match_tolerance) {
+                            duration const match_tolerance,
+                            csv_journey_options const& opt,
+                            csv_journey_stats* stats) {
   auto const debug_match_tolerance = match_tolerance + 60;
   auto result = loader_result{};
-  auto journeys_with_invalid_legs = 0ULL;
-  auto journeys_with_no_valid_legs = 0ULL;
-  auto journeys_with_inexact_matches = 0ULL;
-  auto journeys_with_missing_trips = 0ULL;
-  auto journeys_with_missing_transfers = 0ULL;
-  auto journeys_with_invalid_transfer_times = 0ULL;
-  auto journeys_too_long = 0ULL;
+  auto counters = csv_journey_stats{};
 
-  auto buf = utl::file(journey_file.data(), "r").content();
-  auto const file_content = utl::cstr{buf.data(), buf.size()};
+  if (fs::file_size(journey_file) == 0U) {
+    LOG(warn) << "empty journey file: " << journey_file;
+    return result;
+  }
+
+  auto const file =
+      cista::mmap{journey_file.data(), cista::mmap::protection::READ};
+  auto const file_content = std::string_view{
+      reinterpret_cast<char const*>(file.data()), file.size()};  // NOLINT
+  auto const header_end = file_content.find('\n');
+  auto const header = file_content.substr(
+      0, header_end == std::string_view::npos ? file_content.size()
+                                              : header_end + 1);
+  auto chunks =
+      split_into_chunks(file_content.substr(header.size()), opt.chunk_size_);
 
   std::ofstream match_log;
   if (!match_log_file.empty()) {
     match_log.open(match_log_file);
   }
 
+  auto const index = opt.use_departure_index_
+                         ? std::make_unique<departure_index>(sched)
+                         : std::unique_ptr<departure_index>{};
+  auto const* deps = index.get();
+
   auto current_id = std::optional<std::pair<std::uint32_t, std::uint32_t>>{};
   auto current_input_legs = std::vector<input_journey_leg>{};
   std::uint16_t current_passengers = 0;
@@ -365,7 +574,7 @@ loader_result load_journeys(schedule const& sched, universe& uv,
         [](auto const& leg) { return !leg.trp_candidate_.is_perfect_match(); });
     if (inexact_time) {
       source_flags |= group_source_flags::MATCH_INEXACT_TIME;
-      ++journeys_with_inexact_matches;
+      ++counters.journeys_with_inexact_matches_;
     }
     auto const all_trips_found =
         std::all_of(std::next(begin(current_input_legs), start_idx),
@@ -400,7 +609,7 @@ loader_result load_journeys(schedule const& sched, universe& uv,
       utl::verify(!current_journey.legs_.empty(), "empty csv journey");
       current_journey.legs_.front().enter_transfer_ = {};
       if (current_journey.scheduled_duration() > 24 * 60) {
-        ++journeys_too_long;
+        ++counters.journeys_too_long_;
         return;
       }
       uv.passenger_groups_.add(make_passenger_group(
@@ -408,13 +617,13 @@ loader_result load_journeys(schedule const& sched, universe& uv,
           current_journey.scheduled_arrival_time(), source_flags));
     } else {
       if (!all_trips_found) {
-        ++journeys_with_missing_trips;
+        ++counters.journeys_with_missing_trips_;
       }
       if (missing_transfer_infos) {
-        ++journeys_with_missing_transfers;
+        ++counters.journeys_with_missing_transfers_;
       }
       if (invalid_transfer_times) {
-        ++journeys_with_invalid_transfer_times;
+        ++counters.journeys_with_invalid_transfer_times_;
       }
       auto const& first_leg = current_input_legs.at(start_idx);
       auto const& last_leg = current_input_legs.at(end_idx - 1);
@@ -435,10 +644,10 @@ loader_result load_journeys(schedule const& sched, universe& uv,
                         return leg.stations_found() && leg.valid_times();
                       });
     if (possible_leg_count == 0) {
-      ++journeys_with_no_valid_legs;
+      ++counters.journeys_with_no_valid_legs_;
       return;
     } else if (possible_leg_count < current_input_legs.size()) {
-      ++journeys_with_invalid_legs;
+      ++counters.journeys_with_invalid_legs_;
       source_flags |= group_source_flags::MATCH_JOURNEY_SUBSET;
     }
 
@@ -453,54 +662,67 @@ loader_result load_journeys(schedule const& sched, universe& uv,
     add_journey(subset_start, current_input_legs.size(), source_flags);
   };
 
-  utl::line_range<utl::buf_reader>{file_content}  //
-      | utl::csv<row>()  //
-      |
-      utl::for_each([&](auto&& row) {
-        auto const id = std::make_pair(row.id_.val(), row.secondary_id_.val());
-        if (id != current_id) {
-          finish_journey();
-          current_id = id;
-          current_passengers = row.passengers_.val();
-          current_input_legs.clear();
-        }
-        if (row.leg_type_.val() == "FOOT") {
-          return;
-        }
-        auto& leg = current_input_legs.emplace_back();
-        leg.from_station_idx_ = get_station_idx(sched, row.from_.val().view());
-        leg.to_station_idx_ = get_station_idx(sched, row.to_.val().view());
-        leg.enter_time_ =
-            unix_to_motistime(sched.schedule_begin_, row.enter_.val());
-        leg.exit_time_ =
-            unix_to_motistime(sched.schedule_begin_, row.exit_.val());
-
-        if (leg.stations_found() && leg.valid_times()) {
-          leg.trp_candidate_ = get_best_trip_candidate(
-              sched, leg.from_station_idx_.value(), leg.to_station_idx_.value(),
-              leg.enter_time_, leg.exit_time_, row.train_nr_.val(),
-              match_tolerance);
-          set_transfer_info(sched, current_input_legs);
-        }
-        write_match_log(match_log, sched, leg, current_id, row,
-                        current_input_legs, debug_match_tolerance);
-      });
+  auto const add_row = [&](parsed_row const& row) {
+    if (row.id_ != current_id) {
+      finish_journey();
+      current_id = row.id_;
+      current_passengers = row.passengers_;
+      current_input_legs.clear();
+    }
+    if (row.foot_) {
+      return;
+    }
+    auto& leg = current_input_legs.emplace_back(row.leg_);
+    if (leg.stations_found() && leg.valid_times()) {
+      set_transfer_info(sched, current_input_legs);
+    }
+    write_match_log(match_log, sched, deps, leg, current_id, row,
+                    current_input_legs, debug_match_tolerance);
+  };
+
+  // parse + match chunks in parallel, merge them in file order
+  auto const batch_size =
+      std::max(std::size_t{1U},
+               static_cast<std::size_t>(std::thread::hardware_concurrency()));
+  for (auto batch_start = std::size_t{0U}; batch_start < chunks.size();
+       batch_start += batch_size) {
+    auto batch = std::vector<std::size_t>(
+        std::min(batch_size, chunks.size() - batch_start));
+    std::iota(begin(batch), end(batch), batch_start);
+    motis_parallel_for(batch, [&](std::size_t const chunk_idx) {
+      parse_chunk(sched, deps, header, chunks[chunk_idx], match_tolerance,
+                  match_log.is_open());
+    });
+    for (auto const chunk_idx : batch) {
+      for (auto const& row : chunks[chunk_idx].parsed_) {
+        add_row(row);
+      }
+      chunks[chunk_idx].parsed_ = {};
+    }
+  }
 
   finish_journey();
 
   LOG(info) << "loaded " << result.loaded_journeys_ << " journeys";
-  LOG(info) << journeys_with_invalid_legs << " journeys with some invalid legs";
-  LOG(info) << journeys_with_no_valid_legs << " journeys with no valid legs";
-  LOG(info) << journeys_with_inexact_matches
+  LOG(info) << counters.journeys_with_invalid_legs_
+            << " journeys with some invalid legs";
+  LOG(info) << counters.journeys_with_no_valid_legs_
+            << " journeys with no valid legs";
+  LOG(info) << counters.journeys_with_inexact_matches_
             << " journeys with inexact matches";
-  LOG(info) << journeys_with_missing_trips << " journeys with missing trips";
-  LOG(info) << journeys_with_missing_transfers
+  LOG(info) << counters.journeys_with_missing_trips_
+            << " journeys with missing trips";
+  LOG(info) << counters.journeys_with_missing_transfers_
             << " journeys with missing transfers";
-  LOG(info) << journeys_with_invalid_transfer_times
+  LOG(info) << counters.journeys_with_invalid_transfer_times_
             << " journeys with invalid transfer times";
-  LOG(info) << journeys_too_long << " journeys that are too long (skipped)";
+  LOG(info) << counters.journeys_too_long_
+            << " journeys that are too long (skipped)";
   LOG(info) << result.unmatched_journeys_.size() << " unmatched journeys";
 
+  if (stats != nullptr) {
+    *stats = counters;
+  }
   return result;
 }
 
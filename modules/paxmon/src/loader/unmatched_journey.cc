@@ -0,0 +1,34 @@
+#include "motis/paxmon/loader/unmatched_journey.h"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+namespace motis::paxmon::loader {
+
+std::vector<std::vector<std::size_t>> group_identical_queries(
+    std::vector<unmatched_journey> const& unmatched_journeys) {
+  auto const query_key = [&](std::size_t const i) {
+    auto const& uj = unmatched_journeys[i];
+    return std::tie(uj.start_station_idx_, uj.destination_station_idx_,
+                    uj.departure_time_);
+  };
+
+  std::vector<std::size_t> order(unmatched_journeys.size());
+  std::iota(begin(order), end(order), 0U);
+  std::stable_sort(begin(order), end(order),
+                   [&](std::size_t const a, std::size_t const b) {
+                     return query_key(a) < query_key(b);
+                   });
+
+  std::vector<std::vector<std::size_t>> queries;
+  for (auto const i : order) {
+    if (queries.empty() || query_key(queries.back().front()) != query_key(i)) {
+      queries.emplace_back();
+    }
+    queries.back().emplace_back(i);
+  }
+  return queries;
+}
+
+}  // namespace motis::paxmon::loader
@@ -105,10 +105,11 @@ data_source from_fbs(PaxMonDataSource const* ds) {
 Offset<PaxMonGroup> to_fbs(schedule const& sched, FlatBufferBuilder& fbb,
                            passenger_group const& pg) {
   return CreatePaxMonGroup(
-      fbb, pg.id_, to_fbs(fbb, pg.source_), pg.passengers_,
-      to_fbs(sched, fbb, pg.compact_planned_journey_), pg.probability_,
-      to_fbs_time(sched, pg.planned_arrival_time_),
-      static_cast<std::underlying_type_t<group_source_flags>>(pg.source_flags_),
+      fbb, pg.id_, to_fbs(fbb, pg.source_), pg.passengers(),
+      to_fbs(sched, fbb, pg.compact_planned_journey_), pg.probability(),
+      to_fbs_time(sched, pg.planned_arrival_time()),
+      static_cast<std::underlying_type_t<group_source_flags>>(
+          pg.source_flags()),
       pg.generation_, pg.previous_version_, to_fbs_time(sched, pg.added_time_),
       pg.estimated_delay());
 }
@@ -125,7 +126,7 @@ passenger_group from_fbs(schedule const& sched, PaxMonGroup const* pg) {
 
 PaxMonGroupBaseInfo to_fbs_base_info(FlatBufferBuilder& /*fbb*/,
                                      passenger_group const& pg) {
-  return PaxMonGroupBaseInfo{pg.id_, pg.passengers_, pg.probability_};
+  return PaxMonGroupBaseInfo{pg.id_, pg.passengers(), pg.probability()};
 }
 
 Offset<void> to_fbs(schedule const& sched, FlatBufferBuilder& fbb,
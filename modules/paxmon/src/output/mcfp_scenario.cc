@@ -117,7 +117,8 @@ void write_groups(fs::path const& dir, schedule const& sched,
           << sched.stations_
                  .at(pg->compact_planned_journey_.destination_station_id())
                  ->eva_nr_.view()
-          << "," << pg->planned_arrival_time_ << "," << pg->passengers_ << ",";
+          << "," << pg->planned_arrival_time() << "," << pg->passengers()
+          << ",";
       if (loc.in_trip()) {
         out << trip_ids.at(loc.in_trip_);
       }
@@ -1,14 +1,15 @@
 #include "motis/paxmon/paxmon.h"
 
+#include <algorithm>
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "boost/filesystem.hpp"
 
 #include "fmt/format.h"
 
-#include "utl/to_vec.h"
 #include "utl/verify.h"
-#include "utl/zip.h"
 
 #include "motis/core/common/date_time_util.h"
 #include "motis/core/common/logging.h"
@@ -44,6 +45,7 @@
 #include "motis/paxmon/load_info.h"
 #include "motis/paxmon/loader/csv/csv_journeys.h"
 #include "motis/paxmon/loader/journeys/motis_journeys.h"
+#include "motis/paxmon/loader/unmatched_journey.h"
 #include "motis/paxmon/messages.h"
 #include "motis/paxmon/output/journey_converter.h"
 #include "motis/paxmon/output/mcfp_scenario.h"
@@ -52,6 +54,7 @@
 #include "motis/paxmon/rt_updates.h"
 #include "motis/paxmon/service_info.h"
 #include "motis/paxmon/tools/commands.h"
+#include "motis/paxmon/universe_snapshot.h"
 
 namespace fs = boost::filesystem;
 
@@ -78,6 +81,8 @@ paxmon::paxmon() : module("Passenger Monitoring", "paxmon"), data_{*this} {
         "output file for initial rerouted journeys");
   param(initial_reroute_router_, "reroute_router",
         "router for initial reroute queries");
+  param(initial_reroute_max_parallel_, "reroute_max_parallel",
+        "max. number of parallel initial reroute queries");
   param(start_time_, "start_time", "evaluation start time");
   param(end_time_, "end_time", "evaluation end time");
   param(time_step_, "time_step", "evaluation time step (seconds)");
@@ -103,6 +108,9 @@ paxmon::paxmon() : module("Passenger Monitoring", "paxmon"), data_{*this} {
   param(reuse_groups_, "reuse_groups",
         "update probability of existing groups instead of adding new groups "
         "when possible");
+  param(universe_snapshot_, "universe_snapshot",
+        "write a snapshot of the initial universe after loading the journeys "
+        "and load it on restart if schedule and input files are unchanged");
 }
 
 paxmon::~paxmon() = default;
@@ -111,6 +119,9 @@ void paxmon::reg_subc(motis::module::subc_reg& r) {
   r.register_cmd("paxmon_convert", "convert journeys to csv", tools::convert);
   r.register_cmd("paxmon_generate", "generate journeys", tools::generate);
   r.register_cmd("paxmon_groups", "generate groups", tools::gen_groups);
+  r.register_cmd("paxmon_bench_groups",
+                 "benchmark passenger group storage and load checks",
+                 tools::bench_groups);
 }
 
 void paxmon::import(motis::module::import_dispatcher& reg) {
@@ -417,6 +428,83 @@ msg_ptr initial_reroute_query(schedule const& sched,
   return make_msg(fbb);
 }
 
+// Unmatched journeys with the same start, destination and departure time
+// result in the same query, which is only sent once. A window of at most
+// max_parallel queries is kept in flight: whenever the oldest query has been
+// answered and its replacement journeys are added, the next query is sent.
+void reroute_unmatched_journeys(
+    schedule const& sched, universe& uv,
+    std::vector<loader::unmatched_journey> const& unmatched_journeys,
+    std::string const& router, unsigned const max_parallel,
+    output::journey_converter* converter) {
+  auto const queries = loader::group_identical_queries(unmatched_journeys);
+
+  LOG(info) << "routing " << unmatched_journeys.size()
+            << " unmatched journeys using " << router << ": "
+            << queries.size() << " distinct queries ("
+            << (unmatched_journeys.size() - queries.size())
+            << " requests saved)...";
+
+  auto const window_size = static_cast<std::size_t>(std::max(max_parallel, 1U));
+  auto const progress_step = std::max(queries.size() / 20, window_size);
+  auto in_flight = std::deque<future>{};
+  auto next_query = std::size_t{0};
+  auto const send_next = [&]() {
+    in_flight.emplace_back(motis_call(initial_reroute_query(
+        sched, unmatched_journeys[queries[next_query].front()], router)));
+    ++next_query;
+  };
+
+  while (next_query < queries.size() && in_flight.size() < window_size) {
+    send_next();
+  }
+
+  auto rerouted = 0ULL;
+  for (auto q = std::size_t{0}; q < queries.size(); ++q) {
+    auto const rr_msg = in_flight.front()->val();
+    in_flight.pop_front();
+    if (next_query < queries.size()) {
+      send_next();
+    }
+
+    auto const rr = motis_content(RoutingResponse, rr_msg);
+    auto const journeys = message_to_journeys(rr);
+    if (!journeys.empty()) {
+      // TODO(pablo): select journey(s)
+      for (auto const i : queries[q]) {
+        auto const& uj = unmatched_journeys[i];
+        if (converter != nullptr) {
+          converter->write_journey(journeys.front(), uj.source_.primary_ref_,
+                                   uj.source_.secondary_ref_, uj.passengers_);
+        }
+        loader::journeys::load_journey(sched, uv, journeys.front(),
+                                       uj.source_, uj.passengers_,
+                                       group_source_flags::MATCH_REROUTED);
+        ++rerouted;
+      }
+    }
+
+    if ((q + 1) % progress_step == 0 || q + 1 == queries.size()) {
+      LOG(info) << "reroute queries: " << (q + 1) << "/" << queries.size()
+                << ", " << rerouted << " replacement journeys added";
+    }
+  }
+}
+
+cista::hash_t paxmon::universe_snapshot_input_hash() const {
+  auto h = cista::BASE_HASH;
+  for (auto const& files : {journey_files_, capacity_files_}) {
+    for (auto const& file : files) {
+      h = cista::hash_combine(
+          h, cista::hash(file), fs::file_size(file),
+          static_cast<std::int64_t>(fs::last_write_time(file)));
+    }
+    h = cista::hash_combine(h, files.size());
+  }
+  return cista::hash_combine(h, match_tolerance_, reroute_unmatched_,
+                             cista::hash(initial_reroute_router_));
+}
+
 void paxmon::load_journeys() {
   auto const& sched = get_sched();
   auto& uv = primary_universe();
@@ -430,7 +518,16 @@ void paxmon::load_journeys() {
     return;
   }
 
-  {
+  auto const snapshot_dir = get_data_directory() / "paxmon";
+  auto const snapshot_file = (snapshot_dir / "universe.bin").generic_string();
+  auto const snapshot_input_hash =
+      universe_snapshot_ ? universe_snapshot_input_hash() : cista::hash_t{};
+  if (universe_snapshot_ && read_universe_snapshot(uv, snapshot_file,
+                                                   sched.hash_,
+                                                   snapshot_input_hash)) {
+    LOG(info) << "paxmon: loaded initial universe from snapshot "
+              << snapshot_file;
+  } else {
     std::unique_ptr<output::journey_converter> converter;
     if (reroute_unmatched_ && !initial_reroute_query_file_.empty()) {
       converter = std::make_unique<output::journey_converter>(
@@ -440,40 +537,23 @@ void paxmon::load_journeys() {
       auto const result = load_journeys(file);
       if (reroute_unmatched_) {
         scoped_timer timer{"reroute unmatched journeys"};
-        LOG(info) << "routing " << result.unmatched_journeys_.size()
-                  << " unmatched journeys using " << initial_reroute_router_
-                  << "...";
-        auto const futures =
-            utl::to_vec(result.unmatched_journeys_, [&](auto const& uj) {
-              return motis_call(
-                  initial_reroute_query(sched, uj, initial_reroute_router_));
-            });
-        ctx::await_all(futures);
-        LOG(info) << "adding replacement journeys...";
-        for (auto const& [uj, fut] :
-             utl::zip(result.unmatched_journeys_, futures)) {
-          auto const rr_msg = fut->val();
-          auto const rr = motis_content(RoutingResponse, rr_msg);
-          auto const journeys = message_to_journeys(rr);
-          if (journeys.empty()) {
-            continue;
-          }
-          // TODO(pablo): select journey(s)
-          if (converter) {
-            converter->write_journey(journeys.front(), uj.source_.primary_ref_,
-                                     uj.source_.secondary_ref_, uj.passengers_);
-          }
-          loader::journeys::load_journey(sched, uv, journeys.front(),
-                                         uj.source_, uj.passengers_,
-                                         group_source_flags::MATCH_REROUTED);
-        }
+        reroute_unmatched_journeys(sched, uv, result.unmatched_journeys_,
+                                   initial_reroute_router_,
+                                   initial_reroute_max_parallel_,
+                                   converter.get());
       }
       progress_tracker->increment();
     }
-  }
 
-  progress_tracker->status("Build Graph").out_bounds(60.F, 100.F);
-  build_graph_from_journeys(sched, data_.capacity_maps_, uv);
+    progress_tracker->status("Build Graph").out_bounds(60.F, 100.F);
+    build_graph_from_journeys(sched, data_.capacity_maps_, uv);
+
+    if (universe_snapshot_) {
+      fs::create_directories(snapshot_dir);
+      write_universe_snapshot(uv, snapshot_file, sched.hash_,
+                              snapshot_input_hash);
+    }
+  }
 
   auto const graph_stats = calc_graph_statistics(sched, uv);
   print_graph_stats(graph_stats);
@@ -618,7 +698,7 @@ void paxmon::rt_updates_applied(universe& uv, schedule const& sched) {
             << uv.system_stats_.groups_broken_count_ << " broken";
 
   for (auto const& pg : uv.passenger_groups_) {
-    if (pg == nullptr || !pg->valid()) {
+    if (pg == nullptr || !uv.passenger_groups_.valid(pg->id_)) {
       continue;
     }
     if (pg->ok_) {
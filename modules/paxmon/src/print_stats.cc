@@ -40,6 +40,12 @@ void print_allocator_stats(universe const& uv) {
       static_cast<double>(allocator.bytes_allocated()) / (1024.0 * 1024.0),
       allocator.free_list_size(), allocator.allocation_count(),
       allocator.release_count());
+  LOG(info) << fmt::format(
+      "passenger group columns: {:.2f} MiB, edges: {:.2f} MiB",
+      static_cast<double>(uv.passenger_groups_.columns_.allocated_size()) /
+          (1024.0 * 1024.0),
+      static_cast<double>(uv.passenger_groups_.edges_.allocated_size()) /
+          (1024.0 * 1024.0));
   LOG(info) << uv.pax_connection_info_.size() << " pax connection infos";
 }
 
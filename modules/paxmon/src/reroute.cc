@@ -6,7 +6,6 @@
 #include <set>
 
 #include "utl/enumerate.h"
-#include "utl/erase.h"
 #include "utl/pairwise.h"
 #include "utl/to_vec.h"
 #include "utl/verify.h"
@@ -199,9 +198,10 @@ std::set<passenger_group*> collect_passenger_groups(universe& uv,
     for (auto pg_id : groups) {
       auto* pg = uv.passenger_groups_[pg_id];
       affected_passenger_groups.insert(pg);
-      utl::erase(pg->edges_, tei);
+      uv.passenger_groups_.remove_edge(pg_id, tei);
     }
     groups.clear();
+    uv.pax_connection_info_.invalidate_load(te->pci_);
   }
   return affected_passenger_groups;
 }
@@ -234,7 +234,7 @@ bool update_passenger_group(trip_data_index const tdi, trip const* trp,
           auto const& ei = edges[idx];
           auto* e = ei.get(uv);
           add_passenger_group_to_edge(uv, e, pg);
-          pg->edges_.emplace_back(ei);
+          uv.passenger_groups_.add_edge(pg->id_, ei);
         }
         return true;
       }
@@ -1,12 +1,21 @@
 #include "motis/paxmon/rt_updates.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <set>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "utl/concat.h"
 #include "utl/verify.h"
 
 #include "motis/core/common/logging.h"
 #include "motis/core/common/timing.h"
+#include "motis/core/conv/trip_conv.h"
 #include "motis/module/context/motis_parallel_for.h"
 
 #include "motis/paxmon/checks.h"
@@ -24,72 +33,223 @@ using namespace motis::module;
 
 namespace motis::paxmon {
 
+namespace {
+
+std::size_t get_max_tasks(rt_update_options const& opt) {
+  return opt.max_tasks_ != 0U
+             ? opt.max_tasks_
+             : std::max(1U, std::thread::hardware_concurrency());
+}
+
+// Groups are collected per task and merged serially afterwards (a group can
+// be collected by several tasks).
+struct interchange_check_task {
+  std::vector<passenger_group_index> affected_groups_;
+  std::vector<passenger_group_index> broken_groups_;
+  std::vector<edge*> newly_broken_;
+};
+
+void check_interchange(universe& uv, edge* ice, int arrival_delay_threshold,
+                       interchange_check_task& task) {
+  if (ice->type_ != edge_type::INTERCHANGE) {
+    return;
+  }
+  auto const from = ice->from(uv);
+  auto const to = ice->to(uv);
+  auto const ic = static_cast<int>(to->time_) - static_cast<int>(from->time_);
+  if (ice->is_canceled(uv) || (from->station_ != 0 && to->station_ != 0 &&
+                               ic < ice->transfer_time())) {
+    if (ice->broken_) {
+      return;
+    }
+    ice->broken_ = true;
+    task.newly_broken_.emplace_back(ice);
+    for (auto pg_id : uv.pax_connection_info_.groups_[ice->pci_]) {
+      task.broken_groups_.emplace_back(pg_id);
+      task.affected_groups_.emplace_back(pg_id);
+    }
+  } else if (ice->broken_) {
+    // interchange valid again
+    ice->broken_ = false;
+    for (auto pg_id : uv.pax_connection_info_.groups_[ice->pci_]) {
+      task.affected_groups_.emplace_back(pg_id);
+    }
+  } else if (arrival_delay_threshold >= 0 && to->station_ == 0) {
+    // check for delayed arrival at destination
+    auto const estimated_arrival = static_cast<int>(from->schedule_time());
+    for (auto pg_id : uv.pax_connection_info_.groups_[ice->pci_]) {
+      auto* grp = uv.passenger_groups_[pg_id];
+      auto const estimated_delay =
+          estimated_arrival - static_cast<int>(grp->planned_arrival_time());
+      if (grp->planned_arrival_time() != INVALID_TIME &&
+          estimated_delay >= arrival_delay_threshold) {
+        task.affected_groups_.emplace_back(pg_id);
+      }
+    }
+  }
+}
+
+bool has_merged_edges(schedule const& sched, universe& uv,
+                      trip_data_index const tdi) {
+  auto const trip_edges = uv.trip_data_.edges(tdi);
+  return std::any_of(begin(trip_edges), end(trip_edges),
+                     [&](edge_index const& ei) {
+                       return sched.merged_trips_.at(ei.get(uv)->trips_)
+                                  ->size() > 1;
+                     });
+}
+
+struct delay_update_task {
+  std::vector<RtDelayUpdate const*> updates_;
+  std::vector<edge_index> updated_interchange_edges_;
+  system_statistics stats_;
+};
+
+// Delay updates only change the event times of their trip: updates are
+// grouped by trip and the groups are applied in parallel. The updates of
+// one trip (and of all trips sharing edges with other trips) are applied
+// in order by a single task.
+void apply_delay_updates(schedule const& sched, universe& uv,
+                         std::vector<RtDelayUpdate const*>& updates,
+                         std::vector<edge_index>& updated_interchange_edges,
+                         rt_update_options const& opt) {
+  if (updates.empty()) {
+    return;
+  }
+
+  auto tasks = std::vector<delay_update_task>{};
+  auto task_by_trip = std::map<trip_data_index, std::size_t>{};
+  for (auto const* du : updates) {
+    auto const tdi =
+        uv.trip_data_.find_index(from_fbs(sched, du->trip())->trip_idx_);
+    if (tdi == INVALID_TRIP_DATA_INDEX) {
+      continue;
+    }
+    auto const key =
+        has_merged_edges(sched, uv, tdi) ? INVALID_TRIP_DATA_INDEX : tdi;
+    auto const [it, inserted] = task_by_trip.emplace(key, tasks.size());
+    if (inserted) {
+      tasks.emplace_back();
+    }
+    tasks[it->second].updates_.emplace_back(du);
+  }
+  updates.clear();
+
+  auto const apply_task = [&](std::size_t const task_idx) {
+    auto& task = tasks[task_idx];
+    for (auto const* du : task.updates_) {
+      update_event_times(sched, uv, du, task.updated_interchange_edges_,
+                         task.stats_);
+    }
+  };
+  if (tasks.size() == 1U || get_max_tasks(opt) == 1U) {
+    for (auto task_idx = 0U; task_idx < tasks.size(); ++task_idx) {
+      apply_task(task_idx);
+    }
+  } else {
+    auto task_indices = std::vector<std::size_t>(tasks.size());
+    std::iota(begin(task_indices), end(task_indices), 0U);
+    motis_parallel_for(task_indices, apply_task);
+  }
+
+  for (auto const& task : tasks) {
+    utl::concat(updated_interchange_edges, task.updated_interchange_edges_);
+    auto& stats = uv.system_stats_;
+    stats.update_event_times_trip_edges_found_ +=
+        task.stats_.update_event_times_trip_edges_found_;
+    stats.update_event_times_dep_updated_ +=
+        task.stats_.update_event_times_dep_updated_;
+    stats.update_event_times_arr_updated_ +=
+        task.stats_.update_event_times_arr_updated_;
+    stats.total_updated_interchange_edges_ +=
+        task.stats_.total_updated_interchange_edges_;
+  }
+}
+
+}  // namespace
+
 void check_broken_interchanges(
-    universe& uv, std::vector<edge_index> const& updated_interchange_edges,
-    int arrival_delay_threshold) {
+    universe& uv, std::vector<edge_index>& updated_interchange_edges,
+    int arrival_delay_threshold, rt_update_options const& opt) {
   static std::set<edge*> broken_interchanges;
   static std::set<passenger_group*> affected_passenger_groups;
-  for (auto& icei : updated_interchange_edges) {
-    auto* ice = icei.get(uv);
-    if (ice->type_ != edge_type::INTERCHANGE) {
-      continue;
+
+  // Each edge only needs to be checked once (and by only one task). This
+  // does not change the result: a repeated check of an edge that was just
+  // marked as broken does nothing, a repeated check of an edge that is
+  // valid again (or the destination delay check of such an edge) only
+  // collects groups of the same pci that were already collected.
+  std::sort(begin(updated_interchange_edges), end(updated_interchange_edges));
+  updated_interchange_edges.erase(std::unique(begin(updated_interchange_edges),
+                                              end(updated_interchange_edges)),
+                                  end(updated_interchange_edges));
+
+  auto const edge_count = updated_interchange_edges.size();
+  if (edge_count == 0) {
+    return;
+  }
+  auto const min_edges_per_task =
+      std::max(std::size_t{1U}, opt.min_edges_per_task_);
+  auto const task_count =
+      std::max(std::size_t{1U}, std::min(get_max_tasks(opt),
+                                         edge_count / min_edges_per_task));
+  auto tasks = std::vector<interchange_check_task>(task_count);
+  auto const check_task = [&](std::size_t const task_idx) {
+    auto const first = edge_count * task_idx / task_count;
+    auto const last = edge_count * (task_idx + 1) / task_count;
+    for (auto i = first; i < last; ++i) {
+      check_interchange(uv, updated_interchange_edges[i].get(uv),
+                        arrival_delay_threshold, tasks[task_idx]);
     }
-    auto const from = ice->from(uv);
-    auto const to = ice->to(uv);
-    auto const ic = static_cast<int>(to->time_) - static_cast<int>(from->time_);
-    if (ice->is_canceled(uv) || (from->station_ != 0 && to->station_ != 0 &&
-                                 ic < ice->transfer_time())) {
-      if (ice->broken_) {
-        continue;
-      }
-      ice->broken_ = true;
+  };
+  if (task_count == 1U) {
+    check_task(0U);
+  } else {
+    auto task_indices = std::vector<std::size_t>(task_count);
+    std::iota(begin(task_indices), end(task_indices), 0U);
+    motis_parallel_for(task_indices, check_task);
+  }
+
+  auto& affected = uv.rt_update_ctx_.groups_affected_by_last_update_;
+  for (auto const& task : tasks) {
+    for (auto* ice : task.newly_broken_) {
       if (broken_interchanges.insert(ice).second) {
         ++uv.system_stats_.total_broken_interchanges_;
       }
-      for (auto pg_id : uv.pax_connection_info_.groups_[ice->pci_]) {
-        auto* grp = uv.passenger_groups_[pg_id];
-        if (affected_passenger_groups.insert(grp).second) {
-          uv.system_stats_.total_affected_passengers_ += grp->passengers_;
-          grp->ok_ = false;
-        }
-        uv.rt_update_ctx_.groups_affected_by_last_update_.insert(grp->id_);
-      }
-    } else if (ice->broken_) {
-      // interchange valid again
-      ice->broken_ = false;
-      for (auto pg_id : uv.pax_connection_info_.groups_[ice->pci_]) {
-        auto* grp = uv.passenger_groups_[pg_id];
-        uv.rt_update_ctx_.groups_affected_by_last_update_.insert(grp->id_);
-      }
-    } else if (arrival_delay_threshold >= 0 && to->station_ == 0) {
-      // check for delayed arrival at destination
-      auto const estimated_arrival = static_cast<int>(from->schedule_time());
-      for (auto pg_id : uv.pax_connection_info_.groups_[ice->pci_]) {
-        auto* grp = uv.passenger_groups_[pg_id];
-        auto const estimated_delay =
-            estimated_arrival - static_cast<int>(grp->planned_arrival_time_);
-        if (grp->planned_arrival_time_ != INVALID_TIME &&
-            estimated_delay >= arrival_delay_threshold) {
-          uv.rt_update_ctx_.groups_affected_by_last_update_.insert(grp->id_);
-        }
+    }
+    for (auto const pgi : task.broken_groups_) {
+      auto* grp = uv.passenger_groups_[pgi];
+      if (affected_passenger_groups.insert(grp).second) {
+        uv.system_stats_.total_affected_passengers_ += grp->passengers();
+        grp->ok_ = false;
       }
     }
+    affected.insert(begin(task.affected_groups_), end(task.affected_groups_));
   }
 }
 
 void handle_rt_update(universe& uv, capacity_maps const& caps,
                       schedule const& sched, RtUpdates const* update,
-                      int arrival_delay_threshold) {
+                      int arrival_delay_threshold,
+                      rt_update_options const& opt) {
   uv.tick_stats_.rt_updates_ += update->updates()->size();
 
+  MOTIS_START_TIMING(graph_update);
   std::vector<edge_index> updated_interchange_edges;
+  std::vector<RtDelayUpdate const*> delay_updates;
   for (auto const& u : *update->updates()) {
+    if (u->content_type() != Content_RtDelayUpdate) {
+      // reroute and track updates change the graph structure: apply the
+      // delay updates received before them first
+      apply_delay_updates(sched, uv, delay_updates, updated_interchange_edges,
+                          opt);
+    }
     switch (u->content_type()) {
       case Content_RtDelayUpdate: {
         ++uv.system_stats_.delay_updates_;
         ++uv.tick_stats_.rt_delay_updates_;
         auto const du = reinterpret_cast<RtDelayUpdate const*>(u->content());
-        update_event_times(sched, uv, du, updated_interchange_edges);
+        delay_updates.emplace_back(du);
         uv.tick_stats_.rt_delay_event_updates_ += du->events()->size();
         for (auto const& uei : *du->events()) {
           switch (uei->reason()) {
@@ -132,8 +292,17 @@ void handle_rt_update(universe& uv, capacity_maps const& caps,
       default: break;
     }
   }
+  apply_delay_updates(sched, uv, delay_updates, updated_interchange_edges, opt);
+  MOTIS_STOP_TIMING(graph_update);
+  uv.tick_stats_.t_rt_graph_update_ +=
+      static_cast<std::uint64_t>(MOTIS_TIMING_MS(graph_update));
+
+  MOTIS_START_TIMING(broken_interchanges);
   check_broken_interchanges(uv, updated_interchange_edges,
-                            arrival_delay_threshold);
+                            arrival_delay_threshold, opt);
+  MOTIS_STOP_TIMING(broken_interchanges);
+  uv.tick_stats_.t_broken_interchanges_ +=
+      static_cast<std::uint64_t>(MOTIS_TIMING_MS(broken_interchanges));
 }
 
 monitoring_event_type get_monitoring_event_type(
@@ -142,7 +311,7 @@ monitoring_event_type get_monitoring_event_type(
   if (!reachability.ok_) {
     return monitoring_event_type::TRANSFER_BROKEN;
   } else if (arrival_delay_threshold >= 0 &&
-             pg->planned_arrival_time_ != INVALID_TIME &&
+             pg->planned_arrival_time() != INVALID_TIME &&
              pg->estimated_delay() >= arrival_delay_threshold) {
     return monitoring_event_type::MAJOR_DELAY_EXPECTED;
   } else {
@@ -168,7 +337,7 @@ std::vector<msg_ptr> update_affected_groups(universe& uv, schedule const& sched,
       std::accumulate(begin(uv.rt_update_ctx_.groups_affected_by_last_update_),
                       end(uv.rt_update_ctx_.groups_affected_by_last_update_),
                       0ULL, [&](auto const sum, auto const pgi) {
-                        return sum + uv.passenger_groups_.at(pgi)->passengers_;
+                        return sum + uv.passenger_groups_.at(pgi)->passengers();
                       });
 
   uv.tick_stats_.affected_groups_ =
@@ -180,6 +349,12 @@ std::vector<msg_ptr> update_affected_groups(universe& uv, schedule const& sched,
   std::vector<msg_ptr> messages;
 
   std::mutex update_mutex;
+  // new group edges are collected and stored after the parallel loop, the
+  // group edge pool must not be modified while update_load reads it
+  auto new_group_edges =
+      std::vector<std::pair<passenger_group_index, std::vector<edge_index>>>{};
+  new_group_edges.reserve(
+      uv.rt_update_ctx_.groups_affected_by_last_update_.size());
   auto total_reachability = 0ULL;
   auto total_localization = 0ULL;
   auto total_update_load = 0ULL;
@@ -218,10 +393,12 @@ std::vector<msg_ptr> update_affected_groups(universe& uv, schedule const& sched,
             get_reachability(uv, pg->compact_planned_journey_);
         pg->ok_ = reachability.ok_;
         if (reachability.ok_) {
-          pg->estimated_delay_ = static_cast<std::int16_t>(
-              static_cast<int>(
-                  reachability.reachable_trips_.back().exit_real_time_) -
-              static_cast<int>(pg->planned_arrival_time_));
+          auto const arrival =
+              reachability.reachable_trips_.back().exit_real_time_;
+          uv.passenger_groups_.set_estimated_delay(
+              pg, static_cast<std::int16_t>(
+                      static_cast<int>(arrival) -
+                      static_cast<int>(pg->planned_arrival_time())));
         }
         MOTIS_STOP_TIMING(reachability);
 
@@ -237,11 +414,12 @@ std::vector<msg_ptr> update_affected_groups(universe& uv, schedule const& sched,
                 : reachability.reachable_trips_.back().exit_real_time_;
 
         MOTIS_START_TIMING(update_load);
-        update_load(pg, reachability, localization, uv);
+        auto edges = update_load(pg, reachability, localization, uv);
         MOTIS_STOP_TIMING(update_load);
 
         MOTIS_START_TIMING(fbs_events);
         std::lock_guard guard{update_mutex};
+        new_group_edges.emplace_back(pgi, std::move(edges));
         fbs_events.emplace_back(to_fbs(
             sched, mc,
             monitoring_event{event_type, *pg, localization,
@@ -268,16 +446,20 @@ std::vector<msg_ptr> update_affected_groups(universe& uv, schedule const& sched,
           case monitoring_event_type::TRANSFER_BROKEN:
             ++uv.tick_stats_.broken_groups_;
             ++uv.system_stats_.groups_broken_count_;
-            uv.tick_stats_.broken_passengers_ += pg->passengers_;
+            uv.tick_stats_.broken_passengers_ += pg->passengers();
             break;
           case monitoring_event_type::MAJOR_DELAY_EXPECTED:
             ++uv.tick_stats_.major_delay_groups_;
             ++uv.system_stats_.groups_major_delay_count_;
-            uv.tick_stats_.major_delay_passengers_ += pg->passengers_;
+            uv.tick_stats_.major_delay_passengers_ += pg->passengers();
             break;
         }
       });
 
+  for (auto const& [pgi, edges] : new_group_edges) {
+    uv.passenger_groups_.set_edges(pgi, edges);
+  }
+
   print_timing();
   make_monitoring_msg();
 
@@ -58,7 +58,7 @@ graph_statistics calc_graph_statistics(schedule const& sched,
     if (pg == nullptr) {
       continue;
     }
-    stats.passengers_ += pg->passengers_;
+    stats.passengers_ += pg->passengers();
     if (!pg->ok_) {
       ++stats.broken_passenger_groups_;
     }
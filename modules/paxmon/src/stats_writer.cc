@@ -45,6 +45,8 @@ void stats_writer::write_header() {
        << "t_fbs_events"
        << "t_publish"
        << "t_rt_updates_applied_total"
+       << "t_rt_graph_update"
+       << "t_broken_interchanges"
        //
        << end_row;
 }
@@ -73,7 +75,8 @@ void stats_writer::write_tick(const tick_statistics& ts) {
        //
        << ts.t_reachability_ << ts.t_localization_ << ts.t_update_load_
        << ts.t_fbs_events_ << ts.t_publish_
-       << ts.t_rt_updates_applied_total_
+       << ts.t_rt_updates_applied_total_ << ts.t_rt_graph_update_
+       << ts.t_broken_interchanges_
        //
        << end_row;
 }
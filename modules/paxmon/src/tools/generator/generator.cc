@@ -211,8 +211,9 @@ private:
         std::move(cj), data_source{primary_id, secondary_id}, group_size,
         cj.scheduled_arrival_time()));
     add_passenger_group_to_graph(sched_, caps_, uv_, *pg);
+    auto const pg_edges = uv_.passenger_groups_.edges(pg->id_);
     auto const over_capacity =
-        std::any_of(begin(pg->edges_), end(pg->edges_), [&](auto const& ei) {
+        std::any_of(begin(pg_edges), end(pg_edges), [&](auto const& ei) {
           auto const* e = ei.get(uv_);
           return e->has_capacity() &&
                  get_base_load(uv_.passenger_groups_,
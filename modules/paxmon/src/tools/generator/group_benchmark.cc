@@ -0,0 +1,281 @@
+#include "motis/paxmon/tools/commands.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "conf/configuration.h"
+#include "conf/options_parser.h"
+
+#include "motis/core/common/timing.h"
+
+#include "motis/paxmon/get_load.h"
+#include "motis/paxmon/passenger_group.h"
+#include "motis/paxmon/passenger_group_container.h"
+#include "motis/paxmon/pci_container.h"
+#include "motis/paxmon/universe.h"
+
+#include "motis/paxmon/tools/groups/group_generator.h"
+
+using namespace motis::paxmon;
+using namespace motis::paxmon::tools::groups;
+
+namespace motis::paxmon::tools {
+
+struct group_benchmark_settings : public conf::configuration {
+  group_benchmark_settings() : configuration{"Group Benchmark Settings"} {
+    param(group_count_, "groups", "Number of passenger groups");
+    param(pci_count_, "pcis", "Number of pax connection infos (edges)");
+    param(edges_per_group_, "edges_per_group", "Edges per passenger group");
+    param(legs_per_group_, "legs_per_group", "Journey legs per group");
+    param(delayed_share_, "delayed", "Share of delayed groups");
+    param(forecast_share_, "forecast", "Share of forecast groups");
+    param(iterations_, "iterations", "Iterations per measurement");
+    param(seed_, "seed", "Random seed");
+  }
+
+  unsigned group_count_{1'000'000};
+  unsigned pci_count_{100'000};
+  unsigned edges_per_group_{8};
+  unsigned legs_per_group_{2};
+  double delayed_share_{0.1};
+  double forecast_share_{0.2};
+  unsigned iterations_{5};
+  unsigned seed_{42};
+};
+
+namespace {
+
+// Groups with random sizes, probabilities and flags, each on
+// edges_per_group random pcis (the edge indices are only used as pool
+// entries, there is no graph).
+void generate_universe(group_benchmark_settings const& opt,
+                       passenger_group_container& pgc, pci_container& pcis) {
+  auto rng = std::mt19937{opt.seed_};
+  auto group_gen = group_generator{1.5, 3.0, 2.0, 10.0};
+  group_gen.rng_.seed(opt.seed_);
+  auto pci_dist = std::uniform_int_distribution<pci_index>{
+      0, static_cast<pci_index>(opt.pci_count_ - 1)};
+  auto share_dist = std::uniform_real_distribution<double>{0.0, 1.0};
+  auto delay_dist = std::uniform_int_distribution<std::int16_t>{1, 60};
+
+  for (auto i = 0U; i < opt.pci_count_; ++i) {
+    pcis.insert();
+  }
+
+  pgc.reserve(opt.group_count_);
+  for (auto i = 0U; i < opt.group_count_; ++i) {
+    auto cj = compact_journey{};
+    cj.legs_.resize(opt.legs_per_group_);
+    auto const forecast = share_dist(rng) < opt.forecast_share_;
+    auto* pg = pgc.add(make_passenger_group(
+        std::move(cj), data_source{i, 0U}, group_gen.get_group_size(), 600U,
+        forecast ? group_source_flags::FORECAST : group_source_flags::NONE,
+        forecast ? 0.5F : 1.0F));
+    if (share_dist(rng) < opt.delayed_share_) {
+      pgc.set_estimated_delay(pg, delay_dist(rng));
+    }
+    for (auto e = 0U; e < opt.edges_per_group_; ++e) {
+      auto const pci = pci_dist(rng);
+      pcis.groups_[pci].emplace_back(pg->id_);
+      pgc.add_edge(pg->id_, edge_index{pci, e});
+    }
+  }
+}
+
+template <typename Fn>
+double measure(unsigned const iterations, std::uint64_t& checksum, Fn&& fn) {
+  MOTIS_START_TIMING(total);
+  for (auto i = 0U; i < iterations; ++i) {
+    checksum += fn();
+  }
+  MOTIS_STOP_TIMING(total);
+  return static_cast<double>(MOTIS_TIMING_US(total)) / 1000.0 / iterations;
+}
+
+double to_mib(std::size_t const bytes) {
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+}  // namespace
+
+int bench_groups(int argc, char const** argv) {
+  group_benchmark_settings opt;
+
+  try {
+    conf::options_parser parser{{&opt}};
+    parser.read_command_line_args(argc, argv, false);
+
+    if (parser.help()) {
+      parser.print_help(std::cout);
+      return 0;
+    }
+    parser.print_used(std::cout);
+  } catch (std::exception const& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  if (opt.group_count_ == 0 || opt.pci_count_ == 0 || opt.iterations_ == 0) {
+    std::cerr << "groups, pcis and iterations must be > 0\n";
+    return 1;
+  }
+
+  auto uv = universe{};
+  auto& pgc = uv.passenger_groups_;
+  auto& pcis = uv.pax_connection_info_;
+  MOTIS_START_TIMING(generate);
+  generate_universe(opt, pgc, pcis);
+  MOTIS_STOP_TIMING(generate);
+
+  std::cout << fmt::format(
+      "\ngenerated {} groups on {} pcis in {} ms\n\n", pgc.size(),
+      pcis.size(), MOTIS_TIMING_MS(generate));
+
+  std::cout << fmt::format(
+      "memory:\n"
+      "  group objects: {:10.2f} MiB\n"
+      "  group columns: {:10.2f} MiB\n"
+      "  group edges:   {:10.2f} MiB\n"
+      "  pci groups:    {:10.2f} MiB\n\n",
+      to_mib(pgc.allocator_.bytes_allocated()),
+      to_mib(pgc.columns_.allocated_size()),
+      to_mib(pgc.edges_.allocated_size()),
+      to_mib(pcis.groups_.allocated_size()));
+
+  auto const& cols = pgc.columns_;
+  auto checksum = std::uint64_t{};
+  auto const print = [&](char const* name, double const columns_ms,
+                         double const objects_ms) {
+    std::cout << fmt::format("  {:<16} {:10.2f} ms {:10.2f} ms\n", name,
+                             columns_ms, objects_ms);
+  };
+  auto const print_columns = [&](char const* name, double const columns_ms) {
+    std::cout << fmt::format("  {:<16} {:10.2f} ms\n", name, columns_ms);
+  };
+
+  std::cout << fmt::format(
+      "scan speed (avg. of {} iterations):  columns       objects\n",
+      opt.iterations_);
+
+  // filter_groups: active, delayed, original groups
+  auto const filter_columns = measure(opt.iterations_, checksum, [&]() {
+    auto count = std::uint64_t{};
+    for (auto pgi = passenger_group_index{0}; pgi < pgc.size(); ++pgi) {
+      count += pgc.valid(pgi) && cols.estimated_delay_[pgi] > 0 &&
+               (cols.source_flags_[pgi] & group_source_flags::FORECAST) ==
+                   group_source_flags::NONE;
+    }
+    return count;
+  });
+  auto const filter_objects = measure(opt.iterations_, checksum, [&]() {
+    auto count = std::uint64_t{};
+    for (auto const* pg : pgc) {
+      count += pg != nullptr && pgc.valid(pg->id_) &&
+               pg->estimated_delay() > 0 &&
+               (pg->source_flags() & group_source_flags::FORECAST) ==
+                   group_source_flags::NONE;
+    }
+    return count;
+  });
+  print("filter groups", filter_columns, filter_objects);
+
+  // mean load of all pcis
+  auto const mean_columns = measure(opt.iterations_, checksum, [&]() {
+    auto sum = std::uint64_t{};
+    for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+      sum += get_mean_load(pgc, pcis.groups(pci));
+    }
+    return sum;
+  });
+  auto const mean_objects = measure(opt.iterations_, checksum, [&]() {
+    auto sum = std::uint64_t{};
+    for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+      auto mean = 0.0F;
+      for (auto const pgi : pcis.groups(pci)) {
+        auto const* pg = pgc[pgi];
+        mean += static_cast<float>(pg->passengers()) * pg->probability();
+      }
+      sum += static_cast<std::uint64_t>(mean);
+    }
+    return sum;
+  });
+  print("mean load", mean_columns, mean_objects);
+
+  // load distributions of all pcis (columns only)
+  print_columns("load pdf", measure(opt.iterations_, checksum, [&]() {
+                  auto sum = std::uint64_t{};
+                  for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+                    sum += get_load_pdf(pgc, pcis.groups(pci)).data_.size();
+                  }
+                  return sum;
+                }));
+
+  // all group edges (edge pool)
+  print_columns("group edges", measure(opt.iterations_, checksum, [&]() {
+                  auto sum = std::uint64_t{};
+                  for (auto pgi = passenger_group_index{0}; pgi < pgc.size();
+                       ++pgi) {
+                    for (auto const& ei : pgc.edges(pgi)) {
+                      sum += ei.node_;
+                    }
+                  }
+                  return sum;
+                }));
+
+  // filter_trips: critical and crowded checks of all sections (pcis) with
+  // capacity = mean load, computing the distributions on every request
+  // (uncached), after all pcis changed (cache miss) and without changes
+  // (cache hit)
+  auto capacities = std::vector<std::uint16_t>(pcis.size());
+  for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+    capacities[pci] = std::max(std::uint16_t{1U},
+                               get_mean_load(pgc, pcis.groups(pci)));
+  }
+  auto const check_load = [&](auto const& load, pci_index const pci) {
+    return static_cast<std::uint64_t>(
+               load_factor_possibly_ge(load, capacities[pci], 1.0F)) +
+           static_cast<std::uint64_t>(
+               load_factor_possibly_ge(load, capacities[pci], 0.8F));
+  };
+
+  std::cout << fmt::format(
+      "
+filter_trips load checks (avg. of {} iterations):
+",
+      opt.iterations_);
+  print_columns("uncached", measure(opt.iterations_, checksum, [&]() {
+                  auto sum = std::uint64_t{};
+                  for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+                    sum += check_load(get_load_cdf(pgc, pcis.groups(pci)),
+                                      pci);
+                  }
+                  return sum;
+                }));
+  print_columns("cache miss", measure(opt.iterations_, checksum, [&]() {
+                  auto sum = std::uint64_t{};
+                  for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+                    pcis.invalidate_load(pci);
+                  }
+                  for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+                    sum += check_load(get_load_summary(uv, pci), pci);
+                  }
+                  return sum;
+                }));
+  print_columns("cache hit", measure(opt.iterations_, checksum, [&]() {
+                  auto sum = std::uint64_t{};
+                  for (auto pci = pci_index{0}; pci < pcis.size(); ++pci) {
+                    sum += check_load(get_load_summary(uv, pci), pci);
+                  }
+                  return sum;
+                }));
+
+  std::cout << fmt::format("\n(checksum: {})\n", checksum);
+  return 0;
+}
+
+}  // namespace motis::paxmon::tools
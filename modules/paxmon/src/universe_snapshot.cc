@@ -0,0 +1,255 @@
+#include "motis/paxmon/universe_snapshot.h"
+
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "cista/memory_holder.h"
+#include "cista/mmap.h"
+#include "cista/serialization.h"
+
+#include "utl/verify.h"
+
+#include "motis/core/common/logging.h"
+
+namespace fs = boost::filesystem;
+using namespace motis::logging;
+
+namespace motis::paxmon {
+
+constexpr auto const CISTA_MODE =
+    cista::mode::WITH_INTEGRITY | cista::mode::WITH_VERSION;
+
+namespace {
+
+template <typename T, typename Range>
+void add_bucket(snapshot_multimap<T>& mm, Range const& bucket) {
+  if (mm.offsets_.empty()) {
+    mm.offsets_.push_back(0U);
+  }
+  for (auto const& e : bucket) {
+    mm.data_.push_back(e);
+  }
+  mm.offsets_.push_back(mm.data_.size());
+}
+
+template <typename T>
+snapshot_multimap<T> flatten(dynamic_fws_multimap<T> const& mm) {
+  snapshot_multimap<T> flat;
+  flat.offsets_.push_back(0U);
+  for (auto i = 0U; i < mm.index_size(); ++i) {
+    add_bucket(flat, mm[i]);
+  }
+  return flat;
+}
+
+template <typename T>
+std::size_t bucket_count(snapshot_multimap<T> const& mm) {
+  return mm.offsets_.empty() ? 0U : mm.offsets_.size() - 1U;
+}
+
+template <typename T, typename Fn>
+void for_each_entry(snapshot_multimap<T> const& mm, std::size_t const bucket,
+                    Fn&& fn) {
+  for (auto i = mm.offsets_[bucket]; i < mm.offsets_[bucket + 1]; ++i) {
+    fn(mm.data_[i]);
+  }
+}
+
+template <typename T>
+void restore(dynamic_fws_multimap<T>& mm, snapshot_multimap<T> const& flat) {
+  for (auto i = 0U; i < bucket_count(flat); ++i) {
+    auto bucket = mm[i];
+    for_each_entry(flat, i, [&](T const& e) { bucket.emplace_back(e); });
+  }
+}
+
+snapshot_leg to_snapshot_leg(journey_leg const& leg) {
+  return snapshot_leg{leg.trip_idx_,
+                      leg.enter_station_id_,
+                      leg.exit_station_id_,
+                      leg.enter_time_,
+                      leg.exit_time_,
+                      leg.enter_transfer_.has_value(),
+                      leg.enter_transfer_ ? leg.enter_transfer_->duration_
+                                          : duration{},
+                      leg.enter_transfer_ ? leg.enter_transfer_->type_
+                                          : transfer_info::type{}};
+}
+
+journey_leg to_journey_leg(snapshot_leg const& leg) {
+  return journey_leg{leg.trip_idx_,
+                     leg.enter_station_id_,
+                     leg.exit_station_id_,
+                     leg.enter_time_,
+                     leg.exit_time_,
+                     leg.has_enter_transfer_
+                         ? std::optional<transfer_info>{transfer_info{
+                               leg.enter_transfer_duration_,
+                               leg.enter_transfer_type_}}
+                         : std::nullopt};
+}
+
+universe_snapshot create_snapshot(universe const& uv,
+                                  cista::hash_t const schedule_hash,
+                                  cista::hash_t const input_hash) {
+  universe_snapshot snapshot;
+  snapshot.schedule_hash_ = schedule_hash;
+  snapshot.input_hash_ = input_hash;
+
+  for (auto const& n : uv.graph_.nodes_) {
+    snapshot.nodes_.push_back(n);
+  }
+  snapshot.edges_.offsets_.push_back(0U);
+  for (auto i = 0U; i < uv.graph_.node_count(); ++i) {
+    add_bucket(snapshot.edges_, uv.graph_.outgoing_edges(i));
+  }
+
+  snapshot.trips_.resize(uv.trip_data_.size());
+  for (auto const& entry : uv.trip_data_.mapping_) {
+    snapshot.trips_[entry.second] = entry.first;
+  }
+  snapshot.trip_edges_ = flatten(uv.trip_data_.edges_);
+  snapshot.trip_canceled_nodes_ = flatten(uv.trip_data_.canceled_nodes_);
+  for (auto const n : uv.trip_data_.enter_exit_nodes_) {
+    snapshot.trip_enter_exit_nodes_.push_back(n);
+  }
+
+  snapshot.pci_groups_ = flatten(uv.pax_connection_info_.groups_);
+  for (auto const load : uv.pax_connection_info_.expected_load_) {
+    snapshot.pci_expected_load_.push_back(load);
+  }
+
+  snapshot.interchanges_at_station_ = flatten(uv.interchanges_at_station_);
+
+  snapshot.group_legs_.offsets_.push_back(0U);
+  snapshot.group_edges_.offsets_.push_back(0U);
+  for (auto const* pg : uv.passenger_groups_) {
+    if (pg == nullptr) {
+      snapshot.groups_.push_back(snapshot_group{});
+      add_bucket(snapshot.group_legs_, mcd::vector<snapshot_leg>{});
+      add_bucket(snapshot.group_edges_, std::vector<edge_index>{});
+      continue;
+    }
+    snapshot.groups_.push_back(snapshot_group{
+        true, pg->source_, pg->passengers(), pg->planned_arrival_time(),
+        pg->source_flags(), pg->ok_, pg->added_time_, pg->probability(),
+        uv.passenger_groups_.columns_.estimated_delay_[pg->id_],
+        pg->generation_, pg->previous_version_});
+    for (auto const& leg : pg->compact_planned_journey_.legs_) {
+      snapshot.group_legs_.data_.push_back(to_snapshot_leg(leg));
+    }
+    snapshot.group_legs_.offsets_.push_back(snapshot.group_legs_.data_.size());
+    add_bucket(snapshot.group_edges_, uv.passenger_groups_.edges(pg->id_));
+  }
+
+  return snapshot;
+}
+
+void restore_snapshot(universe& uv, universe_snapshot const& snapshot) {
+  utl::verify(uv.graph_.nodes_.empty() && uv.passenger_groups_.size() == 0,
+              "paxmon: universe snapshot can only be restored into an empty "
+              "universe");
+
+  for (auto const& n : snapshot.nodes_) {
+    uv.graph_.push_back_node(n);
+  }
+  for (auto i = 0U; i < bucket_count(snapshot.edges_); ++i) {
+    for_each_entry(snapshot.edges_, i,
+                   [&](edge const& e) { uv.graph_.push_back_edge(e); });
+  }
+
+  for (auto tdi = 0U; tdi < snapshot.trips_.size(); ++tdi) {
+    uv.trip_data_.insert_trip(snapshot.trips_[tdi],
+                              snapshot.trip_enter_exit_nodes_[tdi]);
+  }
+  restore(uv.trip_data_.edges_, snapshot.trip_edges_);
+  restore(uv.trip_data_.canceled_nodes_, snapshot.trip_canceled_nodes_);
+
+  for (auto pci = 0U; pci < snapshot.pci_expected_load_.size(); ++pci) {
+    uv.pax_connection_info_.insert();
+    uv.pax_connection_info_.expected_load_[pci] =
+        snapshot.pci_expected_load_[pci];
+  }
+  restore(uv.pax_connection_info_.groups_, snapshot.pci_groups_);
+
+  restore(uv.interchanges_at_station_, snapshot.interchanges_at_station_);
+
+  uv.passenger_groups_.reserve(snapshot.groups_.size());
+  for (auto id = 0U; id < snapshot.groups_.size(); ++id) {
+    auto const& sg = snapshot.groups_[id];
+    if (!sg.valid_) {
+      uv.passenger_groups_.add_released();
+      continue;
+    }
+    compact_journey cj;
+    for_each_entry(snapshot.group_legs_, id, [&](snapshot_leg const& leg) {
+      cj.legs_.emplace_back(to_journey_leg(leg));
+    });
+    auto* pg = uv.passenger_groups_.add(make_passenger_group(
+        std::move(cj), sg.source_, sg.passengers_, sg.planned_arrival_time_,
+        sg.source_flags_, sg.probability_, sg.added_time_,
+        sg.previous_version_, sg.generation_, sg.estimated_delay_, id));
+    pg->ok_ = sg.ok_;
+    for_each_entry(snapshot.group_edges_, id, [&](edge_index const& ei) {
+      uv.passenger_groups_.add_edge(pg->id_, ei);
+    });
+  }
+}
+
+}  // namespace
+
+void write_universe_snapshot(universe const& uv, std::string const& path,
+                             cista::hash_t const schedule_hash,
+                             cista::hash_t const input_hash) {
+  scoped_timer timer{"write paxmon universe snapshot"};
+  auto const snapshot = create_snapshot(uv, schedule_hash, input_hash);
+  auto writer = cista::buf<cista::mmap>(
+      cista::mmap{path.c_str(), cista::mmap::protection::WRITE});
+  cista::serialize<CISTA_MODE>(writer, snapshot);
+}
+
+bool read_universe_snapshot(universe& uv, std::string const& path,
+                            cista::hash_t const schedule_hash,
+                            cista::hash_t const input_hash) {
+  if (!fs::is_regular_file(path)) {
+    return false;
+  }
+
+  scoped_timer timer{"read paxmon universe snapshot"};
+  cista::memory_holder mem;
+  universe_snapshot const* snapshot = nullptr;
+  try {
+#if defined(MOTIS_SCHEDULE_MODE_OFFSET) && !defined(CLANG_TIDY)
+    mem = cista::buf<cista::mmap>(
+        cista::mmap{path.c_str(), cista::mmap::protection::READ});
+    snapshot = cista::deserialize<universe_snapshot, CISTA_MODE>(
+        std::get<cista::buf<cista::mmap>>(mem));
+#elif defined(MOTIS_SCHEDULE_MODE_RAW) || defined(CLANG_TIDY)
+    mem = cista::file(path.c_str(), "r").content();
+    // NOLINTNEXTLINE
+    snapshot = cista::deserialize<universe_snapshot, CISTA_MODE>(
+        std::get<cista::buffer>(mem));
+#else
+#error "no ptr mode specified"
+#endif
+  } catch (std::exception const& e) {
+    LOG(warn) << "could not read paxmon universe snapshot " << path << ": "
+              << e.what();
+    return false;
+  }
+
+  if (snapshot->schedule_hash_ != schedule_hash ||
+      snapshot->input_hash_ != input_hash) {
+    LOG(info) << "paxmon universe snapshot is outdated: " << path;
+    return false;
+  }
+
+  restore_snapshot(uv, *snapshot);
+  return true;
+}
+
+}  // namespace motis::paxmon
@@ -1,6 +1,8 @@
 #include "motis/paxmon/update_load.h"
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include "utl/erase.h"
 #include "utl/verify.h"
@@ -9,10 +11,15 @@
 
 namespace motis::paxmon {
 
-void update_load(passenger_group* pg, reachability_info const& reachability,
-                 passenger_localization const& localization, universe& uv) {
-  auto disabled_edges = pg->edges_;
-  pg->edges_.clear();
+std::vector<edge_index> update_load(passenger_group* pg,
+                                    reachability_info const& reachability,
+                                    passenger_localization const& localization,
+                                    universe& uv) {
+  auto const old_edges = uv.passenger_groups_.edges(pg->id_);
+  auto disabled_edges =
+      std::vector<edge_index>{begin(old_edges), end(old_edges)};
+  auto new_edges = std::vector<edge_index>{};
+  new_edges.reserve(disabled_edges.size());
 
   auto const add_to_edge = [&](edge_index const& ei, edge* e) {
     if (std::find(begin(disabled_edges), end(disabled_edges), ei) ==
@@ -22,7 +29,7 @@ void update_load(passenger_group* pg, reachability_info const& reachability,
     } else {
       utl::erase(disabled_edges, ei);
     }
-    pg->edges_.emplace_back(ei);
+    new_edges.emplace_back(ei);
   };
 
   auto const add_interchange = [&](reachable_trip const& rt,
@@ -91,6 +98,8 @@ void update_load(passenger_group* pg, reachability_info const& reachability,
     auto guard = std::lock_guard{uv.pax_connection_info_.mutex(e->pci_)};
     remove_passenger_group_from_edge(uv, e, pg);
   }
+
+  return new_edges;
 }
 
 }  // namespace motis::paxmon
@@ -86,7 +86,7 @@ struct update_tracker::impl {
   void before_group_reused(passenger_group const* pg) {
     store_group_info(pg);
     reused_groups_.insert(pg->id_);
-    // TODO(pablo): maybe use pg->edges_ instead
+    // TODO(pablo): maybe use the group edges instead
     for (auto& leg : pg->compact_planned_journey_.legs_) {
       auto& uti = get_or_create_updated_trip_info(leg.trip_idx_);
       uti.reused_groups_.insert(pg->id_);
@@ -98,7 +98,7 @@ struct update_tracker::impl {
   void before_group_removed(passenger_group const* pg) {
     store_group_info(pg);
     removed_groups_.emplace_back(pg->id_);
-    // TODO(pablo): maybe use pg->edges_ instead
+    // TODO(pablo): maybe use the group edges instead
     for (auto& leg : pg->compact_planned_journey_.legs_) {
       auto& uti = get_or_create_updated_trip_info(leg.trip_idx_);
       uti.removed_groups_.insert(pg->id_);
@@ -174,10 +174,11 @@ private:
   void store_group_info(passenger_group const* pg) {
     if (auto it = group_infos_.find(pg->id_); it != end(group_infos_)) {
       auto& pgbi = it->second;
-      pgbi.probability_ = pg->probability_;
+      pgbi.probability_ = pg->probability();
     } else {
-      group_infos_[pg->id_] = pg_base_info{pg->source_, pg->passengers_,
-                                           pg->probability_, pg->probability_};
+      group_infos_[pg->id_] =
+          pg_base_info{pg->source_, pg->passengers(), pg->probability(),
+                       pg->probability()};
     }
   }
 
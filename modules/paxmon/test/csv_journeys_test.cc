@@ -0,0 +1,224 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "fmt/format.h"
+
+#include "motis/core/schedule/schedule.h"
+#include "motis/core/access/time_access.h"
+#include "motis/core/access/trip_iterator.h"
+#include "motis/loader/loader.h"
+#include "motis/module/controller.h"
+
+#include "motis/paxmon/loader/csv/csv_journeys.h"
+#include "motis/paxmon/universe.h"
+
+#include "motis/test/schedule/simple_realtime.h"
+
+namespace fs = boost::filesystem;
+using namespace motis::module;
+
+namespace motis::paxmon {
+
+namespace {
+
+struct trip_stop_info {
+  std::string eva_;
+  time arr_{INVALID_TIME};
+  time dep_{INVALID_TIME};
+};
+
+struct trip_info {
+  std::string category_;
+  std::uint32_t train_nr_{};
+  std::vector<trip_stop_info> stops_;
+};
+
+std::vector<trip_info> get_trips(schedule const& sched) {
+  std::vector<trip_info> trips;
+  for (auto const& trp : sched.trip_mem_) {
+    auto& ti = trips.emplace_back();
+    ti.train_nr_ = trp->id_.primary_.get_train_nr();
+    for (auto const& stop : access::stops(trp.get())) {
+      auto& si = ti.stops_.emplace_back();
+      si.eva_ = stop.get_station(sched).eva_nr_.view();
+      if (stop.has_arrival()) {
+        si.arr_ = stop.arr_lcon().a_time_;
+      }
+      if (stop.has_departure()) {
+        si.dep_ = stop.dep_lcon().d_time_;
+        ti.category_ =
+            sched.categories_[stop.dep_lcon().full_con_->con_info_->family_]
+                ->name_.view();
+      }
+    }
+  }
+  return trips;
+}
+
+// Journeys on all trips of the schedule: exact and inexact matches, wrong
+// train numbers, unknown stations, invalid times, foot legs and journeys
+// with several legs on the same trip.
+std::string make_journeys(schedule const& sched) {
+  auto csv = std::string{
+      "id,secondary_id,leg_idx,leg_type,from,to,enter,exit,category,train_nr,"
+      "passengers\n"};
+  auto id = 0U;
+  auto leg_idx = 0U;
+  auto const add_leg = [&](std::string const& type, std::string const& from,
+                           std::string const& to, std::time_t const enter,
+                           std::time_t const exit, std::string const& category,
+                           std::uint32_t const train_nr) {
+    csv += fmt::format("{},{},{},{},{},{},{},{},{},{},{}\n", id, id % 3,
+                       leg_idx++, type, from, to, enter, exit, category,
+                       train_nr, 1 + id % 7);
+  };
+  auto const next_journey = [&]() {
+    ++id;
+    leg_idx = 0U;
+  };
+  auto const to_unixtime = [&](time const t, int const offset = 0) {
+    return motis_to_unixtime(sched, t) + offset * 60;
+  };
+
+  for (auto const& trp : get_trips(sched)) {
+    auto const& stops = trp.stops_;
+    for (auto from = 0U; from < stops.size(); ++from) {
+      for (auto to = from + 1; to < stops.size(); ++to) {
+        auto const& s = stops[from];
+        auto const& t = stops[to];
+        auto const leg = [&](int const enter_offset, int const exit_offset,
+                             std::uint32_t const train_nr) {
+          add_leg("TRIP", s.eva_, t.eva_, to_unixtime(s.dep_, enter_offset),
+                  to_unixtime(t.arr_, exit_offset), trp.category_, train_nr);
+        };
+
+        leg(0, 0, trp.train_nr_);
+        next_journey();
+        leg(2, -3, trp.train_nr_);
+        next_journey();
+        leg(-1, 1, trp.train_nr_ + 1);
+        next_journey();
+        leg(20, 20, trp.train_nr_);
+        next_journey();
+
+        add_leg("TRIP", s.eva_, "0000000", to_unixtime(s.dep_),
+                to_unixtime(t.arr_), trp.category_, trp.train_nr_);
+        leg(0, 0, trp.train_nr_);
+        next_journey();
+
+        add_leg("TRIP", s.eva_, t.eva_, 0, 0, trp.category_, trp.train_nr_);
+        next_journey();
+
+        if (to + 1 < stops.size()) {
+          auto const& u = stops[to + 1];
+          leg(0, 0, trp.train_nr_);
+          add_leg("FOOT", t.eva_, t.eva_, to_unixtime(t.arr_),
+                  to_unixtime(t.dep_), "", 0);
+          add_leg("TRIP", t.eva_, u.eva_, to_unixtime(t.dep_),
+                  to_unixtime(u.arr_), trp.category_, trp.train_nr_);
+          next_journey();
+        }
+      }
+    }
+  }
+  return csv;
+}
+
+struct paxmon_csv_journeys : public ::testing::Test {
+  paxmon_csv_journeys()
+      : sched_{loader::load_schedule(
+            motis::test::schedule::simple_realtime::dataset_opt)},
+        controller_{{}} {}
+
+  void SetUp() override {
+    dispatcher::direct_mode_dispatcher_ = &controller_;
+    path_ = (fs::temp_directory_path() /
+             fs::unique_path("paxmon_journeys_%%%%-%%%%.csv"))
+                .generic_string();
+    std::ofstream{path_} << make_journeys(*sched_);
+  }
+
+  void TearDown() override {
+    dispatcher::direct_mode_dispatcher_ = nullptr;
+    fs::remove(path_);
+  }
+
+  loader::loader_result load(universe& uv,
+                             loader::csv::csv_journey_options const& opt,
+                             loader::csv::csv_journey_stats& stats) {
+    return loader::csv::load_journeys(*sched_, uv, path_, "", 5, opt, &stats);
+  }
+
+  schedule_ptr sched_;
+  controller controller_;
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(paxmon_csv_journeys, departure_index_same_as_route_edges) {
+  auto reference_uv = universe{};
+  auto reference_stats = loader::csv::csv_journey_stats{};
+  auto const reference = load(
+      reference_uv,
+      loader::csv::csv_journey_options{false, std::size_t{1024U} * 1024U},
+      reference_stats);
+
+  ASSERT_NE(0U, reference.loaded_journeys_);
+  EXPECT_NE(0U, reference.unmatched_journeys_.size());
+  EXPECT_NE(0U, reference_stats.journeys_with_inexact_matches_);
+  EXPECT_NE(0U, reference_stats.journeys_with_invalid_legs_);
+  EXPECT_NE(0U, reference_stats.journeys_with_no_valid_legs_);
+
+  for (auto const chunk_size : {64U, 1024U}) {
+    auto uv = universe{};
+    auto stats = loader::csv::csv_journey_stats{};
+    auto const result =
+        load(uv, loader::csv::csv_journey_options{true, chunk_size}, stats);
+
+    EXPECT_EQ(reference.loaded_journeys_, result.loaded_journeys_);
+    EXPECT_EQ(reference_stats, stats);
+
+    ASSERT_EQ(reference.unmatched_journeys_.size(),
+              result.unmatched_journeys_.size());
+    for (auto i = 0U; i < result.unmatched_journeys_.size(); ++i) {
+      auto const& a = reference.unmatched_journeys_[i];
+      auto const& b = result.unmatched_journeys_[i];
+      EXPECT_EQ(a.start_station_idx_, b.start_station_idx_);
+      EXPECT_EQ(a.destination_station_idx_, b.destination_station_idx_);
+      EXPECT_EQ(a.departure_time_, b.departure_time_);
+      EXPECT_EQ(a.source_, b.source_);
+      EXPECT_EQ(a.passengers_, b.passengers_);
+    }
+
+    ASSERT_EQ(reference_uv.passenger_groups_.size(),
+              uv.passenger_groups_.size());
+    for (auto id = 0U; id < uv.passenger_groups_.size(); ++id) {
+      auto const* a = reference_uv.passenger_groups_[id];
+      auto const* b = uv.passenger_groups_[id];
+      EXPECT_EQ(a->compact_planned_journey_, b->compact_planned_journey_);
+      EXPECT_EQ(a->source_, b->source_);
+      EXPECT_EQ(a->passengers(), b->passengers());
+      EXPECT_EQ(a->planned_arrival_time(), b->planned_arrival_time());
+      EXPECT_EQ(a->source_flags(), b->source_flags());
+    }
+  }
+}
+
+TEST_F(paxmon_csv_journeys, empty_file) {
+  std::ofstream{path_, std::ios::trunc};
+  auto uv = universe{};
+  auto stats = loader::csv::csv_journey_stats{};
+  auto const result = load(uv, loader::csv::csv_journey_options{}, stats);
+  EXPECT_EQ(0U, result.loaded_journeys_);
+  EXPECT_TRUE(result.unmatched_journeys_.empty());
+  EXPECT_EQ(0U, uv.passenger_groups_.size());
+}
+
+}  // namespace motis::paxmon
@@ -202,6 +202,97 @@ TEST(paxmon_get_load, two_groups) {
   EXPECT_EQ(get_median_load(get_cdf(pdf)), 10);
 }
 
+TEST(paxmon_get_load, load_summary_cache) {
+  auto uv = universe{};
+  auto const* pg1 = uv.passenger_groups_.add(mk_pg(10, 1.0F));
+  auto const* pg2 = uv.passenger_groups_.add(mk_pg(20, 0.5F));
+  auto const pci = uv.pax_connection_info_.insert();
+  auto groups = uv.pax_connection_info_.groups_[pci];
+  groups.emplace_back(pg1->id_);
+
+  auto const& summary = get_load_summary(uv, pci);
+  EXPECT_EQ((pax_limits{10, 10}), summary.limits_);
+  EXPECT_EQ(10, summary.cdf_ge_95_);
+  EXPECT_EQ(10, summary.cdf_gt_95_);
+
+  groups.emplace_back(pg2->id_);
+  EXPECT_EQ(&summary, &get_load_summary(uv, pci));
+  EXPECT_EQ((pax_limits{10, 10}), get_load_summary(uv, pci).limits_);
+
+  uv.pax_connection_info_.invalidate_load(pci);
+  auto const& updated = get_load_summary(uv, pci);
+  EXPECT_EQ((pax_limits{10, 30}), updated.limits_);
+  EXPECT_EQ(30, updated.cdf_ge_95_);
+  EXPECT_EQ(30, updated.cdf_gt_95_);
+}
+
+TEST(paxmon_get_load, load_summary_thresholds) {
+  auto const pgc =
+      mk_pgc({mk_pg(10, 1.0F), mk_pg(20, 0.5F), mk_pg(30, 0.25F),
+              mk_pg(5, 0.95F), mk_pg(8, 0.05F)});
+  auto pcis = pci_container{};
+  auto const pcig = mk_pci(pgc, pcis);
+  auto const cdf = get_load_cdf(pgc, pcig);
+  auto const summary = get_load_summary(cdf, get_pax_limits(pgc, pcig));
+
+  for (auto const capacity : {1, 10, 20, 40, 55, 60, 73, 100}) {
+    for (auto threshold = 0.0F; threshold <= 2.0F; threshold += 0.05F) {
+      EXPECT_EQ(load_factor_possibly_ge(
+                    cdf, static_cast<std::uint16_t>(capacity), threshold),
+                load_factor_possibly_ge(
+                    summary, static_cast<std::uint16_t>(capacity), threshold))
+          << "capacity=" << capacity << ", threshold=" << threshold;
+    }
+  }
+}
+
+TEST(paxmon_get_load, group_columns) {
+  auto pgc = mk_pgc({mk_pg(10, 1.0F), mk_pg(20, 0.5F), mk_pg(30, 0.25F)});
+  auto pcis = pci_container{};
+  auto const pcig = mk_pci(pgc, pcis);
+  ASSERT_EQ(3, pgc.columns_.passengers_.size());
+  EXPECT_EQ(20, pgc.columns_.passengers_[1]);
+
+  pgc.set_probability(pgc[1], 1.0F);
+  EXPECT_EQ(1.0F, pgc[1]->probability());
+  EXPECT_EQ((pax_limits{30, 60}), get_pax_limits(pgc, pcig));
+
+  pgc.release(2);
+  EXPECT_EQ(0, pgc.columns_.passengers_[2]);
+  EXPECT_EQ(make_pdf({{30, 1.0F}}).data_, get_load_pdf(pgc, pcig).data_);
+}
+
+TEST(paxmon_get_load, group_edges) {
+  auto pgc = mk_pgc({mk_pg(10, 1.0F), mk_pg(20, 0.5F)});
+  EXPECT_FALSE(pgc.valid(0));
+  EXPECT_FALSE(pgc.valid(1));
+
+  pgc.add_edge(0, edge_index{1U, 0U});
+  pgc.add_edge(1, edge_index{2U, 1U});
+  pgc.add_edge(0, edge_index{3U, 2U});
+  EXPECT_TRUE(pgc.valid(0));
+  EXPECT_TRUE(pgc.valid(1));
+  auto const edges = pgc.edges(0);
+  EXPECT_EQ((std::vector<edge_index>{{1U, 0U}, {3U, 2U}}),
+            std::vector<edge_index>(begin(edges), end(edges)));
+
+  pgc.remove_edge(0, edge_index{1U, 0U});
+  EXPECT_TRUE(pgc.valid(0));
+  pgc.remove_edge(0, edge_index{3U, 2U});
+  EXPECT_FALSE(pgc.valid(0));
+  EXPECT_TRUE(pgc.edges(0).empty());
+
+  pgc.set_edges(0, std::vector<edge_index>{{4U, 0U}, {5U, 0U}});
+  EXPECT_EQ(2U, pgc.edges(0).size());
+  EXPECT_TRUE(pgc.valid(0));
+
+  pgc.release(1);
+  EXPECT_FALSE(pgc.exists(1));
+  EXPECT_FALSE(pgc.valid(1));
+  EXPECT_TRUE(pgc.edges(1).empty());
+  EXPECT_EQ(2U, pgc.edges(0).size());
+}
+
 #ifdef MOTIS_AVX2
 TEST(paxmon_get_load, base_eq_avx) {
   auto gen = std::mt19937{std::random_device{}()};
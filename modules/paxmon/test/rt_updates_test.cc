@@ -0,0 +1,291 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "fmt/format.h"
+
+#include "motis/core/schedule/schedule.h"
+#include "motis/core/access/time_access.h"
+#include "motis/core/access/trip_iterator.h"
+#include "motis/core/conv/trip_conv.h"
+#include "motis/loader/loader.h"
+#include "motis/module/controller.h"
+#include "motis/module/message.h"
+
+#include "motis/paxmon/build_graph.h"
+#include "motis/paxmon/loader/csv/csv_journeys.h"
+#include "motis/paxmon/rt_updates.h"
+#include "motis/paxmon/universe.h"
+
+#include "motis/test/schedule/simple_realtime.h"
+
+namespace fs = boost::filesystem;
+using namespace flatbuffers;
+using namespace motis::module;
+using namespace motis::rt;
+
+namespace motis::paxmon {
+
+namespace {
+
+struct stop_info {
+  std::string eva_;
+  time arr_{INVALID_TIME};
+  time dep_{INVALID_TIME};
+};
+
+struct trip_info {
+  trip const* trp_{};
+  std::string category_;
+  std::uint32_t train_nr_{};
+  std::vector<stop_info> stops_;
+};
+
+std::vector<trip_info> get_trips(schedule const& sched) {
+  std::vector<trip_info> trips;
+  for (auto const& trp : sched.trip_mem_) {
+    auto& ti = trips.emplace_back();
+    ti.trp_ = trp.get();
+    ti.train_nr_ = trp->id_.primary_.get_train_nr();
+    for (auto const& stop : access::stops(trp.get())) {
+      auto& si = ti.stops_.emplace_back();
+      si.eva_ = stop.get_station(sched).eva_nr_.view();
+      if (stop.has_arrival()) {
+        si.arr_ = stop.arr_lcon().a_time_;
+      }
+      if (stop.has_departure()) {
+        si.dep_ = stop.dep_lcon().d_time_;
+        ti.category_ =
+            sched.categories_[stop.dep_lcon().full_con_->con_info_->family_]
+                ->name_.view();
+      }
+    }
+  }
+  return trips;
+}
+
+// Interchanges of the schedule: same station or the two Köln Messe/Deutz
+// stations (see README.txt of the schedule).
+bool is_interchange(stop_info const& arr, stop_info const& dep) {
+  return arr.arr_ != INVALID_TIME && dep.dep_ != INVALID_TIME &&
+         arr.arr_ < dep.dep_ &&
+         (arr.eva_ == dep.eva_ ||
+          (arr.eva_ == "8073368" && dep.eva_ == "8003368"));
+}
+
+// Single leg journeys between all stops and journeys with one interchange
+// from every stop before the interchange to every stop after it.
+std::string make_journeys(schedule const& sched,
+                          std::vector<trip_info> const& trips) {
+  auto csv = std::string{
+      "id,secondary_id,leg_idx,leg_type,from,to,enter,exit,category,train_nr,"
+      "passengers\n"};
+  auto id = 0U;
+  auto const add_leg = [&](unsigned const leg_idx, trip_info const& trp,
+                           stop_info const& from, stop_info const& to) {
+    csv += fmt::format("{},0,{},TRIP,{},{},{},{},{},{},{}\n", id, leg_idx,
+                       from.eva_, to.eva_, motis_to_unixtime(sched, from.dep_),
+                       motis_to_unixtime(sched, to.arr_), trp.category_,
+                       trp.train_nr_, 1 + id % 7);
+  };
+
+  for (auto const& a : trips) {
+    for (auto from = 0U; from < a.stops_.size(); ++from) {
+      for (auto to = from + 1; to < a.stops_.size(); ++to) {
+        add_leg(0, a, a.stops_[from], a.stops_[to]);
+        ++id;
+
+        for (auto const& b : trips) {
+          for (auto enter = 0U; enter + 1 < b.stops_.size(); ++enter) {
+            if (&a == &b || !is_interchange(a.stops_[to], b.stops_[enter])) {
+              continue;
+            }
+            for (auto exit = enter + 1; exit < b.stops_.size(); ++exit) {
+              add_leg(0, a, a.stops_[from], a.stops_[to]);
+              add_leg(1, b, b.stops_[enter], b.stops_[exit]);
+              ++id;
+            }
+          }
+        }
+      }
+    }
+  }
+  return csv;
+}
+
+// Delays all events of the trip starting at stop first_stop.
+Offset<RtUpdate> delay_update(message_creator& mc, schedule const& sched,
+                              trip_info const& trp,
+                              std::size_t const first_stop, int const delay) {
+  auto events = std::vector<Offset<UpdatedRtEventInfo>>{};
+  auto const add_event = [&](stop_info const& s, time const t,
+                             EventType const type) {
+    auto const schedule_time = motis_to_unixtime(sched, t);
+    events.emplace_back(CreateUpdatedRtEventInfo(
+        mc,
+        CreateRtEventInfo(mc, mc.CreateString(s.eva_), schedule_time, type),
+        schedule_time + delay * 60, TimestampReason_FORECAST));
+  };
+  for (auto i = first_stop; i < trp.stops_.size(); ++i) {
+    auto const& s = trp.stops_[i];
+    if (s.arr_ != INVALID_TIME) {
+      add_event(s, s.arr_, EventType_ARR);
+    }
+    if (s.dep_ != INVALID_TIME) {
+      add_event(s, s.dep_, EventType_DEP);
+    }
+  }
+  return CreateRtUpdate(
+      mc, Content_RtDelayUpdate,
+      CreateRtDelayUpdate(mc, to_fbs(sched, mc, trp.trp_),
+                          mc.CreateVector(events))
+          .Union());
+}
+
+struct delay {
+  std::uint32_t train_nr_{};
+  std::size_t first_stop_{};
+  int minutes_{};
+};
+
+msg_ptr make_rt_updates(schedule const& sched,
+                        std::vector<trip_info> const& trips,
+                        std::vector<delay> const& delays) {
+  message_creator mc;
+  auto updates = std::vector<Offset<RtUpdate>>{};
+  for (auto const& d : delays) {
+    for (auto const& trp : trips) {
+      if (trp.train_nr_ == d.train_nr_) {
+        updates.emplace_back(
+            delay_update(mc, sched, trp, d.first_stop_, d.minutes_));
+      }
+    }
+  }
+  mc.create_and_finish(MsgContent_RtUpdates,
+                       CreateRtUpdates(mc, mc.CreateVector(updates)).Union(),
+                       "/rt/update");
+  return make_msg(mc);
+}
+
+void expect_equal_stats(system_statistics const& a,
+                        system_statistics const& b) {
+  EXPECT_EQ(a.total_broken_interchanges_, b.total_broken_interchanges_);
+  EXPECT_EQ(a.total_affected_passengers_, b.total_affected_passengers_);
+  EXPECT_EQ(a.delay_updates_, b.delay_updates_);
+  EXPECT_EQ(a.reroute_updates_, b.reroute_updates_);
+  EXPECT_EQ(a.update_event_times_trip_edges_found_,
+            b.update_event_times_trip_edges_found_);
+  EXPECT_EQ(a.update_event_times_dep_updated_,
+            b.update_event_times_dep_updated_);
+  EXPECT_EQ(a.update_event_times_arr_updated_,
+            b.update_event_times_arr_updated_);
+  EXPECT_EQ(a.total_updated_interchange_edges_,
+            b.total_updated_interchange_edges_);
+}
+
+struct paxmon_rt_updates : public ::testing::Test {
+  paxmon_rt_updates()
+      : sched_{loader::load_schedule(
+            motis::test::schedule::simple_realtime::dataset_opt)},
+        controller_{{}} {}
+
+  void SetUp() override {
+    dispatcher::direct_mode_dispatcher_ = &controller_;
+    trips_ = get_trips(*sched_);
+    path_ = (fs::temp_directory_path() /
+             fs::unique_path("paxmon_rt_updates_%%%%-%%%%.csv"))
+                .generic_string();
+    std::ofstream{path_} << make_journeys(*sched_, trips_);
+  }
+
+  void TearDown() override {
+    dispatcher::direct_mode_dispatcher_ = nullptr;
+    fs::remove(path_);
+  }
+
+  void load(universe& uv) {
+    loader::csv::load_journeys(*sched_, uv, path_, "", 0);
+    build_graph_from_journeys(*sched_, caps_, uv);
+  }
+
+  void expect_equal(universe const& serial, universe const& parallel) {
+    EXPECT_EQ(serial.rt_update_ctx_.groups_affected_by_last_update_,
+              parallel.rt_update_ctx_.groups_affected_by_last_update_);
+    expect_equal_stats(serial.system_stats_, parallel.system_stats_);
+
+    ASSERT_EQ(serial.passenger_groups_.size(),
+              parallel.passenger_groups_.size());
+    for (auto pgi = 0U; pgi < serial.passenger_groups_.size(); ++pgi) {
+      EXPECT_EQ(serial.passenger_groups_[pgi]->ok_,
+                parallel.passenger_groups_[pgi]->ok_);
+    }
+
+    ASSERT_EQ(serial.graph_.nodes_.size(), parallel.graph_.nodes_.size());
+    for (auto n = 0U; n < serial.graph_.nodes_.size(); ++n) {
+      auto const& a = serial.graph_.nodes_[n];
+      auto const& b = parallel.graph_.nodes_[n];
+      EXPECT_EQ(a.current_time(), b.current_time());
+      ASSERT_EQ(a.outgoing_edges(serial).size(),
+                b.outgoing_edges(parallel).size());
+      auto b_it = begin(b.outgoing_edges(parallel));
+      for (auto const& e : a.outgoing_edges(serial)) {
+        EXPECT_EQ(e.is_broken(), b_it->is_broken());
+        ++b_it;
+      }
+    }
+  }
+
+  schedule_ptr sched_;
+  controller controller_;
+  capacity_maps caps_;
+  std::vector<trip_info> trips_;
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(paxmon_rt_updates, parallel_same_as_serial) {
+  auto serial = universe{};
+  auto parallel = universe{};
+  load(serial);
+  load(parallel);
+  ASSERT_NE(0U, serial.passenger_groups_.size());
+
+  auto const serial_opt = rt_update_options{1U};
+  auto const parallel_opt = rt_update_options{4U, 1U};
+  auto const arrival_delay_threshold = 20;
+
+  // IC 2292 misses ICE 628 in Frankfurt, ICE 628 misses RE 10958 in Köln
+  // (with a repeated update for the ICE).
+  auto const broken = make_rt_updates(
+      *sched_, trips_,
+      {{2292U, 1U, 40}, {628U, 5U, 15}, {10958U, 3U, 10}, {628U, 5U, 25}});
+  // back to the schedule times: interchanges valid again
+  auto const valid_again = make_rt_updates(
+      *sched_, trips_, {{2292U, 1U, 0}, {628U, 5U, 0}, {10958U, 3U, 0}});
+
+  for (auto const& msg : {broken, valid_again}) {
+    auto const update = motis_content(RtUpdates, msg);
+    handle_rt_update(serial, caps_, *sched_, update, arrival_delay_threshold,
+                     serial_opt);
+    handle_rt_update(parallel, caps_, *sched_, update,
+                     arrival_delay_threshold, parallel_opt);
+
+    EXPECT_FALSE(
+        serial.rt_update_ctx_.groups_affected_by_last_update_.empty());
+    expect_equal(serial, parallel);
+
+    serial.rt_update_ctx_.groups_affected_by_last_update_.clear();
+    parallel.rt_update_ctx_.groups_affected_by_last_update_.clear();
+  }
+
+  EXPECT_NE(0U, serial.system_stats_.total_broken_interchanges_);
+  EXPECT_NE(0U, serial.system_stats_.total_affected_passengers_);
+}
+
+}  // namespace motis::paxmon
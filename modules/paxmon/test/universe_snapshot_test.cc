@@ -0,0 +1,242 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "motis/paxmon/universe.h"
+#include "motis/paxmon/universe_snapshot.h"
+
+namespace fs = boost::filesystem;
+
+namespace motis::paxmon {
+
+namespace {
+
+constexpr auto const SCHEDULE_HASH = cista::hash_t{42U};
+constexpr auto const INPUT_HASH = cista::hash_t{7U};
+
+event_node mk_node(event_node_index const idx, time const t,
+                   event_type const type, std::uint32_t const station) {
+  return event_node{idx, t, static_cast<time>(t - 2U), type, true, station};
+}
+
+edge mk_edge(event_node_index const from, event_node_index const to,
+             edge_type const type, pci_index const pci) {
+  auto e = edge{};
+  e.from_ = from;
+  e.to_ = to;
+  e.type_ = type;
+  e.transfer_time_ = type == edge_type::INTERCHANGE ? 5U : 0U;
+  e.encoded_capacity_ = 120U;
+  e.clasz_ = service_class::ICE;
+  e.trips_ = type == edge_type::TRIP ? 3U : 0U;
+  e.pci_ = pci;
+  return e;
+}
+
+compact_journey mk_journey(trip_idx_t const trip, bool const transfer) {
+  auto cj = compact_journey{};
+  cj.legs_.emplace_back(journey_leg{
+      trip, 1U, 2U, 600U, 660U,
+      transfer ? std::optional<transfer_info>{transfer_info{
+                     4U, transfer_info::type::FOOTPATH}}
+               : std::nullopt});
+  return cj;
+}
+
+// Small universe: one trip (enter/exit node 0, dep 1 -> arr 2), an
+// interchange to a second departure (3) and three groups, the second of
+// which is released again.
+void build_universe(universe& uv) {
+  uv.graph_.push_back_node(mk_node(0U, INVALID_TIME, event_type::ARR, 0U));
+  uv.graph_.push_back_node(mk_node(1U, 600U, event_type::DEP, 1U));
+  uv.graph_.push_back_node(mk_node(2U, 660U, event_type::ARR, 2U));
+  uv.graph_.push_back_node(mk_node(3U, 670U, event_type::DEP, 2U));
+  uv.graph_.nodes_[3].valid_ = false;
+
+  for (auto i = 0U; i < 2U; ++i) {
+    uv.pax_connection_info_.insert();
+  }
+  uv.graph_.push_back_edge(mk_edge(1U, 2U, edge_type::TRIP, 0U));
+  uv.graph_.push_back_edge(mk_edge(2U, 3U, edge_type::INTERCHANGE, 1U));
+  uv.graph_.push_back_edge(mk_edge(0U, 1U, edge_type::INTERCHANGE, 0U));
+
+  auto const tdi = uv.trip_data_.insert_trip(17U, 0U);
+  uv.trip_data_.edges(tdi).emplace_back(edge_index{1U, 0U});
+  uv.trip_data_.canceled_nodes(tdi).emplace_back(3U);
+
+  uv.interchanges_at_station_[2].emplace_back(edge_index{2U, 0U});
+
+  auto* pg1 = uv.passenger_groups_.add(
+      make_passenger_group(mk_journey(17U, false), data_source{1U, 2U}, 12U,
+                           660U, group_source_flags::MATCH_INEXACT_TIME));
+  uv.passenger_groups_.add_edge(pg1->id_, edge_index{1U, 0U});
+  auto* pg2 = uv.passenger_groups_.add(make_passenger_group(
+      mk_journey(17U, false), data_source{3U, 4U}, 2U, 660U));
+  auto* pg3 = uv.passenger_groups_.add(make_passenger_group(
+      mk_journey(17U, true), data_source{5U, 6U}, 7U, 660U,
+      group_source_flags::FORECAST, 0.5F, 590U, 1U, 2U, 3));
+  pg3->ok_ = false;
+  uv.passenger_groups_.add_edge(pg3->id_, edge_index{1U, 0U});
+  uv.passenger_groups_.add_edge(pg3->id_, edge_index{2U, 0U});
+  uv.passenger_groups_.release(pg2->id_);
+
+  uv.pax_connection_info_.groups_[0].emplace_back(pg1->id_);
+  uv.pax_connection_info_.groups_[0].emplace_back(pg3->id_);
+  uv.pax_connection_info_.groups_[1].emplace_back(pg3->id_);
+  for (auto i = 0U; i < uv.pax_connection_info_.size(); ++i) {
+    uv.pax_connection_info_.init_expected_load(uv.passenger_groups_, i);
+  }
+}
+
+template <typename Bucket>
+auto to_vector(Bucket const& bucket) {
+  return std::vector<typename Bucket::value_type>(begin(bucket), end(bucket));
+}
+
+void expect_equal_nodes(event_node const& a, event_node const& b) {
+  EXPECT_EQ(a.index_, b.index_);
+  EXPECT_EQ(a.time_, b.time_);
+  EXPECT_EQ(a.schedule_time_, b.schedule_time_);
+  EXPECT_EQ(a.type_, b.type_);
+  EXPECT_EQ(a.valid_, b.valid_);
+  EXPECT_EQ(a.station_, b.station_);
+}
+
+void expect_equal_edges(edge const& a, edge const& b) {
+  EXPECT_EQ(a.from_, b.from_);
+  EXPECT_EQ(a.to_, b.to_);
+  EXPECT_EQ(a.type_, b.type_);
+  EXPECT_EQ(a.broken_, b.broken_);
+  EXPECT_EQ(a.transfer_time_, b.transfer_time_);
+  EXPECT_EQ(a.encoded_capacity_, b.encoded_capacity_);
+  EXPECT_EQ(a.clasz_, b.clasz_);
+  EXPECT_EQ(a.trips_, b.trips_);
+  EXPECT_EQ(a.pci_, b.pci_);
+}
+
+void expect_equal_groups(passenger_group_container const& pgc_a,
+                         passenger_group_container const& pgc_b,
+                         passenger_group_index const id) {
+  auto const* a = pgc_a[id];
+  auto const* b = pgc_b[id];
+  ASSERT_EQ(a == nullptr, b == nullptr);
+  EXPECT_EQ(pgc_a.valid(id), pgc_b.valid(id));
+  EXPECT_EQ(to_vector(pgc_a.edges(id)), to_vector(pgc_b.edges(id)));
+  if (a == nullptr) {
+    return;
+  }
+  EXPECT_EQ(a->compact_planned_journey_, b->compact_planned_journey_);
+  EXPECT_EQ(a->id_, b->id_);
+  EXPECT_EQ(a->source_, b->source_);
+  EXPECT_EQ(a->passengers(), b->passengers());
+  EXPECT_EQ(a->planned_arrival_time(), b->planned_arrival_time());
+  EXPECT_EQ(a->source_flags(), b->source_flags());
+  EXPECT_EQ(a->ok_, b->ok_);
+  EXPECT_EQ(a->added_time_, b->added_time_);
+  EXPECT_EQ(a->probability(), b->probability());
+  EXPECT_EQ(a->estimated_delay(), b->estimated_delay());
+  EXPECT_EQ(pgc_a.columns_.estimated_delay_[id],
+            pgc_b.columns_.estimated_delay_[id]);
+  EXPECT_EQ(a->generation_, b->generation_);
+  EXPECT_EQ(a->previous_version_, b->previous_version_);
+}
+
+struct paxmon_universe_snapshot : public ::testing::Test {
+  void SetUp() override {
+    path_ = (fs::temp_directory_path() /
+             fs::unique_path("paxmon_universe_%%%%-%%%%.bin"))
+                .generic_string();
+    build_universe(original_);
+    write_universe_snapshot(original_, path_, SCHEDULE_HASH, INPUT_HASH);
+  }
+
+  void TearDown() override { fs::remove(path_); }
+
+  std::string path_;
+  universe original_;
+};
+
+}  // namespace
+
+TEST_F(paxmon_universe_snapshot, round_trip) {
+  universe restored;
+  ASSERT_TRUE(
+      read_universe_snapshot(restored, path_, SCHEDULE_HASH, INPUT_HASH));
+
+  // graph
+  ASSERT_EQ(original_.graph_.node_count(), restored.graph_.node_count());
+  ASSERT_EQ(original_.graph_.edge_count(), restored.graph_.edge_count());
+  for (auto i = 0U; i < original_.graph_.node_count(); ++i) {
+    expect_equal_nodes(original_.graph_.nodes_[i], restored.graph_.nodes_[i]);
+    auto const a = original_.graph_.outgoing_edges(i);
+    auto const b = restored.graph_.outgoing_edges(i);
+    ASSERT_EQ(a.size(), b.size());
+    for (auto j = 0U; j < a.size(); ++j) {
+      expect_equal_edges(a[j], b[j]);
+    }
+    EXPECT_EQ(original_.graph_.incoming_edges(i).size(),
+              restored.graph_.incoming_edges(i).size());
+  }
+
+  // trip data
+  ASSERT_EQ(original_.trip_data_.size(), restored.trip_data_.size());
+  EXPECT_EQ(original_.trip_data_.get_index(17U),
+            restored.trip_data_.get_index(17U));
+  for (auto tdi = 0U; tdi < original_.trip_data_.size(); ++tdi) {
+    EXPECT_EQ(to_vector(original_.trip_data_.edges(tdi)),
+              to_vector(restored.trip_data_.edges(tdi)));
+    EXPECT_EQ(to_vector(original_.trip_data_.canceled_nodes(tdi)),
+              to_vector(restored.trip_data_.canceled_nodes(tdi)));
+    EXPECT_EQ(original_.trip_data_.enter_exit_node(tdi),
+              restored.trip_data_.enter_exit_node(tdi));
+  }
+
+  // pcis
+  ASSERT_EQ(original_.pax_connection_info_.size(),
+            restored.pax_connection_info_.size());
+  for (auto pci = 0U; pci < original_.pax_connection_info_.size(); ++pci) {
+    EXPECT_EQ(to_vector(original_.pax_connection_info_.groups(pci)),
+              to_vector(restored.pax_connection_info_.groups(pci)));
+    EXPECT_EQ(original_.pax_connection_info_.expected_load_[pci],
+              restored.pax_connection_info_.expected_load_[pci]);
+  }
+  EXPECT_EQ(12U, restored.pax_connection_info_.expected_load_[0]);
+
+  // interchanges
+  ASSERT_EQ(original_.interchanges_at_station_.index_size(),
+            restored.interchanges_at_station_.index_size());
+  for (auto i = 0U; i < original_.interchanges_at_station_.index_size();
+       ++i) {
+    EXPECT_EQ(to_vector(original_.interchanges_at_station_[i]),
+              to_vector(restored.interchanges_at_station_[i]));
+  }
+
+  // passenger groups (including the released index)
+  ASSERT_EQ(original_.passenger_groups_.size(),
+            restored.passenger_groups_.size());
+  EXPECT_EQ(original_.passenger_groups_.active_groups(),
+            restored.passenger_groups_.active_groups());
+  for (auto id = 0U; id < original_.passenger_groups_.size(); ++id) {
+    expect_equal_groups(original_.passenger_groups_,
+                        restored.passenger_groups_, id);
+  }
+  EXPECT_EQ(nullptr, restored.passenger_groups_[1]);
+}
+
+TEST_F(paxmon_universe_snapshot, outdated) {
+  universe schedule_changed;
+  EXPECT_FALSE(read_universe_snapshot(schedule_changed, path_,
+                                      SCHEDULE_HASH + 1U, INPUT_HASH));
+  EXPECT_EQ(0U, schedule_changed.graph_.node_count());
+
+  universe input_changed;
+  EXPECT_FALSE(read_universe_snapshot(input_changed, path_, SCHEDULE_HASH,
+                                      INPUT_HASH + 1U));
+  EXPECT_EQ(0U, input_changed.passenger_groups_.size());
+}
+
+}  // namespace motis::paxmon
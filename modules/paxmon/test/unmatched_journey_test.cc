@@ -0,0 +1,66 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "motis/paxmon/loader/unmatched_journey.h"
+
+using namespace testing;
+
+namespace motis::paxmon::loader {
+
+namespace {
+
+inline unmatched_journey mk_uj(std::uint32_t const from,
+                               std::uint32_t const to, time const dep,
+                               std::uint32_t const id) {
+  return unmatched_journey{from, to, dep, data_source{id, 0U}, 1U};
+}
+
+}  // namespace
+
+TEST(paxmon_unmatched_journeys, group_identical_queries_empty) {
+  EXPECT_TRUE(group_identical_queries({}).empty());
+}
+
+TEST(paxmon_unmatched_journeys, group_identical_queries) {
+  auto const ujs = std::vector<unmatched_journey>{
+      mk_uj(1, 2, 100, 0),  //
+      mk_uj(3, 4, 100, 1),  //
+      mk_uj(1, 2, 100, 2),  //
+      mk_uj(1, 2, 101, 3),  //
+      mk_uj(2, 1, 100, 4),  //
+      mk_uj(1, 3, 100, 5),  //
+      mk_uj(1, 2, 100, 6),  //
+      mk_uj(3, 4, 100, 7)};
+
+  auto const queries = group_identical_queries(ujs);
+
+  using indices = std::vector<std::size_t>;
+  EXPECT_THAT(queries, ElementsAre(indices{0, 2, 6}, indices{3}, indices{5},
+                                   indices{4}, indices{1, 7}));
+
+  for (auto const& q : queries) {
+    auto const& first = ujs[q.front()];
+    for (auto const i : q) {
+      EXPECT_EQ(first.start_station_idx_, ujs[i].start_station_idx_);
+      EXPECT_EQ(first.destination_station_idx_,
+                ujs[i].destination_station_idx_);
+      EXPECT_EQ(first.departure_time_, ujs[i].departure_time_);
+    }
+  }
+}
+
+TEST(paxmon_unmatched_journeys, group_identical_queries_distinct) {
+  auto const ujs = std::vector<unmatched_journey>{
+      mk_uj(5, 6, 300, 0), mk_uj(5, 6, 200, 1), mk_uj(1, 6, 300, 2)};
+
+  auto const queries = group_identical_queries(ujs);
+
+  using indices = std::vector<std::size_t>;
+  EXPECT_THAT(queries, ElementsAre(indices{2}, indices{1}, indices{0}));
+}
+
+}  // namespace motis::paxmon::loader
@@ -0,0 +1,118 @@
+// Routing benchmark on the schedule of the routing itests: runs pretrip
+// queries between all pairs of stations and reports the search time and
+// the label statistics. Used to compare label_bag (dominance check) changes
+// by running it on both versions.
+//
+// Usage: motis-routing-bench [iterations]
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "fmt/core.h"
+
+#include "motis/core/common/timing.h"
+#include "motis/core/access/time_access.h"
+#include "motis/module/clog_redirect.h"
+#include "motis/module/message.h"
+#include "motis/bootstrap/motis_instance.h"
+
+#include "motis/test/schedule/simple_realtime.h"
+
+#include "test_dir.h"
+
+namespace fs = boost::filesystem;
+
+using namespace flatbuffers;
+using namespace motis;
+using namespace motis::bootstrap;
+using namespace motis::module;
+using namespace motis::routing;
+
+namespace {
+
+msg_ptr make_query(schedule const& sched, station const& from,
+                   station const& to, SearchType const search_type) {
+  auto const interval =
+      Interval{unix_time(sched, 600), unix_time(sched, 2000)};
+  message_creator fbb;
+  fbb.create_and_finish(
+      MsgContent_RoutingRequest,
+      CreateRoutingRequest(
+          fbb, Start_PretripStart,
+          CreatePretripStart(
+              fbb,
+              CreateInputStation(fbb, fbb.CreateString(from.eva_nr_),
+                                 fbb.CreateString("")),
+              &interval, 0, false, false)
+              .Union(),
+          CreateInputStation(fbb, fbb.CreateString(to.eva_nr_),
+                             fbb.CreateString("")),
+          search_type, SearchDir_Forward,
+          fbb.CreateVector(std::vector<Offset<Via>>()),
+          fbb.CreateVector(std::vector<Offset<AdditionalEdgeWrapper>>()))
+          .Union(),
+      "/routing");
+  return make_msg(fbb);
+}
+
+}  // namespace
+
+int main(int argc, char const** argv) {
+  auto const iterations = argc > 1 ? std::atoi(argv[1]) : 10;
+  fs::current_path(MOTIS_TEST_EXECUTION_DIR);
+
+  auto const dataset_opt = test::schedule::simple_realtime::dataset_opt;
+  auto const modules = std::vector<std::string>{"routing"};
+  motis_instance instance;
+  import_settings import_opt;
+  for (auto const& dataset : dataset_opt.dataset_) {
+    import_opt.import_paths_.push_back(fmt::format("schedule:{}", dataset));
+  }
+  clog_redirect::set_enabled(false);
+  instance.import(module_settings{modules}, dataset_opt, import_opt, true);
+  instance.init_modules(module_settings{modules});
+
+  auto const& sched = instance.sched();
+  for (auto const search_type :
+       {SearchType_Default, SearchType_SingleCriterion}) {
+    auto queries = std::vector<msg_ptr>{};
+    for (auto const& from : sched.stations_) {
+      for (auto const& to : sched.stations_) {
+        if (from != to) {
+          queries.emplace_back(make_query(sched, *from, *to, search_type));
+        }
+      }
+    }
+
+    auto stats = std::map<std::string, std::uint64_t>{};
+    MOTIS_START_TIMING(total);
+    for (auto i = 0; i < iterations; ++i) {
+      for (auto const& q : queries) {
+        auto const res = motis_content(RoutingResponse, instance.call(q, 1U));
+        for (auto const* category : *res->statistics()) {
+          for (auto const* entry : *category->entries()) {
+            stats[entry->name()->str()] += entry->value();
+          }
+        }
+      }
+    }
+    MOTIS_STOP_TIMING(total);
+
+    auto const n = static_cast<double>(queries.size()) * iterations;
+    auto const total_us = static_cast<double>(MOTIS_TIMING_US(total));
+    std::cout << fmt::format(
+        "{}: {} queries, {:.1f} ms total, {:.3f} ms/query\n",
+        EnumNameSearchType(search_type), n, total_us / 1000.0,
+        total_us / 1000.0 / n);
+    for (auto const& [name, value] : stats) {
+      std::cout << fmt::format("  {:<32} {:12.1f}\n", name,
+                               static_cast<double>(value) / n);
+    }
+  }
+}
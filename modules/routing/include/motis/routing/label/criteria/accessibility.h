@@ -29,6 +29,13 @@ struct accessibility_updater {
 };
 
 struct accessibility_dominance {
+  static constexpr auto const PACKED_CRITERIA = 1U;
+
+  template <typename Label>
+  static void pack(Label const& l, uint16_t* criteria) {
+    criteria[0] = l.accessibility_;
+  }
+
   template <typename Label>
   struct domination_info {
     domination_info(Label const& a, Label const& b)
@@ -96,6 +96,14 @@ struct late_connections_updater {
 };
 
 struct late_connections_dominance {
+  static constexpr auto const PACKED_CRITERIA = 2U;
+
+  template <typename Label>
+  static void pack(Label const& l, uint16_t* criteria) {
+    criteria[0] = l.db_costs_;
+    criteria[1] = l.night_penalty_;
+  }
+
   template <typename Label>
   struct domination_info {
     domination_info(Label const& a, Label const& b)
@@ -44,6 +44,13 @@ struct travel_time_updater {
 };
 
 struct travel_time_dominance {
+  static constexpr auto const PACKED_CRITERIA = 1U;
+
+  template <typename Label>
+  static void pack(Label const& l, uint16_t* criteria) {
+    criteria[0] = l.travel_time_lb_;
+  }
+
   template <typename Label>
   struct domination_info {
     domination_info(Label const& a, Label const& b)
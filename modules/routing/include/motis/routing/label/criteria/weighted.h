@@ -55,6 +55,13 @@ struct weighted_updater {
 };
 
 struct weighted_dominance {
+  static constexpr auto const PACKED_CRITERIA = 1U;
+
+  template <typename Label>
+  static void pack(Label const& l, uint16_t* criteria) {
+    criteria[0] = l.weighted_lb_;
+  }
+
   template <typename Label>
   struct domination_info {
     domination_info(Label const& a, Label const& b)
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
 namespace motis::routing {
 
 template <typename TieBreaker, typename... Dominators>
@@ -24,4 +28,40 @@ struct dominance<TieBreaker> {
   }
 };
 
-}  // namespace motis::routing
\ No newline at end of file
+// A dominator can provide PACKED_CRITERIA values with pack() for which
+// "a dominates b" implies a.value <= b.value (e.g. lower bounds). Label bags
+// store these values contiguously to select dominance candidates without
+// accessing the labels. Dominators without PACKED_CRITERIA are only checked
+// by the full dominance test.
+template <typename Dominator, typename = void>
+struct packed_criteria_count : std::integral_constant<std::size_t, 0U> {};
+
+template <typename Dominator>
+struct packed_criteria_count<Dominator,
+                             std::void_t<decltype(Dominator::PACKED_CRITERIA)>>
+    : std::integral_constant<std::size_t, Dominator::PACKED_CRITERIA> {};
+
+template <typename Dominance>
+struct dominance_criteria;
+
+template <typename TieBreaker, typename... Dominators>
+struct dominance_criteria<dominance<TieBreaker, Dominators...>> {
+  static constexpr auto const SIZE =
+      (packed_criteria_count<Dominators>::value + ... + std::size_t{0U});
+
+  template <typename Label>
+  static void pack(Label const& l, uint16_t* criteria) {
+    (pack_dominator<Dominators>(l, criteria), ...);
+  }
+
+private:
+  template <typename Dominator, typename Label>
+  static void pack_dominator(Label const& l, uint16_t*& criteria) {
+    if constexpr (packed_criteria_count<Dominator>::value != 0U) {
+      Dominator::pack(l, criteria);
+      criteria += packed_criteria_count<Dominator>::value;
+    }
+  }
+};
+
+}  // namespace motis::routing
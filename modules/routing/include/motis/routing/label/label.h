@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+
 #include "motis/core/schedule/edges.h"
+#include "motis/routing/label/dominance.h"
 #include "motis/routing/lower_bounds.h"
 
 namespace motis::routing {
@@ -64,6 +67,13 @@ struct label : public Data {  // NOLINT
 
   inline bool is_filtered() { return Filter::is_filtered(*this); }
 
+  static constexpr auto const PACKED_CRITERIA =
+      dominance_criteria<Dominance>::SIZE;
+
+  void pack_criteria(uint16_t* criteria) const {
+    dominance_criteria<Dominance>::pack(*this, criteria);
+  }
+
   bool dominates(label const& o) const {
     if (incomparable(o)) {
       return false;
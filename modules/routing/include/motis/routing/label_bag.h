@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "motis/core/schedule/time.h"
+
+namespace motis::routing {
+
+// Pareto set of labels (e.g. all labels at a node).
+//
+// The labels are stored out of line (pointers). Next to them, the bag keeps
+// the values of each label that are necessary (but not sufficient) for
+// dominance in separate contiguous rows:
+//   - the departure/arrival interval (labels are incomparable if the
+//     intervals are not nested), the begin is stored inverted so that all
+//     rows compare with <=
+//   - the packed dominance criteria of the label (Label::PACKED_CRITERIA,
+//     e.g. travel time and transfer lower bounds, see dominance_criteria)
+// Rows are blocked by BLOCK_SIZE labels: block b stores row r of its labels
+// at keys_[(b * rows() + r) * BLOCK_SIZE + i]. A block row is compared in one
+// fixed-size loop that compilers translate into SIMD compares. Only labels
+// that pass all row comparisons are compared with the full label.
+//
+// The layout does not depend on Label (mem_manager reuses the bags for all
+// label types). Scratch memory for the indices of dominated labels is passed
+// in by the caller and shared by all bags of a search.
+template <typename Label>
+struct label_bag {
+  static constexpr auto const BLOCK_SIZE = 16U;
+
+  using key_t = uint16_t;
+
+  // Adds the label unless it is dominated by a label of the bag. A label
+  // already in the bag wins against an equal new label.
+  // Labels dominated by the new label are removed from the bag (swap-remove,
+  // the order of the labels is not preserved) and passed to on_dominated.
+  template <typename OnDominated>
+  bool add(Label* l, std::vector<std::size_t>& dominated,
+           OnDominated&& on_dominated) {
+    auto const k = keys(l);
+    auto const added = find_dominated<false>(l, k.data(), dominated);
+    // descending: swap-remove keeps the remaining (smaller) indices valid
+    for (auto it = dominated.rbegin(); it != dominated.rend(); ++it) {
+      auto const i = *it;
+      on_dominated(labels_[i]);
+      copy(labels_.size() - 1U, i);
+      pop_back();
+    }
+    if (added) {
+      push_back(l, k.data());
+    }
+    return added;
+  }
+
+  // Like add, but keeps the insertion order of the remaining labels and
+  // the new label replaces equal labels (result sets).
+  template <typename OnDominated>
+  bool add_stable(Label* l, std::vector<std::size_t>& dominated,
+                  OnDominated&& on_dominated) {
+    auto const k = keys(l);
+    auto const added = find_dominated<true>(l, k.data(), dominated);
+    if (!dominated.empty()) {
+      auto next_dominated = begin(dominated);
+      compact([&](std::size_t const i) {
+        if (next_dominated != end(dominated) && *next_dominated == i) {
+          on_dominated(labels_[i]);
+          ++next_dominated;
+          return true;
+        }
+        return false;
+      });
+    }
+    if (added) {
+      push_back(l, k.data());
+    }
+    return added;
+  }
+
+  bool is_dominated(Label const* l) const {
+    auto const k = keys(l);
+    for (auto block = std::size_t{0U}; block < labels_.size();
+         block += BLOCK_SIZE) {
+      for (auto mask = candidates<true>(block, k.data()); mask != 0U;
+           mask &= mask - 1U) {
+        if (labels_[block + first_bit(mask)]->dominates(*l)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  template <typename Fn>
+  void erase_if(Fn&& fn) {
+    compact([&](std::size_t const i) { return fn(labels_[i]); });
+  }
+
+  void push_back(Label* l) { push_back(l, keys(l).data()); }
+
+  void clear() {
+    labels_.clear();
+    keys_.clear();
+  }
+
+  Label* operator[](std::size_t const i) const { return labels_[i]; }
+
+  std::vector<Label*> labels() const { return labels_; }
+
+  std::size_t size() const { return labels_.size(); }
+  bool empty() const { return labels_.empty(); }
+
+private:
+  static constexpr std::size_t rows() { return 2U + Label::PACKED_CRITERIA; }
+
+  static auto keys(Label const* l) {
+    std::array<key_t, rows()> k;
+    k[0] = static_cast<key_t>(std::numeric_limits<key_t>::max() -
+                              l->current_begin());
+    k[1] = l->current_end();
+    l->pack_criteria(&k[2]);
+    return k;
+  }
+
+  key_t& key(std::size_t const i, std::size_t const row) {
+    return keys_[((i / BLOCK_SIZE) * rows() + row) * BLOCK_SIZE +
+                 i % BLOCK_SIZE];
+  }
+
+  void push_back(Label* l, key_t const* k) {
+    auto const i = labels_.size();
+    if (i % BLOCK_SIZE == 0U) {
+      keys_.resize(keys_.size() + rows() * BLOCK_SIZE);
+    }
+    for (auto row = 0U; row < rows(); ++row) {
+      key(i, row) = k[row];
+    }
+    labels_.push_back(l);
+  }
+
+  void pop_back() {
+    labels_.pop_back();
+    if (labels_.size() % BLOCK_SIZE == 0U) {
+      keys_.resize(keys_.size() - rows() * BLOCK_SIZE);
+    }
+  }
+
+  void copy(std::size_t const from, std::size_t const to) {
+    if (from == to) {
+      return;
+    }
+    labels_[to] = labels_[from];
+    for (auto row = 0U; row < rows(); ++row) {
+      key(to, row) = key(from, row);
+    }
+  }
+
+  // Removes all labels i with remove(i), keeps the order of the others.
+  template <typename Fn>
+  void compact(Fn&& remove) {
+    auto const size = labels_.size();
+    auto out = std::size_t{0U};
+    for (auto i = std::size_t{0U}; i < size; ++i) {
+      if (!remove(i)) {
+        copy(i, out++);
+      }
+    }
+    while (labels_.size() != out) {
+      pop_back();
+    }
+  }
+
+  // Bit i is set if label block + i passes all row comparisons:
+  // Dominating: key <= k (may dominate k), otherwise key >= k (may be
+  // dominated by k).
+  template <bool Dominating>
+  uint32_t candidates(std::size_t const block, key_t const* k) const {
+    auto const n = std::min(static_cast<std::size_t>(BLOCK_SIZE),
+                            labels_.size() - block);
+    auto const* block_keys = &keys_[(block / BLOCK_SIZE) * rows() * BLOCK_SIZE];
+    auto mask = (uint32_t{1U} << n) - 1U;
+    for (auto row = 0U; row < rows(); ++row) {
+      auto const* row_keys = block_keys + row * BLOCK_SIZE;
+      auto row_mask = uint32_t{0U};
+      for (auto i = 0U; i < BLOCK_SIZE; ++i) {
+        row_mask |= static_cast<uint32_t>(Dominating ? row_keys[i] <= k[row]
+                                                     : row_keys[i] >= k[row])
+                    << i;
+      }
+      mask &= row_mask;
+    }
+    return mask;
+  }
+
+  static unsigned first_bit(uint32_t const mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+    auto i = 0U;
+    while ((mask & (1U << i)) == 0U) {
+      ++i;
+    }
+    return i;
+#endif
+  }
+
+  // Collects the indices of the labels dominated by l in dominated
+  // (ascending). Candidates are visited in bag order. Returns false as soon
+  // as a label of the bag dominates l; the labels collected up to this point
+  // are still removed by the caller. If NewReplacesEqual is set, "l dominates
+  // the candidate" is checked first, so l replaces equal labels.
+  template <bool NewReplacesEqual>
+  bool find_dominated(Label const* l, key_t const* k,
+                      std::vector<std::size_t>& dominated) const {
+    dominated.clear();
+    for (auto block = std::size_t{0U}; block < labels_.size();
+         block += BLOCK_SIZE) {
+      auto const dominating_mask = candidates<true>(block, k);
+      auto const dominated_mask = candidates<false>(block, k);
+      for (auto mask = dominating_mask | dominated_mask; mask != 0U;
+           mask &= mask - 1U) {
+        auto const i = first_bit(mask);
+        auto const bit = uint32_t{1U} << i;
+        auto const* o = labels_[block + i];
+        if (NewReplacesEqual && (dominated_mask & bit) != 0U &&
+            l->dominates(*o)) {
+          dominated.push_back(block + i);
+        } else if ((dominating_mask & bit) != 0U && o->dominates(*l)) {
+          return false;
+        } else if (!NewReplacesEqual && (dominated_mask & bit) != 0U &&
+                   l->dominates(*o)) {
+          dominated.push_back(block + i);
+        }
+      }
+    }
+    return true;
+  }
+
+  std::vector<Label*> labels_;
+  std::vector<key_t> keys_;
+};
+
+}  // namespace motis::routing
@@ -3,8 +3,10 @@
 #include <cassert>
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include "motis/routing/allocator.h"
+#include "motis/routing/label_bag.h"
 
 namespace motis::routing {
 
@@ -42,9 +44,9 @@ public:
   }
 
   template <typename T>
-  std::vector<std::vector<T*>>* get_node_labels(std::size_t size) {
+  std::vector<label_bag<T>>* get_node_labels(std::size_t size) {
     node_labels_.resize(size);
-    return reinterpret_cast<std::vector<std::vector<T*>>*>(&node_labels_);
+    return reinterpret_cast<std::vector<label_bag<T>>*>(&node_labels_);
   }
 
   size_t allocations() const { return allocations_; }
@@ -54,7 +56,7 @@ public:
 private:
   size_t allocations_;
   allocator alloc_;
-  std::vector<std::vector<void*>> node_labels_;
+  std::vector<label_bag<void>> node_labels_;
 };
 
 }  // namespace motis::routing
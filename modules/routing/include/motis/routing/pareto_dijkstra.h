@@ -3,19 +3,38 @@
 #include <queue>
 
 #include "boost/container/vector.hpp"
-#include "utl/erase_if.h"
-
-#include "motis/hash_map.h"
 
 #include "motis/core/common/dial.h"
 
+#include "motis/routing/label_bag.h"
 #include "motis/routing/mem_manager.h"
+#include "motis/routing/query_edge_overlay.h"
 #include "motis/routing/statistics.h"
 
 namespace motis::routing {
 
 const bool FORWARDING = true;
 
+template <typename Label>
+void filter_results_post_search(label_bag<Label>& results) {
+  if (!Label::is_post_search_dominance_enabled()) {
+    return;
+  }
+  bool restart = false;
+  for (auto i = std::size_t{0U}; i < results.size();
+       i = restart ? 0U : i + 1U) {
+    restart = false;
+    auto const current = results[i];
+    std::size_t size_before = results.size();
+    results.erase_if([current](Label const* l) {
+      return l != current && current->dominates_post_search(*l);
+    });
+    if (results.size() != size_before) {
+      restart = true;
+    }
+  }
+}
+
 template <search_dir Dir, typename Label, typename LowerBounds>
 struct pareto_dijkstra {
   struct compare_labels {
@@ -31,7 +50,7 @@ struct pareto_dijkstra {
   pareto_dijkstra(
       int node_count, unsigned int station_node_count,
       boost::container::vector<bool> const& is_goal,
-      mcd::hash_map<node const*, std::vector<edge>> additional_edges,
+      query_edge_overlay<Dir> additional_edges,
       LowerBounds& lower_bounds, mem_manager& label_store)
       : is_goal_(is_goal),
         station_node_count_(station_node_count),
@@ -44,7 +63,7 @@ struct pareto_dijkstra {
   void add_start_labels(std::vector<Label*> const& start_labels) {
     for (auto const& l : start_labels) {
       if (!l->is_filtered()) {
-        node_labels_[l->get_node()->id_].emplace_back(l);
+        node_labels_[l->get_node()->id_].push_back(l);
         queue_.push(l);
       }
     }
@@ -95,12 +114,10 @@ struct pareto_dijkstra {
         continue;
       }
 
-      auto it = additional_edges_.find(label->get_node());
-      if (it != std::end(additional_edges_)) {
-        for (auto const& additional_edge : it->second) {
-          create_new_label(label, additional_edge);
-        }
-      }
+      additional_edges_.for_each_edge(
+          label->get_node(), [&](edge const& additional_edge) {
+            create_new_label(label, additional_edge);
+          });
 
       if (Dir == search_dir::FWD) {
         for (auto const& edge : label->get_node()->edges_) {
@@ -118,7 +135,7 @@ struct pareto_dijkstra {
 
   statistics get_statistics() const { return stats_; };
 
-  std::vector<Label*> const& get_results() { return results_; }
+  std::vector<Label*> get_results() const { return results_.labels(); }
 
 private:
   void create_new_label(Label* l, edge const& edge) {
@@ -167,75 +184,34 @@ private:
   }
 
   bool add_result(Label* terminal_label) {
-    for (auto it = results_.begin(); it != results_.end();) {
-      Label* o = *it;
-      if (terminal_label->dominates(*o)) {
-        label_store_.release(o);
-        it = results_.erase(it);
-      } else if (o->dominates(*terminal_label)) {
-        return false;
-      } else {
-        ++it;
-      }
+    // results keep their order (journey order of the response)
+    if (!results_.add_stable(terminal_label, dominated_,
+                             [&](Label* o) { label_store_.release(o); })) {
+      return false;
     }
-    results_.push_back(terminal_label);
     stats_.labels_popped_after_last_result_ = 0;
     return true;
   }
 
   bool add_label_to_node(Label* new_label, node const* dest) {
-    auto& dest_labels = node_labels_[dest->id_];
-    for (auto it = dest_labels.begin(); it != dest_labels.end();) {
-      Label* o = *it;
-      if (o->dominates(*new_label)) {
-        return false;
-      }
-
-      if (new_label->dominates(*o)) {
-        it = dest_labels.erase(it);
-        o->dominated_ = true;
-      } else {
-        ++it;
-      }
-    }
-
-    // it is very important for the performance to push front here
-    // because earlier labels tend not to dominate later ones (not comparable)
-    dest_labels.insert(std::begin(dest_labels), new_label);
-    return true;
+    return node_labels_[dest->id_].add(
+        new_label, dominated_, [](Label* o) { o->dominated_ = true; });
   }
 
-  bool dominated_by_results(Label* label) {
-    return std::any_of(begin(results_), end(results_), [&](auto&& result) {
-      return result->dominates(*label);
-    });
+  bool dominated_by_results(Label* label) const {
+    return results_.is_dominated(label);
   }
 
-  void filter_results() {
-    if (!Label::is_post_search_dominance_enabled()) {
-      return;
-    }
-    bool restart = false;
-    for (auto it = std::begin(results_); it != std::end(results_);
-         it = restart ? std::begin(results_) : std::next(it)) {
-      restart = false;
-      std::size_t size_before = results_.size();
-      utl::erase_if(results_, [it](Label const* l) {
-        return l != (*it) && (*it)->dominates_post_search(*l);
-      });
-      if (results_.size() != size_before) {
-        restart = true;
-      }
-    }
-  }
+  void filter_results() { filter_results_post_search(results_); }
 
   boost::container::vector<bool> const& is_goal_;
   unsigned int station_node_count_;
-  std::vector<std::vector<Label*>>& node_labels_;
+  std::vector<label_bag<Label>>& node_labels_;
   dial<Label*, Label::MAX_BUCKET, get_bucket> queue_;
   std::vector<Label*> equals_;
-  mcd::hash_map<node const*, std::vector<edge>> additional_edges_;
-  std::vector<Label*> results_;
+  query_edge_overlay<Dir> additional_edges_;
+  label_bag<Label> results_;
+  std::vector<std::size_t> dominated_;
   LowerBounds& lower_bounds_;
   mem_manager& label_store_;
   statistics stats_;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "motis/core/schedule/edges.h"
+
+namespace motis::routing {
+
+// Edges that only exist for one query (search_query::query_edges_), grouped
+// by their source node (in search direction).
+//
+// Only a few nodes have query edges: a bitset over all nodes answers the
+// common case (no query edges) without a lookup. Nodes with query edges
+// are found by binary search in a dense list.
+template <search_dir Dir>
+struct query_edge_overlay {
+  query_edge_overlay(std::vector<edge> const& query_edges,
+                     std::size_t const node_count)
+      : has_edges_((node_count + 63U) / 64U), edges_(query_edges) {
+    std::stable_sort(begin(edges_), end(edges_),
+                     [](edge const& a, edge const& b) {
+                       return a.get_source<Dir>()->id_ <
+                              b.get_source<Dir>()->id_;
+                     });
+    for (auto i = 0U; i < edges_.size(); ++i) {
+      auto const id = edges_[i].get_source<Dir>()->id_;
+      if (nodes_.empty() || nodes_.back() != id) {
+        nodes_.push_back(id);
+        offsets_.push_back(i);
+        if (id / 64U >= has_edges_.size()) {
+          has_edges_.resize(id / 64U + 1U);
+        }
+        has_edges_[id / 64U] |= uint64_t{1U} << (id % 64U);
+      }
+    }
+    offsets_.push_back(static_cast<uint32_t>(edges_.size()));
+  }
+
+  inline bool has_edges(node const* n) const {
+    auto const id = n->id_;
+    return id / 64U < has_edges_.size() &&
+           (has_edges_[id / 64U] & (uint64_t{1U} << (id % 64U))) != 0U;
+  }
+
+  template <typename Fn>
+  inline void for_each_edge(node const* n, Fn&& fn) const {
+    if (!has_edges(n)) {
+      return;
+    }
+    auto const it = std::lower_bound(begin(nodes_), end(nodes_), n->id_);
+    auto const idx = static_cast<std::size_t>(std::distance(begin(nodes_), it));
+    for (auto i = offsets_[idx]; i < offsets_[idx + 1]; ++i) {
+      fn(edges_[i]);
+    }
+  }
+
+  std::size_t size() const { return edges_.size(); }
+
+private:
+  std::vector<uint64_t> has_edges_;
+  std::vector<uint32_t> nodes_;  // sorted node ids with query edges
+  std::vector<uint32_t> offsets_;  // nodes_.size() + 1 entries into edges_
+  std::vector<edge> edges_;  // sorted by source node id
+};
+
+}  // namespace motis::routing
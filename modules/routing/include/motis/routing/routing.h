@@ -28,6 +28,9 @@ private:
   motis::module::msg_ptr route(motis::module::msg_ptr const&);
   motis::module::msg_ptr trip_to_connection(motis::module::msg_ptr const&);
 
+  unsigned parallel_intervals_{1U};
+  unsigned parallel_min_interval_{60U};  // minutes
+
   std::mutex mem_pool_mutex_;
   std::vector<std::unique_ptr<memory>> mem_pool_;
 };
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <memory>
+#include <numeric>
+
 #include "utl/to_vec.h"
 
 #include "motis/hash_map.h"
 
 #include "motis/core/common/timing.h"
 #include "motis/core/schedule/schedule.h"
+#include "motis/module/context/motis_parallel_for.h"
+#include "motis/routing/label_bag.h"
 #include "motis/routing/lower_bounds.h"
 #include "motis/routing/output/labels_to_journey.h"
 #include "motis/routing/pareto_dijkstra.h"
+#include "motis/routing/query_edge_overlay.h"
 
 namespace motis::routing {
 
@@ -27,6 +33,11 @@ struct search_query {
   bool use_dest_metas_{false};
   bool use_start_footpaths_{false};
   light_connection const* lcon_{nullptr};
+
+  // pretrip only: if set, the interval is split into
+  // sub_interval_mem_.size() + 1 sub-intervals which are searched in
+  // parallel (the first one uses mem_)
+  std::vector<mem_manager*> sub_interval_mem_;
 };
 
 struct search_result {
@@ -146,14 +157,16 @@ struct search {
       }
     }
 
-    mcd::hash_map<node const*, std::vector<edge>> additional_edges;
-    for (auto const& e : q.query_edges_) {
-      additional_edges[e.get_source<Dir>()].push_back(e);
+    if (!q.sub_interval_mem_.empty()) {
+      return search_sub_intervals(q, lbs, is_goal, start_edge, meta_edges,
+                                  MOTIS_TIMING_MS(travel_time_lb_timing),
+                                  MOTIS_TIMING_MS(transfers_lb_timing));
     }
 
     pareto_dijkstra<Dir, Label, lower_bounds> pd(
         q.sched_->next_node_id_, q.sched_->stations_.size(), is_goal,
-        std::move(additional_edges), lbs, *q.mem_);
+        query_edge_overlay<Dir>{q.query_edges_, q.sched_->next_node_id_}, lbs,
+        *q.mem_);
 
     auto const add_start_labels = [&](time interval_begin, time interval_end) {
       pd.add_start_labels(StartLabelGenerator::generate(
@@ -161,69 +174,22 @@ struct search {
           interval_begin, interval_end, q.lcon_, q.use_start_footpaths_));
     };
 
-    time const schedule_begin = SCHEDULE_OFFSET_MINUTES;
-    time const schedule_end =
-        (q.sched_->schedule_end_ - q.sched_->schedule_begin_) / 60;
-
-    auto const map_to_interval = [&schedule_begin, &schedule_end](time t) {
-      return std::min(schedule_end, std::max(schedule_begin, t));
-    };
-
     add_start_labels(q.interval_begin_, q.interval_end_);
 
     MOTIS_START_TIMING(pareto_dijkstra_timing);
-    auto max_interval_reached = false;
     auto interval_begin = q.interval_begin_;
     auto interval_end = q.interval_end_;
-
-    auto const departs_in_interval = [](Label const* l,
-                                        motis::time interval_begin,
-                                        motis::time interval_end) {
-      return interval_end == INVALID_TIME ||  // ontrip
-             (l->start_ >= interval_begin && l->start_ <= interval_end);
-    };
-
-    auto const number_of_results_in_interval =
-        [&interval_begin, &interval_end,
-         departs_in_interval](std::vector<Label*> const& labels) {
-          return std::count_if(begin(labels), end(labels), [&](Label const* l) {
-            return departs_in_interval(l, interval_begin, interval_end);
-          });
-        };
-
     auto search_iterations = 0UL;
-
-    while (!max_interval_reached) {
-      max_interval_reached =
-          (!q.extend_interval_earlier_ || interval_begin == schedule_begin) &&
-          (!q.extend_interval_later_ || interval_end == schedule_end);
-
+    while (true) {
       pd.search();
       ++search_iterations;
 
-      if (number_of_results_in_interval(pd.get_results()) >=
-          q.min_journey_count_) {
+      if (count_in_interval(pd.get_results(), interval_begin, interval_end) >=
+              q.min_journey_count_ ||
+          !extend_interval(q, interval_begin, interval_end, add_start_labels,
+                           add_start_labels)) {
         break;
       }
-
-      auto const new_interval_begin = q.extend_interval_earlier_
-                                          ? map_to_interval(interval_begin - 60)
-                                          : interval_begin;
-      auto const new_interval_end = q.extend_interval_later_
-                                        ? map_to_interval(interval_end + 60)
-                                        : interval_end;
-
-      if (interval_begin != schedule_begin) {
-        add_start_labels(new_interval_begin,
-                         map_to_interval(interval_begin - 1));
-      }
-
-      if (interval_end != schedule_end) {
-        add_start_labels(map_to_interval(interval_end + 1), new_interval_end);
-      }
-
-      interval_begin = new_interval_begin;
-      interval_end = new_interval_end;
     }
     MOTIS_STOP_TIMING(pareto_dijkstra_timing);
 
@@ -233,22 +199,180 @@ struct search {
     stats.pareto_dijkstra_ = MOTIS_TIMING_MS(pareto_dijkstra_timing);
     stats.interval_extensions_ = search_iterations - 1;
 
-    auto filtered = pd.get_results();
-    filtered.erase(std::remove_if(begin(filtered), end(filtered),
-                                  [&](Label const* l) {
-                                    return !departs_in_interval(
-                                        l, interval_begin, interval_end);
-                                  }),
-                   end(filtered));
+    return make_result(q, stats, pd.get_results(), interval_begin,
+                       interval_end);
+  }
+
+private:
+  using dijkstra_t = pareto_dijkstra<Dir, Label, lower_bounds>;
 
-    return search_result(stats,
-                         utl::to_vec(filtered,
+  static bool departs_in_interval(Label const* l, motis::time interval_begin,
+                                  motis::time interval_end) {
+    return interval_end == INVALID_TIME ||  // ontrip
+           (l->start_ >= interval_begin && l->start_ <= interval_end);
+  }
+
+  static std::size_t count_in_interval(std::vector<Label*> const& labels,
+                                       time interval_begin,
+                                       time interval_end) {
+    return static_cast<std::size_t>(
+        std::count_if(begin(labels), end(labels), [&](Label const* l) {
+          return departs_in_interval(l, interval_begin, interval_end);
+        }));
+  }
+
+  // Extends the interval by one hour in the directions requested by the
+  // query (limited to the schedule). Start labels for the new parts are
+  // added via add_earlier(begin, end) and add_later(begin, end).
+  // Returns false if the interval can not be extended any further.
+  template <typename AddEarlier, typename AddLater>
+  static bool extend_interval(search_query const& q, time& interval_begin,
+                              time& interval_end, AddEarlier&& add_earlier,
+                              AddLater&& add_later) {
+    time const schedule_begin = SCHEDULE_OFFSET_MINUTES;
+    time const schedule_end =
+        (q.sched_->schedule_end_ - q.sched_->schedule_begin_) / 60;
+
+    auto const map_to_interval = [&schedule_begin, &schedule_end](time t) {
+      return std::min(schedule_end, std::max(schedule_begin, t));
+    };
+
+    auto const extend_earlier =
+        q.extend_interval_earlier_ && interval_begin != schedule_begin;
+    auto const extend_later =
+        q.extend_interval_later_ && interval_end != schedule_end;
+    if (!extend_earlier && !extend_later) {
+      return false;
+    }
+
+    if (extend_earlier) {
+      auto const new_interval_begin = map_to_interval(interval_begin - 60);
+      add_earlier(new_interval_begin, map_to_interval(interval_begin - 1));
+      interval_begin = new_interval_begin;
+    }
+    if (extend_later) {
+      auto const new_interval_end = map_to_interval(interval_end + 60);
+      add_later(map_to_interval(interval_end + 1), new_interval_end);
+      interval_end = new_interval_end;
+    }
+    return true;
+  }
+
+  static search_result make_result(search_query const& q, statistics stats,
+                                   std::vector<Label*> labels,
+                                   time interval_begin, time interval_end) {
+    labels.erase(std::remove_if(begin(labels), end(labels),
+                                [&](Label const* l) {
+                                  return !departs_in_interval(
+                                      l, interval_begin, interval_end);
+                                }),
+                 end(labels));
+    return search_result(std::move(stats),
+                         utl::to_vec(labels,
                                      [&q](Label* label) {
                                        return output::labels_to_journey(
                                            *q.sched_, label, Dir);
                                      }),
                          interval_begin, interval_end);
   }
+
+  // Searches each sub-interval with its own pareto_dijkstra (and memory).
+  // Lower bounds are shared (read only). The results of all sub-intervals
+  // are merged into one pareto set. Interval extensions add start labels to
+  // the first (earlier) and last (later) sub-interval.
+  static search_result search_sub_intervals(
+      search_query const& q, lower_bounds& lbs,
+      boost::container::vector<bool> const& is_goal, edge const& start_edge,
+      std::vector<edge> const& meta_edges, uint64_t travel_time_lb_ms,
+      uint64_t transfers_lb_ms) {
+    std::vector<mem_manager*> mems{q.mem_};
+    mems.insert(end(mems), begin(q.sub_interval_mem_),
+                end(q.sub_interval_mem_));
+    auto const count = static_cast<unsigned>(mems.size());
+
+    std::vector<std::unique_ptr<dijkstra_t>> pds;
+    for (auto const mem : mems) {
+      pds.emplace_back(std::make_unique<dijkstra_t>(
+          q.sched_->next_node_id_, q.sched_->stations_.size(), is_goal,
+          query_edge_overlay<Dir>{q.query_edges_, q.sched_->next_node_id_},
+          lbs, *mem));
+    }
+
+    auto const add_start_labels = [&](unsigned const i, time interval_begin,
+                                      time interval_end) {
+      pds[i]->add_start_labels(StartLabelGenerator::generate(
+          *q.sched_, *mems[i], lbs, &start_edge, meta_edges, q.query_edges_,
+          interval_begin, interval_end, q.lcon_, q.use_start_footpaths_));
+    };
+
+    MOTIS_START_TIMING(pareto_dijkstra_timing);
+    auto interval_begin = q.interval_begin_;
+    auto interval_end = q.interval_end_;
+    auto const length = static_cast<unsigned>(interval_end - interval_begin);
+
+    std::vector<unsigned> pending(count);
+    std::iota(begin(pending), end(pending), 0U);
+    motis_parallel_for(pending, [&](unsigned const i) {
+      add_start_labels(
+          i, static_cast<time>(interval_begin + length * i / count),
+          i == count - 1U
+              ? interval_end
+              : static_cast<time>(interval_begin + length * (i + 1U) / count -
+                                  1U));
+      pds[i]->search();
+    });
+
+    label_bag<Label> results;
+    std::vector<std::size_t> dominated;
+    auto const merge_results = [&]() {
+      results.clear();
+      for (auto const& pd : pds) {
+        for (auto const l : pd->get_results()) {
+          // labels stay owned by the memory of their sub-interval
+          results.add_stable(l, dominated, [](Label*) {});
+        }
+      }
+      filter_results_post_search(results);
+      return count_in_interval(results.labels(), interval_begin, interval_end);
+    };
+
+    auto search_iterations = 1UL;
+    while (merge_results() < q.min_journey_count_) {
+      pending.clear();
+      auto const extended = extend_interval(
+          q, interval_begin, interval_end,
+          [&](time const b, time const e) {
+            add_start_labels(0U, b, e);
+            pending.push_back(0U);
+          },
+          [&](time const b, time const e) {
+            add_start_labels(count - 1U, b, e);
+            if (pending.empty() || pending.back() != count - 1U) {
+              pending.push_back(count - 1U);
+            }
+          });
+      if (!extended) {
+        break;
+      }
+
+      motis_parallel_for(pending, [&](unsigned const i) { pds[i]->search(); });
+      ++search_iterations;
+    }
+    MOTIS_STOP_TIMING(pareto_dijkstra_timing);
+
+    statistics stats;
+    for (auto const& pd : pds) {
+      stats += pd->get_statistics();
+    }
+    stats.travel_time_lb_ = travel_time_lb_ms;
+    stats.transfers_lb_ = transfers_lb_ms;
+    stats.pareto_dijkstra_ = MOTIS_TIMING_MS(pareto_dijkstra_timing);
+    stats.interval_extensions_ = search_iterations - 1;
+    stats.sub_intervals_ = count;
+
+    return make_result(q, stats, results.labels(), interval_begin,
+                       interval_end);
+  }
 };
 
 }  // namespace motis::routing
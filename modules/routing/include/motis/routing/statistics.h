@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <ostream>
 
 #include "utl/to_vec.h"
@@ -35,6 +36,24 @@ struct statistics {
   uint64_t num_bytes_in_use_{};
   uint64_t labels_to_journey_{};
   uint64_t interval_extensions_{};
+  uint64_t sub_intervals_{};
+
+  statistics& operator+=(statistics const& o) {
+    max_label_quit_ = max_label_quit_ || o.max_label_quit_;
+    labels_created_ += o.labels_created_;
+    labels_popped_ += o.labels_popped_;
+    labels_dominated_by_results_ += o.labels_dominated_by_results_;
+    labels_filtered_ += o.labels_filtered_;
+    labels_dominated_by_former_labels_ += o.labels_dominated_by_former_labels_;
+    labels_dominated_by_later_labels_ += o.labels_dominated_by_later_labels_;
+    labels_popped_until_first_result_ += o.labels_popped_until_first_result_;
+    labels_popped_after_last_result_ += o.labels_popped_after_last_result_;
+    priority_queue_max_size_ =
+        std::max(priority_queue_max_size_, o.priority_queue_max_size_);
+    start_label_count_ += o.start_label_count_;
+    labels_equals_popped_ += o.labels_equals_popped_;
+    return *this;
+  }
 
   friend flatbuffers::Offset<Statistics> to_fbs(
       flatbuffers::FlatBufferBuilder& fbb, char const* category,
@@ -71,6 +90,7 @@ struct statistics {
     add_entry("transfers_lb", s.transfers_lb_);
     add_entry("travel_time_lb", s.travel_time_lb_);
     add_entry("interval_extensions", s.interval_extensions_);
+    add_entry("sub_intervals", s.sub_intervals_);
 
     return CreateStatistics(fbb, fbb.CreateString(category),
                             fbb.CreateVectorOfSortedTables(&stats));
@@ -102,7 +122,8 @@ struct statistics {
          {"total_calculation_time", s.total_calculation_time_},
          {"transfers_lb", s.transfers_lb_},
          {"travel_time_lb", s.travel_time_lb_},
-         {"interval_extensions", s.interval_extensions_}}};
+         {"interval_extensions", s.interval_extensions_},
+         {"sub_intervals", s.sub_intervals_}}};
   }
 };
 
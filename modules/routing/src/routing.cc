@@ -1,5 +1,9 @@
 #include "motis/routing/routing.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "boost/date_time/gregorian/gregorian_types.hpp"
 #include "boost/date_time/posix_time/posix_time.hpp"
 #include "boost/program_options.hpp"
@@ -33,7 +37,13 @@ using namespace motis::module;
 
 namespace motis::routing {
 
-routing::routing() : module("Routing", "routing") {}
+routing::routing() : module("Routing", "routing") {
+  param(parallel_intervals_, "parallel_intervals",
+        "max. number of sub-intervals searched in parallel by pretrip "
+        "queries (1 = sequential search)");
+  param(parallel_min_interval_, "parallel_min_interval",
+        "min. length of a sub-interval in minutes");
+}
 
 routing::~routing() = default;
 
@@ -68,6 +78,21 @@ msg_ptr routing::route(msg_ptr const& msg) {
   mem_retriever mem(mem_pool_mutex_, mem_pool_, LABEL_STORE_START_SIZE);
   query.mem_ = &mem.get();
 
+  std::vector<std::unique_ptr<mem_retriever>> sub_interval_mem;
+  if (req->start_type() == Start_PretripStart &&
+      query.interval_end_ > query.interval_begin_) {
+    auto const length =
+        static_cast<unsigned>(query.interval_end_ - query.interval_begin_);
+    auto const sub_intervals =
+        std::clamp(length / std::max(parallel_min_interval_, 1U), 1U,
+                   std::max(parallel_intervals_, 1U));
+    for (auto i = 1U; i < sub_intervals; ++i) {
+      sub_interval_mem.emplace_back(std::make_unique<mem_retriever>(
+          mem_pool_mutex_, mem_pool_, LABEL_STORE_START_SIZE));
+      query.sub_interval_mem_.push_back(&sub_interval_mem.back()->get());
+    }
+  }
+
   auto res = search_dispatch(query, req->start_type(), req->search_type(),
                              req->search_dir());
 
@@ -75,6 +100,10 @@ msg_ptr routing::route(msg_ptr const& msg) {
   res.stats_.total_calculation_time_ = MOTIS_TIMING_MS(routing_timing);
   res.stats_.labels_created_ = query.mem_->allocations();
   res.stats_.num_bytes_in_use_ = query.mem_->get_num_bytes_in_use();
+  for (auto const sub_mem : query.sub_interval_mem_) {
+    res.stats_.labels_created_ += sub_mem->allocations();
+    res.stats_.num_bytes_in_use_ += sub_mem->get_num_bytes_in_use();
+  }
 
   message_creator fbb;
   std::vector<flatbuffers::Offset<Statistics>> stats{
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "motis/routing/label_bag.h"
+
+namespace motis::routing {
+
+namespace {
+
+struct test_label {
+  time current_begin() const { return start_; }
+  time current_end() const { return now_; }
+
+  static constexpr auto const PACKED_CRITERIA = 2U;
+  void pack_criteria(uint16_t* criteria) const {
+    criteria[0] = travel_time_lb_;
+    criteria[1] = transfers_lb_;
+  }
+
+  bool dominates(test_label const& o) const {
+    return current_begin() >= o.current_begin() &&
+           current_end() <= o.current_end() &&
+           travel_time_lb_ <= o.travel_time_lb_ &&
+           transfers_lb_ <= o.transfers_lb_;
+  }
+
+  time start_{}, now_{};
+  duration travel_time_lb_{};
+  uint8_t transfers_lb_{};
+  bool dominated_{false};
+};
+
+// reference: previous implementation of pareto_dijkstra::add_label_to_node
+bool add_to_vector(std::vector<test_label*>& labels, test_label* new_label) {
+  for (auto it = labels.begin(); it != labels.end();) {
+    auto* o = *it;
+    if (o->dominates(*new_label)) {
+      return false;
+    }
+    if (new_label->dominates(*o)) {
+      it = labels.erase(it);
+      o->dominated_ = true;
+    } else {
+      ++it;
+    }
+  }
+  labels.insert(std::begin(labels), new_label);
+  return true;
+}
+
+std::vector<test_label> random_labels(std::size_t const count) {
+  std::mt19937 gen{42};  // NOLINT
+  std::uniform_int_distribution<int> start_dist{600, 720};
+  std::uniform_int_distribution<int> duration_dist{30, 240};
+  std::uniform_int_distribution<int> transfers_dist{0, 6};
+  std::vector<test_label> labels(count);
+  for (auto& l : labels) {
+    l.start_ = static_cast<time>(start_dist(gen));
+    l.now_ = static_cast<time>(l.start_ + duration_dist(gen));
+    l.travel_time_lb_ = static_cast<duration>(l.now_ - l.start_);
+    l.transfers_lb_ = static_cast<uint8_t>(transfers_dist(gen));
+  }
+  return labels;
+}
+
+std::vector<std::ptrdiff_t> sorted_indices(
+    std::vector<test_label*> const& labels, std::vector<test_label>& all) {
+  std::vector<std::ptrdiff_t> result;
+  for (auto const* l : labels) {
+    result.push_back(l - all.data());
+  }
+  std::sort(begin(result), end(result));
+  return result;
+}
+
+}  // namespace
+
+TEST(routing_label_bag, same_as_vector) {
+  auto vector_labels = random_labels(20000U);
+  auto bag_labels = vector_labels;
+
+  std::vector<test_label*> v;
+  for (auto& l : vector_labels) {
+    add_to_vector(v, &l);
+  }
+
+  label_bag<test_label> bag;
+  std::vector<std::size_t> dominated;
+  for (auto& l : bag_labels) {
+    bag.add(&l, dominated, [](test_label* o) { o->dominated_ = true; });
+  }
+
+  ASSERT_EQ(v.size(), bag.size());
+  for (auto i = 0U; i < vector_labels.size(); ++i) {
+    EXPECT_EQ(vector_labels[i].dominated_, bag_labels[i].dominated_);
+  }
+  EXPECT_EQ(sorted_indices(v, vector_labels),
+            sorted_indices(bag.labels(), bag_labels));
+
+  for (auto const& l : random_labels(1000U)) {
+    EXPECT_EQ(std::any_of(begin(v), end(v),
+                          [&](test_label const* o) { return o->dominates(l); }),
+              bag.is_dominated(&l));
+  }
+}
+
+TEST(routing_label_bag, add_stable_keeps_order) {
+  auto labels = random_labels(1000U);
+  label_bag<test_label> bag;
+  std::vector<std::size_t> dominated;
+  for (auto& l : labels) {
+    bag.add_stable(&l, dominated, [](test_label*) {});
+  }
+  auto const bag_labels = bag.labels();
+  EXPECT_TRUE(std::is_sorted(begin(bag_labels), end(bag_labels)));
+}
+
+TEST(routing_label_bag, equal_labels) {
+  std::vector<test_label> labels(2U);
+  for (auto& l : labels) {
+    l.start_ = 600;
+    l.now_ = 660;
+    l.travel_time_lb_ = 60;
+    l.transfers_lb_ = 1;
+  }
+  std::vector<std::size_t> dominated;
+
+  // node labels: the existing label wins
+  label_bag<test_label> node_bag;
+  EXPECT_TRUE(node_bag.add(&labels[0], dominated, [](test_label*) {}));
+  EXPECT_FALSE(node_bag.add(&labels[1], dominated, [](test_label*) {}));
+  ASSERT_EQ(1U, node_bag.size());
+  EXPECT_EQ(&labels[0], node_bag[0]);
+
+  // results (terminal labels): the new label replaces the existing one
+  label_bag<test_label> results;
+  std::vector<test_label*> released;
+  auto const release = [&](test_label* o) { released.push_back(o); };
+  EXPECT_TRUE(results.add_stable(&labels[0], dominated, release));
+  EXPECT_TRUE(results.add_stable(&labels[1], dominated, release));
+  ASSERT_EQ(1U, results.size());
+  EXPECT_EQ(&labels[1], results[0]);
+  EXPECT_EQ(std::vector<test_label*>{&labels[0]}, released);
+}
+
+}  // namespace motis::routing
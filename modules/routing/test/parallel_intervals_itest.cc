@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "motis/core/journey/journey.h"
+#include "motis/core/journey/message_to_journeys.h"
+#include "motis/module/message.h"
+#include "motis/routing/build_query.h"
+#include "motis/routing/mem_manager.h"
+#include "motis/routing/search_dispatch.h"
+#include "motis/test/motis_instance_test.h"
+#include "motis/test/schedule/simple_realtime.h"
+
+using namespace flatbuffers;
+using namespace motis;
+using namespace motis::test;
+using namespace motis::module;
+using namespace motis::routing;
+using motis::test::schedule::simple_realtime::dataset_opt;
+
+using journey_key = std::tuple<std::time_t, std::time_t, unsigned>;
+
+struct routing_parallel_intervals_itest : public motis_instance_test {
+  routing_parallel_intervals_itest()
+      : motis::test::motis_instance_test(
+            dataset_opt, {"routing"},
+            {"--routing.parallel_intervals=4",
+             "--routing.parallel_min_interval=30"}) {}
+
+  msg_ptr make_pretrip_request(int const begin, int const end,
+                               int const min_connection_count) {
+    message_creator fbb;
+    auto const interval = Interval(unix_time(begin), unix_time(end));
+    fbb.create_and_finish(
+        MsgContent_RoutingRequest,
+        CreateRoutingRequest(
+            fbb, Start_PretripStart,
+            CreatePretripStart(
+                fbb,
+                CreateInputStation(fbb, fbb.CreateString("8000096"),
+                                   fbb.CreateString("")),
+                &interval, min_connection_count, min_connection_count != 0,
+                min_connection_count != 0)
+                .Union(),
+            CreateInputStation(fbb, fbb.CreateString("8000080"),
+                               fbb.CreateString("")),
+            SearchType_Default, SearchDir_Forward,
+            fbb.CreateVector(std::vector<Offset<Via>>()),
+            fbb.CreateVector(std::vector<Offset<AdditionalEdgeWrapper>>()))
+            .Union(),
+        "/routing");
+    return make_msg(fbb);
+  }
+
+  static std::vector<journey_key> to_keys(std::vector<journey> const& js) {
+    std::vector<journey_key> keys;
+    for (auto const& j : js) {
+      keys.emplace_back(j.stops_.front().departure_.schedule_timestamp_,
+                        j.stops_.back().arrival_.schedule_timestamp_,
+                        j.transfers_);
+    }
+    std::sort(begin(keys), end(keys));
+    return keys;
+  }
+
+  std::vector<journey_key> sequential(msg_ptr const& msg) {
+    auto const req = motis_content(RoutingRequest, msg);
+    mem_manager mem{16 * 1024 * 1024};
+    auto query = build_query(sched(), req);
+    query.mem_ = &mem;
+    auto const res = search_dispatch(query, req->start_type(),
+                                     req->search_type(), req->search_dir());
+    return to_keys(res.journeys_);
+  }
+
+  std::vector<journey_key> parallel(msg_ptr const& msg) {
+    return to_keys(
+        message_to_journeys(motis_content(RoutingResponse, call(msg))));
+  }
+};
+
+TEST_F(routing_parallel_intervals_itest, same_journeys_as_sequential) {
+  auto const msg = make_pretrip_request(1100, 1900, 0);
+  auto const reference = sequential(msg);
+  EXPECT_FALSE(reference.empty());
+  EXPECT_EQ(reference, parallel(msg));
+}
+
+TEST_F(routing_parallel_intervals_itest, interval_extension) {
+  auto const msg = make_pretrip_request(1300, 1400, 5);
+  EXPECT_EQ(sequential(msg), parallel(msg));
+}
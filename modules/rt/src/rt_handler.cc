@@ -302,6 +302,7 @@ void rt_handler::propagate() {
   }
 
   for (auto const& re : updated_route_edges) {
+    re->update_lcon_times();
     constant_graph_add_route_edge(sched_, re);
   }
 
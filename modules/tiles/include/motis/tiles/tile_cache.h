@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "geo/tile.h"
+
+namespace motis::tiles {
+
+struct tile_cache_statistics {
+  std::uint64_t hits_{};
+  std::uint64_t misses_{};
+  std::uint64_t coalesced_{};
+  std::uint64_t evictions_{};
+  std::uint64_t render_time_us_{};
+  std::uint64_t entries_{};
+  std::uint64_t size_bytes_{};
+};
+
+// Size-bounded LRU cache for rendered (compressed) tiles.
+// Concurrent requests for the same missing tile wait for a single render.
+struct tile_cache {
+  // nullptr = empty tile
+  using tile_data_t = std::shared_ptr<std::string const>;
+  using render_fn_t = std::function<std::optional<std::string>()>;
+
+  explicit tile_cache(std::size_t max_size_bytes);
+
+  tile_data_t get_or_render(geo::tile const&, render_fn_t const&);
+
+  void clear();
+
+  std::size_t max_size_bytes() const { return max_size_bytes_; }
+
+  tile_cache_statistics get_statistics() const;
+
+private:
+  using key_t = std::uint64_t;
+
+  struct entry {
+    std::shared_future<tile_data_t> data_;
+    std::list<key_t>::iterator lru_it_;
+    std::size_t size_{0U};
+    std::uint64_t render_id_{0U};
+    bool ready_{false};
+  };
+
+  static key_t to_key(geo::tile const&);
+  static std::size_t entry_size(tile_data_t const&);
+
+  void evict();
+
+  std::size_t max_size_bytes_;
+  std::size_t size_bytes_{0U};
+  std::uint64_t next_render_id_{0U};
+
+  mutable std::mutex mutex_;
+  std::unordered_map<key_t, entry> entries_;
+  std::list<key_t> lru_;  // front = most recently used
+  tile_cache_statistics stats_;
+};
+
+}  // namespace motis::tiles
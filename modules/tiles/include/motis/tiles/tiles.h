@@ -24,6 +24,8 @@ struct tiles : public motis::module::module {
   size_t db_size_{sizeof(void*) >= 8 ? 1024ULL * 1024 * 1024 * 1024
                                      : 256 * 1024 * 1024};
   size_t flush_threshold_{sizeof(void*) >= 8 ? 10'000'000 : 100'000};
+  size_t cache_size_{256ULL * 1024 * 1024};
+  int prerender_max_zoom_{-1};
 
   struct data;
   std::unique_ptr<data> data_;
@@ -0,0 +1,112 @@
+#include "motis/tiles/tile_cache.h"
+
+#include <chrono>
+
+namespace motis::tiles {
+
+// Approximate memory overhead per cache entry (map node, list node, ...).
+constexpr auto const kEntryOverhead = std::size_t{128U};
+
+tile_cache::tile_cache(std::size_t const max_size_bytes)
+    : max_size_bytes_{max_size_bytes} {}
+
+tile_cache::key_t tile_cache::to_key(geo::tile const& t) {
+  return (static_cast<key_t>(t.z_) << 58U) | (static_cast<key_t>(t.x_) << 29U) |
+         static_cast<key_t>(t.y_);
+}
+
+std::size_t tile_cache::entry_size(tile_data_t const& data) {
+  return kEntryOverhead + (data == nullptr ? 0U : data->size());
+}
+
+tile_cache::tile_data_t tile_cache::get_or_render(geo::tile const& t,
+                                                  render_fn_t const& render) {
+  auto const key = to_key(t);
+
+  std::promise<tile_data_t> promise;
+  auto render_id = std::uint64_t{};
+  {
+    std::unique_lock lock{mutex_};
+    if (auto const it = entries_.find(key); it != end(entries_)) {
+      lru_.splice(begin(lru_), lru_, it->second.lru_it_);
+      if (it->second.ready_) {
+        ++stats_.hits_;
+      } else {
+        ++stats_.coalesced_;
+      }
+      auto const data = it->second.data_;
+      lock.unlock();
+      return data.get();
+    }
+
+    ++stats_.misses_;
+    render_id = next_render_id_++;
+    lru_.push_front(key);
+    entries_.emplace(key, entry{promise.get_future().share(), begin(lru_), 0U,
+                                render_id, false});
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  auto data = tile_data_t{};
+  try {
+    if (auto rendered = render(); rendered.has_value()) {
+      data = std::make_shared<std::string const>(std::move(*rendered));
+    }
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+    std::lock_guard const lock{mutex_};
+    if (auto const it = entries_.find(key);
+        it != end(entries_) && it->second.render_id_ == render_id) {
+      lru_.erase(it->second.lru_it_);
+      entries_.erase(it);
+    }
+    throw;
+  }
+  auto const render_time =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+  promise.set_value(data);
+
+  std::lock_guard const lock{mutex_};
+  stats_.render_time_us_ += static_cast<std::uint64_t>(render_time.count());
+  if (auto const it = entries_.find(key);
+      it != end(entries_) && it->second.render_id_ == render_id) {
+    it->second.ready_ = true;
+    it->second.size_ = entry_size(data);
+    size_bytes_ += it->second.size_;
+    evict();
+  }
+  return data;
+}
+
+void tile_cache::evict() {
+  auto it = end(lru_);
+  while (size_bytes_ > max_size_bytes_ && it != begin(lru_)) {
+    --it;
+    auto const entry_it = entries_.find(*it);
+    if (!entry_it->second.ready_) {
+      continue;  // still rendering, keep it for coalesced requests
+    }
+    size_bytes_ -= entry_it->second.size_;
+    entries_.erase(entry_it);
+    it = lru_.erase(it);
+    ++stats_.evictions_;
+  }
+}
+
+void tile_cache::clear() {
+  std::lock_guard const lock{mutex_};
+  entries_.clear();
+  lru_.clear();
+  size_bytes_ = 0U;
+}
+
+tile_cache_statistics tile_cache::get_statistics() const {
+  std::lock_guard const lock{mutex_};
+  auto stats = stats_;
+  stats.entries_ = entries_.size();
+  stats.size_bytes_ = size_bytes_;
+  return stats;
+}
+
+}  // namespace motis::tiles
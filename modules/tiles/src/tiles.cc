@@ -1,9 +1,16 @@
 #include "motis/tiles/tiles.h"
 
+#include <cstdint>
 #include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "boost/filesystem.hpp"
 
+#include "fmt/format.h"
+
 #include "lmdb/lmdb.hpp"
 
 #include "net/web_server/url_decode.h"
@@ -22,13 +29,16 @@
 #include "tiles/parse_tile_url.h"
 #include "tiles/perf_counter.h"
 
+#include "utl/parallel_for.h"
 #include "utl/progress_tracker.h"
 #include "utl/verify.h"
 
+#include "motis/core/common/logging.h"
 #include "motis/module/event_collector.h"
 #include "motis/module/ini_io.h"
 
 #include "motis/tiles/error.h"
+#include "motis/tiles/tile_cache.h"
 
 #include "pbf_sdf_fonts_res.h"
 
@@ -51,17 +61,92 @@ struct import_state {
   mm::named<uint64_t, MOTIS_NAME("coastline_size")> coastline_size_;
 };
 
+// Render times per ::tiles::perf_counter stage, summed over all renders.
+// Stage i corresponds to the i-th task of the tiles perf counter.
+struct render_stage_statistics {
+  struct stage {
+    std::uint64_t count_{};
+    std::uint64_t total_us_{};
+  };
+
+  void add(::tiles::perf_counter const& pc) {
+    std::lock_guard const lock{mutex_};
+    if (stages_.size() < pc.finished_.size()) {
+      stages_.resize(pc.finished_.size());
+    }
+    for (auto i = 0U; i < pc.finished_.size(); ++i) {
+      for (auto const t : pc.finished_[i]) {
+        ++stages_[i].count_;
+        stages_[i].total_us_ += static_cast<std::uint64_t>(t);
+      }
+    }
+  }
+
+  std::vector<stage> get() const {
+    std::lock_guard const lock{mutex_};
+    return stages_;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<stage> stages_;
+};
+
 struct tiles::data {
-  explicit data(std::string const& path, size_t const db_size)
+  data(std::string const& path, size_t const db_size, size_t const cache_size)
       : db_env_{::tiles::make_tile_database(path.c_str(), db_size)},
         db_handle_{db_env_},
         render_ctx_{::tiles::make_render_ctx(db_handle_)},
-        pack_handle_{path.c_str()} {}
+        pack_handle_{path.c_str()},
+        cache_{cache_size} {}
+
+  std::optional<std::string> render(geo::tile const& tile) {
+    ::tiles::perf_counter pc;
+    auto rendered =
+        ::tiles::get_tile(db_handle_, pack_handle_, render_ctx_, tile, pc);
+    render_stats_.add(pc);
+    return rendered;
+  }
+
+  tile_cache::tile_data_t get_tile(geo::tile const& tile) {
+    if (cache_.max_size_bytes() == 0U) {
+      auto rendered = render(tile);
+      return rendered.has_value()
+                 ? std::make_shared<std::string const>(std::move(*rendered))
+                 : nullptr;
+    }
+    return cache_.get_or_render(tile, [&]() { return render(tile); });
+  }
+
+  void prerender(int const max_zoom) {
+    if (max_zoom < 0 || cache_.max_size_bytes() == 0U) {
+      return;
+    }
+
+    motis::logging::scoped_timer timer{"tiles prerender"};
+    for (auto z = 0U; z <= static_cast<unsigned>(max_zoom); ++z) {
+      auto const tiles_per_axis = 1U << z;
+      std::vector<geo::tile> tiles;
+      tiles.reserve(static_cast<std::size_t>(tiles_per_axis) * tiles_per_axis);
+      for (auto x = 0U; x < tiles_per_axis; ++x) {
+        for (auto y = 0U; y < tiles_per_axis; ++y) {
+          tiles.emplace_back(geo::tile{x, y, z});
+        }
+      }
+      utl::parallel_for(tiles,
+                        [&](geo::tile const& tile) { (void)get_tile(tile); });
+    }
+    auto const stats = cache_.get_statistics();
+    LOG(logging::info) << "tiles prerender: " << stats.entries_
+                       << " tiles cached (" << stats.size_bytes_ << " bytes)";
+  }
 
   lmdb::env db_env_;
   ::tiles::tile_db_handle db_handle_;
   ::tiles::render_ctx render_ctx_;
   ::tiles::pack_handle pack_handle_;
+  tile_cache cache_;
+  render_stage_statistics render_stats_;
 };
 
 tiles::tiles() : mm::module("Tiles", "tiles") {
@@ -70,6 +155,11 @@ tiles::tiles() : mm::module("Tiles", "tiles") {
   param(flush_threshold_, "import.flush_threshold",
         "shared metadata max queue size");
   param(db_size_, "db_size", "database size");
+  param(cache_size_, "cache_size",
+        "rendered tile cache size in bytes (0 = disabled)");
+  param(prerender_max_zoom_, "prerender_max_zoom",
+        "render all tiles up to this zoom level into the cache on startup "
+        "(-1 = disabled)");
 }
 
 tiles::~tiles() = default;
@@ -145,7 +235,7 @@ void tiles::import(mm::import_dispatcher& reg) {
         }
 
         mm::write_ini(dir / "import.ini", state);
-        data_ = std::make_unique<data>(path, db_size_);
+        data_ = std::make_unique<data>(path, db_size_, cache_size_);
       });
   collector->require("OSM", [](mm::msg_ptr const& msg) {
     return msg->get()->content_type() == MsgContent_OSMEvent;
@@ -158,6 +248,10 @@ void tiles::import(mm::import_dispatcher& reg) {
 }
 
 void tiles::init(mm::registry& reg) {
+  if (data_ != nullptr) {
+    data_->prerender(prerender_max_zoom_);
+  }
+
   reg.register_op("/tiles", [&](auto const& msg) {
     auto tile =
         ::tiles::parse_tile_url(msg->get()->destination()->target()->str());
@@ -165,9 +259,7 @@ void tiles::init(mm::registry& reg) {
       throw std::system_error(error::invalid_request);
     }
 
-    ::tiles::null_perf_counter pc;
-    auto rendered_tile = ::tiles::get_tile(
-        data_->db_handle_, data_->pack_handle_, data_->render_ctx_, *tile, pc);
+    auto const rendered_tile = data_->get_tile(*tile);
 
     mm::message_creator mc;
     std::vector<fb::Offset<HTTPHeader>> headers;
@@ -191,6 +283,34 @@ void tiles::init(mm::registry& reg) {
     return make_msg(mc);
   });
 
+  reg.register_op("/tiles/stats", [&](auto const&) {
+    auto const stats = data_->cache_.get_statistics();
+    auto stages = std::string{};
+    for (auto const& stage : data_->render_stats_.get()) {
+      stages += fmt::format(R"({}{{"count":{},"total_us":{}}})",
+                            stages.empty() ? "" : ",", stage.count_,
+                            stage.total_us_);
+    }
+    auto const json = fmt::format(
+        R"({{"hits":{},"misses":{},"coalesced":{},"evictions":{},)"
+        R"("render_time_us":{},"entries":{},"size_bytes":{},)"
+        R"("render_stages":[{}]}})",
+        stats.hits_, stats.misses_, stats.coalesced_, stats.evictions_,
+        stats.render_time_us_, stats.entries_, stats.size_bytes_, stages);
+
+    mm::message_creator mc;
+    mc.create_and_finish(
+        MsgContent_HTTPResponse,
+        CreateHTTPResponse(
+            mc, HTTPStatus_OK,
+            mc.CreateVector(std::vector<fb::Offset<HTTPHeader>>{
+                CreateHTTPHeader(mc, mc.CreateString("Content-Type"),
+                                 mc.CreateString("application/json"))}),
+            mc.CreateString(json))
+            .Union());
+    return make_msg(mc);
+  });
+
   reg.register_op("/tiles/glyphs", [&](auto const& msg) {
     std::string decoded;
     net::url_decode(msg->get()->destination()->target()->str(), decoded);
@@ -0,0 +1,236 @@
+#include <atomic>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "motis/tiles/tile_cache.h"
+
+using namespace motis::tiles;
+
+namespace {
+
+tile_cache::render_fn_t render_string(std::string const& s,
+                                      std::atomic_int& calls) {
+  return [&calls, s]() -> std::optional<std::string> {
+    ++calls;
+    return s;
+  };
+}
+
+// Size of a cached tile with the given payload (payload + entry overhead).
+std::size_t cached_size(std::size_t const payload) {
+  tile_cache cache{1024U * 1024U};
+  cache.get_or_render(geo::tile{0, 0, 0},
+                      [&]() { return std::string(payload, 'x'); });
+  return cache.get_statistics().size_bytes_;
+}
+
+void wait_for_coalesced(tile_cache const& cache, std::uint64_t const n) {
+  while (cache.get_statistics().coalesced_ < n) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+TEST(tiles_tile_cache, hit_and_miss) {
+  tile_cache cache{1024U * 1024U};
+  std::atomic_int calls{0};
+
+  auto const a = cache.get_or_render(geo::tile{1, 2, 3},
+                                     render_string("tile", calls));
+  auto const b = cache.get_or_render(geo::tile{1, 2, 3},
+                                     render_string("other", calls));
+  auto const empty = cache.get_or_render(
+      geo::tile{2, 2, 3}, []() { return std::optional<std::string>{}; });
+
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ("tile", *a);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(nullptr, empty);
+  EXPECT_EQ(1, calls);
+
+  auto const stats = cache.get_statistics();
+  EXPECT_EQ(1U, stats.hits_);
+  EXPECT_EQ(2U, stats.misses_);
+  EXPECT_EQ(2U, stats.entries_);
+}
+
+TEST(tiles_tile_cache, coalesce_concurrent_renders) {
+  tile_cache cache{1024U * 1024U};
+  std::atomic_int calls{0};
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  auto first = std::async(std::launch::async, [&]() {
+    return cache.get_or_render(geo::tile{1, 1, 1}, [&]() {
+      ++calls;
+      released.wait();
+      return std::optional<std::string>{"tile"};
+    });
+  });
+  while (calls == 0) {
+    std::this_thread::yield();
+  }
+
+  auto second = std::async(std::launch::async, [&]() {
+    return cache.get_or_render(geo::tile{1, 1, 1},
+                               render_string("other", calls));
+  });
+  wait_for_coalesced(cache, 1U);
+  release.set_value();
+
+  auto const a = first.get();
+  auto const b = second.get();
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ("tile", *a);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(1U, cache.get_statistics().misses_);
+}
+
+TEST(tiles_tile_cache, evict_least_recently_used) {
+  auto const size = cached_size(100U);
+  tile_cache cache{2U * size};
+  std::atomic_int calls{0};
+  auto const tile = [](unsigned const x) { return geo::tile{x, 0, 10}; };
+  auto const payload = std::string(100U, 'x');
+
+  cache.get_or_render(tile(1), render_string(payload, calls));
+  cache.get_or_render(tile(2), render_string(payload, calls));
+  cache.get_or_render(tile(1), render_string(payload, calls));  // touch 1
+  cache.get_or_render(tile(3), render_string(payload, calls));  // evicts 2
+  EXPECT_EQ(3, calls);
+
+  auto stats = cache.get_statistics();
+  EXPECT_EQ(1U, stats.evictions_);
+  EXPECT_EQ(2U, stats.entries_);
+  EXPECT_EQ(2U * size, stats.size_bytes_);
+
+  cache.get_or_render(tile(1), render_string(payload, calls));
+  cache.get_or_render(tile(3), render_string(payload, calls));
+  EXPECT_EQ(3, calls);
+  cache.get_or_render(tile(2), render_string(payload, calls));
+  EXPECT_EQ(4, calls);
+
+  // a tile larger than the cache is returned but not kept
+  auto const large = cache.get_or_render(
+      tile(4), render_string(std::string(3U * size, 'x'), calls));
+  ASSERT_NE(nullptr, large);
+  EXPECT_EQ(3U * size, large->size());
+  stats = cache.get_statistics();
+  EXPECT_LE(stats.size_bytes_, 2U * size);
+}
+
+TEST(tiles_tile_cache, keep_rendering_entries_on_evict) {
+  auto const size = cached_size(100U);
+  tile_cache cache{size};
+  std::atomic_int calls{0};
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  auto rendering = std::async(std::launch::async, [&]() {
+    return cache.get_or_render(geo::tile{1, 1, 1}, [&]() {
+      ++calls;
+      released.wait();
+      return std::optional<std::string>{"tile"};
+    });
+  });
+  while (calls == 0) {
+    std::this_thread::yield();
+  }
+
+  // exceeds the cache size: must evict itself, not the rendering tile
+  cache.get_or_render(geo::tile{2, 1, 1},
+                      render_string(std::string(2U * size, 'x'), calls));
+  EXPECT_EQ(1U, cache.get_statistics().evictions_);
+  EXPECT_EQ(1U, cache.get_statistics().entries_);
+
+  auto coalesced = std::async(std::launch::async, [&]() {
+    return cache.get_or_render(geo::tile{1, 1, 1},
+                               render_string("other", calls));
+  });
+  wait_for_coalesced(cache, 1U);
+  release.set_value();
+
+  EXPECT_EQ("tile", *rendering.get());
+  EXPECT_EQ("tile", *coalesced.get());
+  EXPECT_EQ(2, calls);
+}
+
+TEST(tiles_tile_cache, render_exception) {
+  tile_cache cache{1024U * 1024U};
+  std::atomic_int calls{0};
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  auto failing = std::async(std::launch::async, [&]() {
+    return cache.get_or_render(
+        geo::tile{1, 1, 1}, [&]() -> std::optional<std::string> {
+          ++calls;
+          released.wait();
+          throw std::runtime_error{"render failed"};
+        });
+  });
+  while (calls == 0) {
+    std::this_thread::yield();
+  }
+
+  auto waiting = std::async(std::launch::async, [&]() {
+    return cache.get_or_render(geo::tile{1, 1, 1},
+                               render_string("other", calls));
+  });
+  wait_for_coalesced(cache, 1U);
+  release.set_value();
+
+  EXPECT_THROW(failing.get(), std::runtime_error);
+  EXPECT_THROW(waiting.get(), std::runtime_error);
+  EXPECT_EQ(0U, cache.get_statistics().entries_);
+  EXPECT_EQ(0U, cache.get_statistics().size_bytes_);
+
+  // the failed render is not cached
+  auto const retry =
+      cache.get_or_render(geo::tile{1, 1, 1}, render_string("tile", calls));
+  ASSERT_NE(nullptr, retry);
+  EXPECT_EQ("tile", *retry);
+  EXPECT_EQ(2, calls);
+}
+
+TEST(tiles_tile_cache, clear_during_render) {
+  tile_cache cache{1024U * 1024U};
+  std::atomic_int calls{0};
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  auto stale = std::async(std::launch::async, [&]() {
+    return cache.get_or_render(geo::tile{1, 1, 1}, [&]() {
+      ++calls;
+      released.wait();
+      return std::optional<std::string>{"stale"};
+    });
+  });
+  while (calls == 0) {
+    std::this_thread::yield();
+  }
+
+  cache.clear();
+  auto const fresh =
+      cache.get_or_render(geo::tile{1, 1, 1}, render_string("fresh", calls));
+  EXPECT_EQ("fresh", *fresh);
+  auto const size = cache.get_statistics().size_bytes_;
+
+  // the render started before clear() must not replace the new entry
+  release.set_value();
+  EXPECT_EQ("stale", *stale.get());
+
+  auto const stats = cache.get_statistics();
+  EXPECT_EQ(1U, stats.entries_);
+  EXPECT_EQ(size, stats.size_bytes_);
+  EXPECT_EQ(fresh, cache.get_or_render(geo::tile{1, 1, 1},
+                                       render_string("other", calls)));
+  EXPECT_EQ(2, calls);
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "motis/vector.h"
+
+namespace motis::tripbased {
+
+struct tb_data;
+
+// Bit-packed copy of tb_data::transfers_ or tb_data::reverse_transfers_.
+//
+// Transfers are stored per (trip, stop) bucket, buckets are numbered like
+// the nested transfer multimaps (arrival_times_.index_[trip] + stop_idx).
+// Each transfer is stored as (trip, stop index): (to_trip, to_stop_idx) for
+// transfers, (from_trip, from_stop_idx) for reverse transfers (their
+// to_stop_idx is the stop of the bucket). A bucket is a bit stream:
+//   count (8 bit, 255 -> followed by 32 bit count)
+//   trip delta width (6 bit), stop index width (5 bit)
+//   first trip (32 bit)
+//   count - 1 trip deltas (trip delta width each, trips are sorted)
+//   count stop indices (stop index width each)
+// Empty buckets have no bits at all. Bucket bit offsets are stored as 64 bit
+// offsets per block of BLOCK_SIZE buckets and 32 bit offsets relative to
+// the block start (bucket_count + 1 entries: end of the last bucket).
+struct compressed_transfers {
+  static constexpr auto const BLOCK_SIZE = 64U;
+
+  template <typename Fn>
+  inline void for_each(uint64_t const bucket, Fn&& fn) const {
+    auto pos = bucket_begin(bucket);
+    if (pos == bucket_end(bucket)) {
+      return;
+    }
+
+    auto count = static_cast<uint32_t>(read(pos, 8U));
+    if (count == 0xFFU) {
+      count = static_cast<uint32_t>(read(pos, 32U));
+    }
+    auto const trip_bits = static_cast<unsigned>(read(pos, 6U));
+    auto const stop_bits = static_cast<unsigned>(read(pos, 5U));
+    auto trip = static_cast<uint32_t>(read(pos, 32U));
+    auto stop_pos = pos + (count - 1U) * uint64_t{trip_bits};
+    for (auto i = 0U; i < count; ++i) {
+      if (i != 0U) {
+        trip += static_cast<uint32_t>(read(pos, trip_bits));
+      }
+      fn(trip, static_cast<uint16_t>(read(stop_pos, stop_bits)));
+    }
+  }
+
+  inline void prefetch(uint64_t const bucket) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(bits_.data() + bucket_begin(bucket) / 64U);
+#else
+    (void)bucket;
+#endif
+  }
+
+  inline bool empty() const { return block_offset_.empty(); }
+
+  std::size_t size_bytes() const {
+    return block_offset_.size() * sizeof(uint64_t) +
+           bucket_offset_.size() * sizeof(uint32_t) +
+           bits_.size() * sizeof(uint64_t);
+  }
+
+  inline uint64_t bucket_begin(uint64_t const bucket) const {
+    return block_offset_[bucket / BLOCK_SIZE] + bucket_offset_[bucket];
+  }
+
+  inline uint64_t bucket_end(uint64_t const bucket) const {
+    return bucket_begin(bucket + 1U);
+  }
+
+  // width <= 32
+  inline uint64_t read(uint64_t& pos, unsigned const width) const {
+    if (width == 0U) {
+      return 0U;
+    }
+    auto const word = pos / 64U;
+    auto const shift = static_cast<unsigned>(pos % 64U);
+    auto value = bits_[word] >> shift;
+    if (shift + width > 64U) {
+      value |= bits_[word + 1U] << (64U - shift);
+    }
+    pos += width;
+    return value & ((uint64_t{1U} << width) - 1U);
+  }
+
+  mcd::vector<uint64_t> block_offset_;
+  mcd::vector<uint32_t> bucket_offset_;
+  mcd::vector<uint64_t> bits_;
+};
+
+// Small direct-mapped cache of decoded buckets for searches that scan the
+// same buckets repeatedly (profile searches). Buckets with more than
+// MAX_ENTRIES transfers are decoded on every access.
+struct compressed_transfers_cache {
+  static constexpr auto const SLOTS = 256U;
+  static constexpr auto const MAX_ENTRIES = 8U;
+
+  struct slot {
+    uint64_t bucket_{std::numeric_limits<uint64_t>::max()};
+    uint32_t size_{};
+    std::array<uint32_t, MAX_ENTRIES> to_trip_{};
+    std::array<uint16_t, MAX_ENTRIES> to_stop_idx_{};
+  };
+
+  compressed_transfers_cache() : slots_(SLOTS) {}
+
+  template <typename Fn>
+  inline void for_each(compressed_transfers const& transfers,
+                       uint64_t const bucket, Fn&& fn) {
+    auto& s = slots_[bucket % SLOTS];
+    if (s.bucket_ != bucket) {
+      s.bucket_ = std::numeric_limits<uint64_t>::max();
+      s.size_ = 0U;
+      auto cacheable = true;
+      transfers.for_each(bucket, [&](uint32_t const to_trip,
+                                     uint16_t const to_stop_idx) {
+        if (s.size_ == MAX_ENTRIES) {
+          cacheable = false;
+          return;
+        }
+        s.to_trip_[s.size_] = to_trip;
+        s.to_stop_idx_[s.size_] = to_stop_idx;
+        ++s.size_;
+      });
+      ++misses_;
+      if (!cacheable) {
+        transfers.for_each(bucket, fn);
+        return;
+      }
+      s.bucket_ = bucket;
+    } else {
+      ++hits_;
+    }
+    for (auto i = 0U; i < s.size_; ++i) {
+      fn(s.to_trip_[i], s.to_stop_idx_[i]);
+    }
+  }
+
+  std::vector<slot> slots_;
+  uint64_t hits_{};
+  uint64_t misses_{};
+};
+
+// Builds the compressed representation of data.transfers_.
+compressed_transfers compress_transfers(tb_data const& data);
+
+// Builds the compressed representation of data.reverse_transfers_.
+compressed_transfers compress_reverse_transfers(tb_data const& data);
+
+// Replaces data.transfers_ and data.reverse_transfers_ with the compressed
+// representations.
+void use_compressed_transfers(tb_data& data);
+
+}  // namespace motis::tripbased
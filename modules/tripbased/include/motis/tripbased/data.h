@@ -13,6 +13,8 @@
 #include "motis/core/schedule/time.h"
 #include "motis/core/schedule/trip.h"
 
+#include "motis/tripbased/compressed_transfers.h"
+
 namespace motis::tripbased {
 
 using trip_id = uint32_t;
@@ -151,6 +153,85 @@ struct tb_data {
         {{first_trip_in_line, arrival_times_[first_trip_in_line][stop_idx]}}};
   }
 
+  inline uint64_t transfer_bucket(trip_id trip, stop_idx_t stop_idx) const {
+    return arrival_times_.index_[trip] + stop_idx;
+  }
+
+  // Calls fn(tb_transfer const&) for all transfers from the stop of the trip.
+  template <typename Fn>
+  inline void for_each_transfer(trip_id trip, stop_idx_t stop_idx,
+                                Fn&& fn) const {
+    if (compressed_transfers_.empty()) {
+      for (auto const& transfer : transfers_.at(trip, stop_idx)) {
+        fn(transfer);
+      }
+    } else {
+      compressed_transfers_.for_each(
+          transfer_bucket(trip, stop_idx),
+          [&](trip_id const to_trip, stop_idx_t const to_stop_idx) {
+            fn(tb_transfer{to_trip, to_stop_idx});
+          });
+    }
+  }
+
+  template <typename Fn>
+  inline void for_each_transfer(trip_id trip, stop_idx_t stop_idx,
+                                compressed_transfers_cache& cache,
+                                Fn&& fn) const {
+    if (compressed_transfers_.empty()) {
+      for (auto const& transfer : transfers_.at(trip, stop_idx)) {
+        fn(transfer);
+      }
+    } else {
+      cache.for_each(compressed_transfers_, transfer_bucket(trip, stop_idx),
+                     [&](trip_id const to_trip, stop_idx_t const to_stop_idx) {
+                       fn(tb_transfer{to_trip, to_stop_idx});
+                     });
+    }
+  }
+
+  // Calls fn(tb_reverse_transfer const&) for all transfers to the stop of the
+  // trip.
+  template <typename Fn>
+  inline void for_each_reverse_transfer(trip_id trip, stop_idx_t stop_idx,
+                                        Fn&& fn) const {
+    if (compressed_reverse_transfers_.empty()) {
+      for (auto const& transfer : reverse_transfers_.at(trip, stop_idx)) {
+        fn(transfer);
+      }
+    } else {
+      compressed_reverse_transfers_.for_each(
+          transfer_bucket(trip, stop_idx),
+          [&](trip_id const from_trip, stop_idx_t const from_stop_idx) {
+            fn(tb_reverse_transfer{from_trip, from_stop_idx, stop_idx});
+          });
+    }
+  }
+
+  inline void prefetch_transfers(trip_id trip, stop_idx_t stop_idx) const {
+    if (compressed_transfers_.empty()) {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(transfers_.data_.data() +
+                         transfers_.index_[transfer_bucket(trip, stop_idx)]);
+#endif
+    } else {
+      compressed_transfers_.prefetch(transfer_bucket(trip, stop_idx));
+    }
+  }
+
+  inline void prefetch_reverse_transfers(trip_id trip,
+                                         stop_idx_t stop_idx) const {
+    if (compressed_reverse_transfers_.empty()) {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(
+          reverse_transfers_.data_.data() +
+          reverse_transfers_.index_[transfer_bucket(trip, stop_idx)]);
+#endif
+    } else {
+      compressed_reverse_transfers_.prefetch(transfer_bucket(trip, stop_idx));
+    }
+  }
+
   uint64_t trip_count_{};
   uint64_t line_count_{};
 
@@ -170,6 +251,11 @@ struct tb_data {
   nested_fws_multimap<tb_reverse_transfer> reverse_transfers_{
       arrival_times_.index_};
 
+  // if not empty, replace transfers_ / reverse_transfers_
+  // (see use_compressed_transfers)
+  compressed_transfers compressed_transfers_;
+  compressed_transfers compressed_reverse_transfers_;
+
   shared_idx_fws_multimap<uint8_t, line_id> in_allowed_{stops_on_line_.index_};
   shared_idx_fws_multimap<uint8_t, line_id> out_allowed_{stops_on_line_.index_};
   shared_idx_fws_multimap<uint16_t, line_id> arrival_platform_{
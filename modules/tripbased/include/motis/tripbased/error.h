@@ -17,7 +17,8 @@ enum error_code_t {
   via_not_supported = 7,
   invalid_additional_edges = 8,
   trip_not_found = 9,
-  schedule_not_supported = 10
+  schedule_not_supported = 10,
+  transfer_patterns_not_available = 11
 };
 }  // namespace error
 
@@ -44,6 +45,8 @@ public:
       case error::trip_not_found: return "tripbased: trip not found";
       case error::schedule_not_supported:
         return "tripbased: schedule not supported";
+      case error::transfer_patterns_not_available:
+        return "tripbased: transfer patterns not available";
       default: return "tripbased: unknown error";
     }
   }
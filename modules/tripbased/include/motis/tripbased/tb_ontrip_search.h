@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <map>
+#include <memory>
 #include <optional>
 #include <queue>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "motis/tripbased/limits.h"
 #include "motis/tripbased/tb_journey.h"
 #include "motis/tripbased/tb_search_common.h"
+#include "motis/tripbased/tb_search_memory.h"
 #include "motis/tripbased/tb_statistics.h"
 
 namespace motis::tripbased {
@@ -26,9 +28,17 @@ struct tb_ontrip_search {
                                       ? std::numeric_limits<time>::max()
                                       : std::numeric_limits<time>::min();
 
+  static constexpr stop_idx_t UNREACHABLE =
+      Dir == search_dir::FWD ? std::numeric_limits<stop_idx_t>::max()
+                             : std::numeric_limits<stop_idx_t>::min();
+
+  // If no search memory is given, the search allocates its own.
+  // Otherwise, the memory must not be used by another search
+  // as long as the results of this search are in use.
   tb_ontrip_search(tb_data const& data, schedule const& sched, time start_time,
                    bool count_initial_transfer_time,
-                   bool count_final_transfer_time, destination_mode dest_mode)
+                   bool count_final_transfer_time, destination_mode dest_mode,
+                   tb_search_memory* mem = nullptr)
       : data_(data),
         sched_(sched),
         start_time(start_time),
@@ -36,10 +46,13 @@ struct tb_ontrip_search {
         count_final_transfer_time_(count_final_transfer_time),
         destination_mode_(dest_mode),
         destination_arrivals_(data.line_count_),
-        first_reachable_stop_(data.trip_count_,
-                              Dir == search_dir::FWD
-                                  ? std::numeric_limits<stop_idx_t>::max()
-                                  : std::numeric_limits<stop_idx_t>::min()) {}
+        owned_mem_(mem == nullptr ? std::make_unique<tb_search_memory>()
+                                  : nullptr),
+        mem_(mem == nullptr ? *owned_mem_ : *mem),
+        queues_(mem_.queues_),
+        first_reachable_stop_(mem_.reachability_) {
+    mem_.reset(data, UNREACHABLE);
+  }
 
   void add_start(station_id stop_id, time initial_duration,
                  bool allow_footpaths = true) {
@@ -218,12 +231,16 @@ private:
     }
   }
 
-  inline void search_fwd(unsigned const transfers,
-                         std::vector<queue_entry>& queue) {
+  inline void search_fwd(unsigned const transfers, tb_queue const& queue) {
     for (auto current_trip_segment = 0UL; current_trip_segment < queue.size();
          ++current_trip_segment) {
       ++stats_.trip_segments_scanned_;
-      auto& entry = queue[current_trip_segment];
+      if (current_trip_segment + 1 < queue.size()) {
+        data_.prefetch_transfers(
+            queue.trip_[current_trip_segment + 1],
+            queue.from_stop_index_[current_trip_segment + 1]);
+      }
+      auto const entry = queue[current_trip_segment];
       auto const line = data_.trip_to_line_[entry.trip_];
       auto const& destination_arrivals = destination_arrivals_[line];
       if (!destination_arrivals.empty()) {
@@ -252,22 +269,26 @@ private:
                    static_cast<stop_idx_t>(data_.line_stop_count_[line] - 1));
       for (auto stop_idx = entry.from_stop_index_ + 1; stop_idx <= stop_count;
            ++stop_idx) {
-        for (auto const& transfer :
-             data_.transfers_.at(entry.trip_, stop_idx)) {
-          ++stats_.transfers_scanned_;
-          enqueue(transfer.to_trip_, transfer.to_stop_idx_, transfers + 1,
-                  current_trip_segment);
-        }
+        data_.for_each_transfer(
+            entry.trip_, stop_idx, [&](tb_transfer const& transfer) {
+              ++stats_.transfers_scanned_;
+              enqueue(transfer.to_trip_, transfer.to_stop_idx_, transfers + 1,
+                      current_trip_segment);
+            });
       }
     }
   }
 
-  inline void search_bwd(unsigned const transfers,
-                         std::vector<queue_entry>& queue) {
+  inline void search_bwd(unsigned const transfers, tb_queue const& queue) {
     for (auto current_trip_segment = 0UL; current_trip_segment < queue.size();
          ++current_trip_segment) {
       ++stats_.trip_segments_scanned_;
-      auto& entry = queue[current_trip_segment];
+      if (current_trip_segment + 1 < queue.size()) {
+        data_.prefetch_reverse_transfers(
+            queue.trip_[current_trip_segment + 1],
+            queue.to_stop_index_[current_trip_segment + 1]);
+      }
+      auto const entry = queue[current_trip_segment];
       auto const line = data_.trip_to_line_[entry.trip_];
       auto const& destination_arrivals = destination_arrivals_[line];
       if (!destination_arrivals.empty()) {
@@ -294,12 +315,13 @@ private:
       }
       for (auto stop_idx = entry.to_stop_index_ - 1;
            stop_idx >= entry.from_stop_index_; --stop_idx) {
-        for (auto const& transfer :
-             data_.reverse_transfers_.at(entry.trip_, stop_idx)) {
-          ++stats_.transfers_scanned_;
-          enqueue(transfer.from_trip_, transfer.from_stop_idx_, transfers + 1,
-                  current_trip_segment);
-        }
+        data_.for_each_reverse_transfer(
+            entry.trip_, static_cast<stop_idx_t>(stop_idx),
+            [&](tb_reverse_transfer const& transfer) {
+              ++stats_.transfers_scanned_;
+              enqueue(transfer.from_trip_, transfer.from_stop_idx_,
+                      transfers + 1, current_trip_segment);
+            });
         if (stop_idx == 0) {
           break;
         }
@@ -311,7 +333,7 @@ private:
                       std::size_t previous_trip_segment) {
     assert(transfers < queues_.size());
     if (Dir == search_dir::FWD) {
-      auto const old_first_reachable = first_reachable_stop_[trip];
+      auto const old_first_reachable = first_reachable_stop_.get(trip);
       if (stop_index >= old_first_reachable) {
         return;
       }
@@ -322,11 +344,11 @@ private:
       auto const line = data_.trip_to_line_[trip];
       for (trip_id t = trip;
            t < data_.trip_count_ && data_.trip_to_line_[t] == line; ++t) {
-        first_reachable_stop_[t] =
-            std::min(first_reachable_stop_[t], stop_index);
+        first_reachable_stop_.set(
+            t, std::min(first_reachable_stop_.get(t), stop_index));
       }
     } else {
-      auto const old_last_reachable = first_reachable_stop_[trip];
+      auto const old_last_reachable = first_reachable_stop_.get(trip);
       if (stop_index <= old_last_reachable) {
         return;
       }
@@ -335,8 +357,8 @@ private:
                          previous_trip_segment);
       auto const line = data_.trip_to_line_[trip];
       for (trip_id t = trip; data_.trip_to_line_[t] == line; --t) {
-        first_reachable_stop_[t] =
-            std::max(first_reachable_stop_[t], stop_index);
+        first_reachable_stop_.set(
+            t, std::max(first_reachable_stop_.get(t), stop_index));
         if (t == 0) {
           break;
         }
@@ -443,8 +465,10 @@ private:
   std::vector<std::vector<tb_journey>> journeys_;
   std::vector<time> earliest_arrival_;
   time total_earliest_arrival_{INVALID};
-  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
-  std::vector<stop_idx_t> first_reachable_stop_;
+  std::unique_ptr<tb_search_memory> owned_mem_;
+  tb_search_memory& mem_;
+  std::array<tb_queue, MAX_TRANSFERS + 1>& queues_;
+  tb_reachability& first_reachable_stop_;
   tb_statistics stats_{};
 };
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "motis/core/common/timing.h"
+#include "motis/module/context/motis_parallel_for.h"
+
+#include "motis/tripbased/tb_profile_search.h"
+
+namespace motis::tripbased {
+
+// Splits the departure time interval of a profile search into consecutive
+// chunks that are searched in parallel. Every chunk has its own
+// tb_profile_search (queues, first reachable stops, earliest arrivals).
+// The results of all chunks are concatenated: journeys of earlier chunks
+// that are dominated by journeys of later chunks (which the sequential
+// search would have pruned) are removed by the usual result filtering.
+template <search_dir Dir = search_dir::FWD>
+struct tb_parallel_profile_search {
+  tb_parallel_profile_search(tb_data const& data, schedule const& sched,
+                             time interval_begin, time interval_end,
+                             bool count_initial_transfer_time,
+                             bool count_final_transfer_time,
+                             destination_mode dest_mode, unsigned max_chunks,
+                             unsigned min_chunk_length)
+      : interval_begin_{interval_begin}, interval_end_{interval_end} {
+    auto const length = static_cast<unsigned>(interval_end - interval_begin);
+    auto const chunks = std::clamp(
+        length / std::max(min_chunk_length, 1U), 1U, std::max(max_chunks, 1U));
+    for (auto i = 0U; i < chunks; ++i) {
+      auto const chunk_begin =
+          static_cast<time>(interval_begin + length * i / chunks);
+      auto const chunk_end =
+          i == chunks - 1U
+              ? interval_end
+              : static_cast<time>(
+                    interval_begin + length * (i + 1U) / chunks - 1U);
+      searches_.emplace_back(std::make_unique<tb_profile_search<Dir>>(
+          data, sched, chunk_begin, chunk_end, count_initial_transfer_time,
+          count_final_transfer_time, dest_mode));
+    }
+  }
+
+  void add_start(station_id stop_id, time initial_duration,
+                 bool allow_footpaths = true) {
+    for (auto& s : searches_) {
+      s->add_start(stop_id, initial_duration, allow_footpaths);
+    }
+  }
+
+  void add_destination(station_id stop_id, bool allow_footpaths = true) {
+    if (std::find(begin(destination_stations_), end(destination_stations_),
+                  stop_id) == end(destination_stations_)) {
+      destination_stations_.push_back(stop_id);
+    }
+    for (auto& s : searches_) {
+      s->add_destination(stop_id, allow_footpaths);
+    }
+  }
+
+  void search() {
+    MOTIS_START_TIMING(search_timing);
+    if (searches_.size() == 1U) {
+      searches_.front()->search();
+    } else {
+      std::vector<std::size_t> chunks(searches_.size());
+      std::iota(begin(chunks), end(chunks), std::size_t{0U});
+      motis_parallel_for(chunks, [&](std::size_t const chunk) {
+        MOTIS_START_TIMING(chunk_timing);
+        searches_[chunk]->search();
+        MOTIS_STOP_TIMING(chunk_timing);
+        searches_[chunk]->get_statistics().search_duration_ =
+            MOTIS_TIMING_MS(chunk_timing);
+      });
+    }
+
+    MOTIS_START_TIMING(merge_timing);
+    stats_ = {};
+    for (auto const& s : searches_) {
+      stats_ += s->get_statistics();
+      stats_.max_chunk_search_duration_ =
+          std::max(stats_.max_chunk_search_duration_,
+                   s->get_statistics().search_duration_);
+    }
+    for (auto const destination : destination_stations_) {
+      auto& results = results_[destination];
+      for (auto& s : searches_) {
+        auto& chunk_results = s->get_results(destination);
+        std::move(begin(chunk_results), end(chunk_results),
+                  std::back_inserter(results));
+      }
+    }
+    MOTIS_STOP_TIMING(merge_timing);
+
+    MOTIS_STOP_TIMING(search_timing);
+
+    stats_.search_chunks_ = searches_.size();
+    stats_.search_duration_ = MOTIS_TIMING_MS(search_timing);
+    stats_.merge_duration_ = MOTIS_TIMING_MS(merge_timing);
+  }
+
+  std::vector<tb_journey>& get_results(station_id destination) {
+    return results_.at(destination);
+  }
+
+  tb_statistics& get_statistics() { return stats_; }
+  tb_statistics const& get_statistics() const { return stats_; }
+
+  std::pair<time, time> get_interval() const {
+    return {interval_begin_, interval_end_};
+  }
+
+private:
+  time interval_begin_, interval_end_;
+  std::vector<station_id> destination_stations_;
+  // journeys reference data of their search -> keep searches alive
+  std::vector<std::unique_ptr<tb_profile_search<Dir>>> searches_;
+  std::map<station_id, std::vector<tb_journey>> results_;
+  tb_statistics stats_{};
+};
+
+}  // namespace motis::tripbased
@@ -258,6 +258,9 @@ private:
       stats_.max_queue_size_ = std::max(stats_.max_queue_size_, size);
     }
 
+    stats_.transfer_cache_hits_ = transfer_cache_.hits_;
+    stats_.transfer_cache_misses_ = transfer_cache_.misses_;
+
     add_iteration_results();
     prepare_next_iteration();
   }
@@ -299,12 +302,13 @@ private:
                    static_cast<stop_idx_t>(data_.line_stop_count_[line] - 1));
       for (auto stop_idx = entry.from_stop_index_ + 1; stop_idx <= stop_count;
            ++stop_idx) {
-        for (auto const& transfer :
-             data_.transfers_.at(entry.trip_, stop_idx)) {
-          ++stats_.transfers_scanned_;
-          enqueue(transfer.to_trip_, transfer.to_stop_idx_, transfers + 1,
-                  current_trip_segment);
-        }
+        data_.for_each_transfer(
+            entry.trip_, stop_idx, transfer_cache_,
+            [&](tb_transfer const& transfer) {
+              ++stats_.transfers_scanned_;
+              enqueue(transfer.to_trip_, transfer.to_stop_idx_, transfers + 1,
+                      current_trip_segment);
+            });
       }
     }
   }
@@ -344,12 +348,13 @@ private:
       }
       for (auto stop_idx = entry.to_stop_index_ - 1;
            stop_idx >= entry.from_stop_index_; --stop_idx) {
-        for (auto const& transfer :
-             data_.reverse_transfers_.at(entry.trip_, stop_idx)) {
-          ++stats_.transfers_scanned_;
-          enqueue(transfer.from_trip_, transfer.from_stop_idx_, transfers + 1,
-                  current_trip_segment);
-        }
+        data_.for_each_reverse_transfer(
+            entry.trip_, static_cast<stop_idx_t>(stop_idx),
+            [&](tb_reverse_transfer const& transfer) {
+              ++stats_.transfers_scanned_;
+              enqueue(transfer.from_trip_, transfer.from_stop_idx_,
+                      transfers + 1, current_trip_segment);
+            });
         if (stop_idx == 0) {
           break;
         }
@@ -475,12 +480,19 @@ private:
         (Dir == search_dir::BWD && destination_mode_ == destination_mode::ANY);
     time result = latest ? std::numeric_limits<time>::min()
                          : std::numeric_limits<time>::max();
+    // saturated -> stop early (matters with many destinations, e.g. for
+    // transfer pattern preprocessing)
+    auto const saturated = latest ? std::numeric_limits<time>::max()
+                                  : std::numeric_limits<time>::min();
     for (auto const& station : destination_stations_) {
       if (latest) {
         result = std::max(result, earliest_arrival_[station][trfs]);  // NOLINT
       } else {
         result = std::min(result, earliest_arrival_[station][trfs]);  // NOLINT
       }
+      if (result == saturated) {
+        break;
+      }
     }
     return result;
   }
@@ -561,6 +573,7 @@ private:
   std::array<time, MAX_TRANSFERS + 1> total_earliest_arrival_;
   std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
   std::vector<std::array<stop_idx_t, MAX_TRANSFERS + 1>> first_reachable_stop_;
+  compressed_transfers_cache transfer_cache_;
   tb_statistics stats_{};
 };
 
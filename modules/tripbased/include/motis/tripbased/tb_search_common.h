@@ -1,8 +1,10 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <vector>
 
 #include "motis/core/common/logging.h"
 
@@ -30,6 +32,42 @@ struct queue_entry {
   std::size_t previous_trip_segment_{};
 };
 
+// Struct-of-arrays queue of trip segments. Scanning a queue only touches the
+// trip and stop indices, the previous trip segment is only needed for
+// journey reconstruction.
+struct tb_queue {
+  inline queue_entry operator[](std::size_t const i) const {
+    return {trip_[i], from_stop_index_[i], to_stop_index_[i],
+            previous_trip_segment_[i]};
+  }
+
+  inline void emplace_back(trip_id const trip, stop_idx_t const from_stop_index,
+                           stop_idx_t const to_stop_index,
+                           std::size_t const previous_trip_segment) {
+    trip_.push_back(trip);
+    from_stop_index_.push_back(from_stop_index);
+    to_stop_index_.push_back(to_stop_index);
+    previous_trip_segment_.push_back(
+        static_cast<uint32_t>(previous_trip_segment));
+  }
+
+  inline std::size_t size() const { return trip_.size(); }
+  inline bool empty() const { return trip_.empty(); }
+
+  // keeps the allocated memory for the next search
+  inline void clear() {
+    trip_.clear();
+    from_stop_index_.clear();
+    to_stop_index_.clear();
+    previous_trip_segment_.clear();
+  }
+
+  std::vector<trip_id> trip_;
+  std::vector<stop_idx_t> from_stop_index_;
+  std::vector<stop_idx_t> to_stop_index_;
+  std::vector<uint32_t> previous_trip_segment_;
+};
+
 inline tb_reverse_transfer find_reverse_transfer(queue_entry const& from_qe,
                                                  queue_entry const& to_qe,
                                                  tb_data const& data) {
@@ -42,14 +80,14 @@ inline tb_reverse_transfer find_reverse_transfer(queue_entry const& from_qe,
 
   for (auto from_stop_idx = from_qe.from_stop_index_;
        from_stop_idx <= stop_count; ++from_stop_idx) {
-    for (auto const& transfer : data.transfers_.at(from_trip, from_stop_idx)) {
-      if (transfer.to_trip_ == to_trip) {
-        if (transfer.to_stop_idx_ != to_qe.from_stop_index_) {
-          continue;
-        }
-        return {from_trip, from_stop_idx,
-                std::numeric_limits<stop_idx_t>::max()};
-      }
+    auto found = false;
+    data.for_each_transfer(
+        from_trip, from_stop_idx, [&](tb_transfer const& transfer) {
+          found = found || (transfer.to_trip_ == to_trip &&
+                            transfer.to_stop_idx_ == to_qe.from_stop_index_);
+        });
+    if (found) {
+      return {from_trip, from_stop_idx, std::numeric_limits<stop_idx_t>::max()};
     }
   }
   LOG(logging::error) << "trip-based journey reconstruction: find reverse "
@@ -72,14 +110,15 @@ inline tb_transfer find_transfer(queue_entry const& from_qe,
   for (auto to_stop_index = static_cast<int>(
            std::min(to_qe.to_stop_index_, data.line_stop_count_[to_line]));
        to_stop_index >= 0 /*to_qe.from_stop_index_*/; --to_stop_index) {
-    for (auto const& transfer :
-         data.reverse_transfers_.at(to_trip, to_stop_index)) {
-      if (transfer.from_trip_ == from_trip) {
-        if (transfer.from_stop_idx_ != from_qe.to_stop_index_) {
-          continue;
-        }
-        return {to_trip, static_cast<stop_idx_t>(to_stop_index)};
-      }
+    auto found = false;
+    data.for_each_reverse_transfer(
+        to_trip, static_cast<stop_idx_t>(to_stop_index),
+        [&](tb_reverse_transfer const& transfer) {
+          found = found || (transfer.from_trip_ == from_trip &&
+                            transfer.from_stop_idx_ == from_qe.to_stop_index_);
+        });
+    if (found) {
+      return {to_trip, static_cast<stop_idx_t>(to_stop_index)};
     }
   }
   LOG(logging::error)
@@ -195,10 +234,10 @@ void add_final_footpath(
   }
 }
 
-template <search_dir Dir>
+template <search_dir Dir, typename Queue>
 void reconstruct_tb_journey(
     tb_journey& j, tb_data const& data, schedule const& sched,
-    std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> const& queues,
+    std::array<Queue, MAX_TRANSFERS + 1> const& queues,
     std::map<station_id, time> const& start_times,
     bool count_initial_transfer_time,
     std::function<bool(station_id)> const& is_start,
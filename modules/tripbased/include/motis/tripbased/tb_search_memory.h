@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "motis/tripbased/data.h"
+#include "motis/tripbased/limits.h"
+#include "motis/tripbased/tb_search_common.h"
+
+namespace motis::tripbased {
+
+// First reachable stop per trip. Entries are tagged with the epoch of the
+// search that wrote them: entries of previous searches are treated as
+// unset, so starting a new search does not need to touch the whole array.
+struct tb_reachability {
+  struct entry {
+    uint16_t epoch_{0U};
+    stop_idx_t stop_idx_{};
+  };
+
+  void reset(std::size_t const trip_count, stop_idx_t const unreachable) {
+    unreachable_ = unreachable;
+    if (entries_.size() != trip_count ||
+        epoch_ == std::numeric_limits<uint16_t>::max()) {
+      entries_.assign(trip_count, entry{});
+      epoch_ = 0U;
+    }
+    ++epoch_;
+  }
+
+  inline stop_idx_t get(trip_id const trip) const {
+    auto const& e = entries_[trip];
+    return e.epoch_ == epoch_ ? e.stop_idx_ : unreachable_;
+  }
+
+  inline void set(trip_id const trip, stop_idx_t const stop_idx) {
+    entries_[trip] = entry{epoch_, stop_idx};
+  }
+
+  std::vector<entry> entries_;
+  uint16_t epoch_{0U};
+  stop_idx_t unreachable_{};
+};
+
+// Per-search buffers that are reused by consecutive ontrip searches.
+struct tb_search_memory {
+  void reset(tb_data const& data, stop_idx_t const unreachable) {
+    reachability_.reset(data.trip_count_, unreachable);
+    for (auto& q : queues_) {
+      q.clear();
+    }
+  }
+
+  tb_reachability reachability_;
+  std::array<tb_queue, MAX_TRANSFERS + 1> queues_;
+};
+
+// Hands out search memory to concurrent searches. Memory is returned to the
+// pool when the lease is destroyed.
+struct tb_search_memory_pool {
+  struct lease {
+    lease(tb_search_memory_pool& pool, std::unique_ptr<tb_search_memory> mem)
+        : pool_{pool}, mem_{std::move(mem)} {}
+    ~lease() { pool_.release(std::move(mem_)); }
+
+    lease(lease const&) = delete;
+    lease(lease&&) = delete;
+    lease& operator=(lease const&) = delete;
+    lease& operator=(lease&&) = delete;
+
+    tb_search_memory& get() const { return *mem_; }
+
+  private:
+    tb_search_memory_pool& pool_;
+    std::unique_ptr<tb_search_memory> mem_;
+  };
+
+  lease acquire() {
+    std::lock_guard const lock{mutex_};
+    if (memory_.empty()) {
+      return {*this, std::make_unique<tb_search_memory>()};
+    }
+    auto mem = std::move(memory_.back());
+    memory_.pop_back();
+    return {*this, std::move(mem)};
+  }
+
+private:
+  void release(std::unique_ptr<tb_search_memory> mem) {
+    std::lock_guard const lock{mutex_};
+    memory_.emplace_back(std::move(mem));
+  }
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<tb_search_memory>> memory_;
+};
+
+}  // namespace motis::tripbased
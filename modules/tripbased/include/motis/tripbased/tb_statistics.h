@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <algorithm>
 #include <array>
 
 #include "motis/core/statistics/statistics.h"
@@ -27,6 +28,42 @@ struct tb_statistics {
   uint64_t all_destinations_reached_{};
   uint64_t total_earliest_arrival_updates_{};
   uint64_t lower_bounds_duration_;
+
+  // parallel profile search
+  uint64_t search_chunks_{};
+  uint64_t max_chunk_search_duration_{};
+  uint64_t merge_duration_{};
+
+  // compressed transfers decode cache (profile search)
+  uint64_t transfer_cache_hits_{};
+  uint64_t transfer_cache_misses_{};
+
+  // accumulates the counters of a chunk of a parallel profile search
+  // (search_duration_ is the wall time of the whole parallel search)
+  tb_statistics& operator+=(tb_statistics const& o) {
+    start_count_ = std::max(start_count_, o.start_count_);
+    destination_count_ = std::max(destination_count_, o.destination_count_);
+    trip_segments_scanned_ += o.trip_segments_scanned_;
+    lines_reaching_destination_ += o.lines_reaching_destination_;
+    destination_arrivals_scanned_ += o.destination_arrivals_scanned_;
+    destination_reached_ += o.destination_reached_;
+    results_added_ += o.results_added_;
+    queue_count_ += o.queue_count_;
+    transfers_scanned_ += o.transfers_scanned_;
+    reconstruction_count_ += o.reconstruction_count_;
+    for (auto i = 0U; i < queue_size_.size(); ++i) {
+      queue_size_[i] = std::max(queue_size_[i], o.queue_size_[i]);  // NOLINT
+    }
+    max_queue_size_ = std::max(max_queue_size_, o.max_queue_size_);
+    search_iterations_ += o.search_iterations_;
+    max_travel_time_reached_ += o.max_travel_time_reached_;
+    pruned_by_earliest_arrival_ += o.pruned_by_earliest_arrival_;
+    all_destinations_reached_ += o.all_destinations_reached_;
+    total_earliest_arrival_updates_ += o.total_earliest_arrival_updates_;
+    transfer_cache_hits_ += o.transfer_cache_hits_;
+    transfer_cache_misses_ += o.transfer_cache_misses_;
+    return *this;
+  }
 };
 
 inline stats_category to_stats_category(char const* name,
@@ -58,7 +95,12 @@ inline stats_category to_stats_category(char const* name,
        {"pruned_by_earliest_arrival", s.pruned_by_earliest_arrival_},
        {"all_destinations_reached", s.all_destinations_reached_},
        {"total_earliest_arrival_updates", s.total_earliest_arrival_updates_},
-       {"lower_bounds_duration", s.lower_bounds_duration_}}};
+       {"lower_bounds_duration", s.lower_bounds_duration_},
+       {"search_chunks", s.search_chunks_},
+       {"max_chunk_search_duration", s.max_chunk_search_duration_},
+       {"merge_duration", s.merge_duration_},
+       {"transfer_cache_hits", s.transfer_cache_hits_},
+       {"transfer_cache_misses", s.transfer_cache_misses_}}};
 }
 
 }  // namespace motis::tripbased
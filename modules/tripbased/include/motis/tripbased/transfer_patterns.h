@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "cista/hash.h"
+#include "cista/memory_holder.h"
+
+#include "motis/vector.h"
+
+#include "motis/core/schedule/schedule.h"
+
+#include "motis/tripbased/data.h"
+#include "motis/tripbased/tb_journey.h"
+
+namespace motis::tripbased {
+
+constexpr auto const NO_RIDE = std::numeric_limits<uint32_t>::max();
+
+// A trip segment that serves a ride (from_stop_idx_ -> to_stop_idx_).
+struct tp_ride_segment {
+  line_id line_{};
+  stop_idx_t from_stop_idx_{};
+  stop_idx_t to_stop_idx_{};
+};
+
+struct tp_leg {
+  bool is_walk() const { return ride_ == NO_RIDE; }
+
+  station_id from_{};
+  station_id to_{};
+  uint32_t ride_{NO_RIDE};  // index into transfer_patterns::rides_
+  uint32_t duration_{};  // walks only
+};
+
+struct tp_target {
+  station_id station_{};
+  uint32_t first_pattern_{};
+  uint32_t pattern_count_{};
+};
+
+// Transfer patterns: for every pair of stations, the sequences of transfer
+// stations used by at least one optimal journey (arrival time / transfers)
+// found by profile searches over the preprocessing interval.
+// Queries only evaluate these patterns using direct connection lookups
+// instead of searching the timetable.
+struct transfer_patterns {
+  cista::hash_t schedule_hash_{0U};
+  time interval_begin_{INVALID_TIME};
+  time interval_end_{INVALID_TIME};
+
+  // indexed by source station, sorted by target station
+  mcd::vector<mcd::vector<tp_target>> targets_;
+  mcd::vector<mcd::vector<tp_leg>> patterns_;
+
+  // all line segments connecting the two stations of a ride
+  mcd::vector<mcd::vector<tp_ride_segment>> rides_;
+};
+
+transfer_patterns compute_transfer_patterns(tb_data const&, schedule const&,
+                                            time interval_begin,
+                                            time interval_end);
+
+transfer_patterns const* read_transfer_patterns(std::string const& path,
+                                                cista::memory_holder&);
+void write_transfer_patterns(std::string const& path,
+                             transfer_patterns const&);
+
+// Pareto optimal (arrival time, transfers) journeys departing at the source
+// station at or after start_time. The journeys are fully reconstructed.
+std::vector<tb_journey> tp_earliest_arrival(tb_data const&, schedule const&,
+                                            transfer_patterns const&,
+                                            station_id source,
+                                            station_id target,
+                                            time start_time);
+
+}  // namespace motis::tripbased
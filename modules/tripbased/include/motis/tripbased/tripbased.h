@@ -25,7 +25,17 @@ struct tripbased : public motis::module::module {
   tb_data const* get_data() const;
 
 private:
+  void update_transfer_patterns_file(schedule const&,
+                                     std::string const& data_file,
+                                     std::string const& tp_file);
+  void load_transfer_patterns();
+
   bool use_data_file_{true};
+  bool transfer_patterns_{false};
+  unsigned transfer_patterns_interval_{24};  // hours
+  unsigned profile_search_chunks_{1};
+  unsigned profile_search_min_chunk_{60};  // minutes
+  bool compress_transfers_{false};
 
   bool import_successful_{false};
 
@@ -0,0 +1,165 @@
+#include "motis/tripbased/compressed_transfers.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "utl/verify.h"
+
+#include "motis/core/common/logging.h"
+
+#include "motis/tripbased/data.h"
+
+using namespace motis::logging;
+
+namespace motis::tripbased {
+
+namespace {
+
+struct bit_writer {
+  void write(uint64_t const value, unsigned const width) {
+    if (width == 0U) {
+      return;
+    }
+    auto const shift = static_cast<unsigned>(size_ % 64U);
+    if (shift == 0U) {
+      bits_.push_back(0U);
+    }
+    bits_.back() |= value << shift;
+    if (shift + width > 64U) {
+      bits_.push_back(value >> (64U - shift));
+    }
+    size_ += width;
+  }
+
+  mcd::vector<uint64_t>& bits_;
+  uint64_t size_{0U};
+};
+
+unsigned bit_width(uint64_t value) {
+  auto width = 0U;
+  while (value != 0U) {
+    ++width;
+    value >>= 1U;
+  }
+  return width;
+}
+
+// Entry is tb_transfer or tb_reverse_transfer, GetEntry returns the
+// (trip, stop index) pair that is stored for an entry.
+template <typename Transfers, typename GetEntry>
+compressed_transfers compress_buckets(Transfers const& transfers,
+                                      GetEntry&& get_entry) {
+  using entry_t = std::pair<trip_id, stop_idx_t>;
+
+  compressed_transfers ct;
+  auto const bucket_count = transfers.index_size() - 1U;
+  ct.block_offset_.reserve(bucket_count / compressed_transfers::BLOCK_SIZE +
+                           1U);
+  ct.bucket_offset_.reserve(bucket_count + 1U);
+
+  bit_writer writer{ct.bits_};
+  std::vector<entry_t> bucket;
+  for (auto b = 0ULL; b <= bucket_count; ++b) {
+    if (b % compressed_transfers::BLOCK_SIZE == 0U) {
+      ct.block_offset_.push_back(writer.size_);
+    }
+    auto const relative_offset = writer.size_ - ct.block_offset_.back();
+    utl::verify(relative_offset <= std::numeric_limits<uint32_t>::max(),
+                "compress_transfers: block too large");
+    ct.bucket_offset_.push_back(static_cast<uint32_t>(relative_offset));
+    if (b == bucket_count) {
+      break;
+    }
+
+    bucket.clear();
+    for (auto i = transfers.index_[b]; i != transfers.index_[b + 1]; ++i) {
+      bucket.emplace_back(get_entry(transfers.data_[i]));
+    }
+    if (bucket.empty()) {
+      continue;
+    }
+    std::sort(begin(bucket), end(bucket),
+              [](entry_t const& x, entry_t const& y) {
+                return x.first < y.first;
+              });
+
+    auto max_delta = uint64_t{0U};
+    auto max_stop_idx = uint64_t{0U};
+    for (auto i = 0U; i < bucket.size(); ++i) {
+      if (i != 0U) {
+        max_delta = std::max(
+            max_delta, uint64_t{bucket[i].first - bucket[i - 1].first});
+      }
+      max_stop_idx = std::max(max_stop_idx, uint64_t{bucket[i].second});
+    }
+    auto const trip_bits = bit_width(max_delta);
+    auto const stop_bits = bit_width(max_stop_idx);
+
+    if (bucket.size() < 0xFFU) {
+      writer.write(bucket.size(), 8U);
+    } else {
+      writer.write(0xFFU, 8U);
+      writer.write(bucket.size(), 32U);
+    }
+    writer.write(trip_bits, 6U);
+    writer.write(stop_bits, 5U);
+    writer.write(bucket.front().first, 32U);
+    for (auto i = 1U; i < bucket.size(); ++i) {
+      writer.write(bucket[i].first - bucket[i - 1].first, trip_bits);
+    }
+    for (auto const& e : bucket) {
+      writer.write(e.second, stop_bits);
+    }
+  }
+
+  return ct;
+}
+
+}  // namespace
+
+compressed_transfers compress_transfers(tb_data const& data) {
+  utl::verify(data.transfers_.finished(),
+              "compress_transfers: transfers not ready");
+  return compress_buckets(data.transfers_, [](tb_transfer const& t) {
+    return std::make_pair(t.to_trip_, t.to_stop_idx_);
+  });
+}
+
+compressed_transfers compress_reverse_transfers(tb_data const& data) {
+  utl::verify(data.reverse_transfers_.finished(),
+              "compress_reverse_transfers: reverse transfers not ready");
+  return compress_buckets(data.reverse_transfers_,
+                          [](tb_reverse_transfer const& t) {
+                            return std::make_pair(t.from_trip_,
+                                                  t.from_stop_idx_);
+                          });
+}
+
+void use_compressed_transfers(tb_data& data) {
+  auto const uncompressed_size =
+      data.transfers_.index_size() * sizeof(uint64_t) +
+      data.transfers_.data_size() * sizeof(tb_transfer);
+  auto const uncompressed_reverse_size =
+      data.reverse_transfers_.index_size() * sizeof(uint64_t) +
+      data.reverse_transfers_.data_size() * sizeof(tb_reverse_transfer);
+
+  data.compressed_transfers_ = compress_transfers(data);
+  data.transfers_.index_ = {};
+  data.transfers_.data_ = {};
+
+  data.compressed_reverse_transfers_ = compress_reverse_transfers(data);
+  data.reverse_transfers_.index_ = {};
+  data.reverse_transfers_.data_ = {};
+
+  LOG(info) << "compressed transfers: " << (uncompressed_size / 1024 / 1024)
+            << " MB -> "
+            << (data.compressed_transfers_.size_bytes() / 1024 / 1024)
+            << " MB, reverse transfers: "
+            << (uncompressed_reverse_size / 1024 / 1024) << " MB -> "
+            << (data.compressed_reverse_transfers_.size_bytes() / 1024 / 1024)
+            << " MB";
+}
+
+}  // namespace motis::tripbased
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "utl/to_vec.h"
 #include "utl/verify.h"
@@ -115,22 +116,25 @@ Offset<Vector<Offset<TransferDebugInfo>>> get_transfer_debug_info(
   auto const from_trip = fbs_tb_trip_id(fbb, sched, trp);
   auto const from_station = fbs_station(
       fbb, sched, data.stops_on_line_[data.trip_to_line_[trp]][stop_idx]);
-  return fbb.CreateVector(utl::to_vec(
-      data.transfers_.at(trp, stop_idx), [&](tb_transfer const& transfer) {
-        return CreateTransferDebugInfo(
-            fbb, from_trip, fbs_tb_trip_id(fbb, sched, transfer.to_trip_),
-            stop_idx, transfer.to_stop_idx_,
-            static_cast<uint64_t>(
-                motis_to_unixtime(sched, data.arrival_times_[trp][stop_idx])),
-            static_cast<uint64_t>(motis_to_unixtime(
-                sched, data.departure_times_[transfer.to_trip_]
-                                            [transfer.to_stop_idx_])),
-            from_station,
-            fbs_station(
-                fbb, sched,
-                data.stops_on_line_[data.trip_to_line_[transfer.to_trip_]]
-                                   [transfer.to_stop_idx_]));
-      }));
+  std::vector<tb_transfer> transfers;
+  data.for_each_transfer(trp, stop_idx, [&](tb_transfer const& transfer) {
+    transfers.push_back(transfer);
+  });
+  return fbb.CreateVector(utl::to_vec(transfers, [&](tb_transfer const&
+                                                          transfer) {
+    return CreateTransferDebugInfo(
+        fbb, from_trip, fbs_tb_trip_id(fbb, sched, transfer.to_trip_),
+        stop_idx, transfer.to_stop_idx_,
+        static_cast<uint64_t>(
+            motis_to_unixtime(sched, data.arrival_times_[trp][stop_idx])),
+        static_cast<uint64_t>(motis_to_unixtime(
+            sched,
+            data.departure_times_[transfer.to_trip_][transfer.to_stop_idx_])),
+        from_station,
+        fbs_station(fbb, sched,
+                    data.stops_on_line_[data.trip_to_line_[transfer.to_trip_]]
+                                       [transfer.to_stop_idx_]));
+  }));
 }
 
 Offset<Vector<Offset<TransferDebugInfo>>> get_reverse_transfer_debug_info(
@@ -139,9 +143,13 @@ Offset<Vector<Offset<TransferDebugInfo>>> get_reverse_transfer_debug_info(
   auto const to_trip = fbs_tb_trip_id(fbb, sched, trp);
   auto const to_station = fbs_station(
       fbb, sched, data.stops_on_line_[data.trip_to_line_[trp]][stop_idx]);
+  std::vector<tb_reverse_transfer> transfers;
+  data.for_each_reverse_transfer(
+      trp, stop_idx, [&](tb_reverse_transfer const& transfer) {
+        transfers.push_back(transfer);
+      });
   return fbb.CreateVector(utl::to_vec(
-      data.reverse_transfers_.at(trp, stop_idx),
-      [&](tb_reverse_transfer const& transfer) {
+      transfers, [&](tb_reverse_transfer const& transfer) {
         return CreateTransferDebugInfo(
             fbb, fbs_tb_trip_id(fbb, sched, transfer.from_trip_), to_trip,
             transfer.from_stop_idx_, stop_idx,
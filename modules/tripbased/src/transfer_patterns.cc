@@ -0,0 +1,334 @@
+#include "motis/tripbased/transfer_patterns.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include "cista/mmap.h"
+#include "cista/serialization.h"
+
+#include "utl/erase_if.h"
+#include "utl/parallel_for.h"
+#include "utl/progress_tracker.h"
+#include "utl/to_vec.h"
+
+#include "motis/core/common/logging.h"
+
+#include "motis/tripbased/limits.h"
+#include "motis/tripbased/tb_profile_search.h"
+
+using namespace motis::logging;
+
+namespace motis::tripbased {
+
+constexpr auto const CISTA_MODE =
+    cista::mode::WITH_INTEGRITY | cista::mode::WITH_VERSION;
+
+namespace {
+
+struct raw_leg {
+  friend bool operator<(raw_leg const& a, raw_leg const& b) {
+    return std::tie(a.from_, a.to_, a.walk_, a.duration_) <
+           std::tie(b.from_, b.to_, b.walk_, b.duration_);
+  }
+
+  station_id from_{};
+  station_id to_{};
+  bool walk_{false};
+  uint32_t duration_{};
+};
+
+using raw_pattern = std::vector<raw_leg>;
+
+raw_pattern to_pattern(tb_data const& data, tb_journey const& j) {
+  raw_pattern pattern;
+  for (auto const& e : j.edges_) {
+    if (e.is_connection()) {
+      auto const stops = data.stops_on_line_[data.trip_to_line_[e.trip_]];
+      pattern.push_back(raw_leg{stops[e.from_stop_index_],
+                                stops[e.to_stop_index_], false, 0U});
+    } else if (e.footpath_.is_interstation_walk()) {
+      pattern.push_back(raw_leg{e.footpath_.from_stop_, e.footpath_.to_stop_,
+                                true, e.footpath_.duration_});
+    }
+  }
+  return pattern;
+}
+
+std::map<station_id, std::set<raw_pattern>> compute_source_patterns(
+    tb_data const& data, schedule const& sched, station_id const source,
+    std::vector<station_id> const& targets, time const interval_begin,
+    time const interval_end) {
+  tb_profile_search<search_dir::FWD> tbs(data, sched, interval_begin,
+                                         interval_end, false, false,
+                                         destination_mode::ALL);
+  tbs.add_start(source, 0, true);
+  for (auto const target : targets) {
+    if (target != source) {
+      tbs.add_destination(target, true);
+    }
+  }
+  tbs.search();
+
+  std::map<station_id, std::set<raw_pattern>> patterns;
+  for (auto const target : targets) {
+    if (target == source) {
+      continue;
+    }
+    for (auto const& j : tbs.get_results(target)) {
+      if (!j.edges_.empty()) {
+        patterns[target].emplace(to_pattern(data, j));
+      }
+    }
+  }
+  return patterns;
+}
+
+mcd::vector<tp_ride_segment> get_ride_segments(tb_data const& data,
+                                               station_id const from,
+                                               station_id const to) {
+  mcd::vector<tp_ride_segment> segments;
+  for (auto const& [line, from_stop_idx, _] : data.lines_at_stop_[from]) {
+    (void)_;
+    if (data.in_allowed_[line][from_stop_idx] == 0U) {
+      continue;
+    }
+    auto const stops = data.stops_on_line_[line];
+    for (auto to_stop_idx = static_cast<stop_idx_t>(from_stop_idx + 1);
+         to_stop_idx < stops.size(); ++to_stop_idx) {
+      if (stops[to_stop_idx] == to &&
+          data.out_allowed_[line][to_stop_idx] != 0U) {
+        segments.push_back(tp_ride_segment{line, from_stop_idx, to_stop_idx});
+        break;
+      }
+    }
+  }
+  return segments;
+}
+
+// Trips of a line do not overtake each other -> departures are sorted.
+std::optional<trip_id> first_reachable_trip(tb_data const& data,
+                                            line_id const line,
+                                            stop_idx_t const stop_idx,
+                                            time const earliest_departure) {
+  auto lo = data.line_to_first_trip_[line];
+  auto hi = data.line_to_last_trip_[line] + 1;
+  while (lo < hi) {
+    auto const mid = lo + (hi - lo) / 2;
+    if (data.departure_times_[mid][stop_idx] < earliest_departure) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo <= data.line_to_last_trip_[line] ? std::optional{lo}
+                                              : std::nullopt;
+}
+
+std::optional<tb_journey> evaluate_pattern(tb_data const& data,
+                                           schedule const& sched,
+                                           transfer_patterns const& tp,
+                                           mcd::vector<tp_leg> const& pattern,
+                                           station_id const source,
+                                           station_id const target,
+                                           time const start_time) {
+  tb_journey j;
+  j.dir_ = search_dir::FWD;
+  j.start_time_ = start_time;
+  j.start_station_ = source;
+  j.destination_station_ = target;
+
+  auto t = static_cast<unsigned>(start_time);
+  auto transports = 0U;
+  auto after_ride = false;
+  for (auto const& leg : pattern) {
+    if (leg.is_walk()) {
+      j.edges_.emplace_back(tb_footpath{leg.from_, leg.to_, leg.duration_},
+                            static_cast<time>(t),
+                            static_cast<time>(t + leg.duration_));
+      t += leg.duration_;
+      after_ride = false;
+      continue;
+    }
+
+    auto const earliest_departure =
+        t + (after_ride ? sched.stations_[leg.from_]->transfer_time_ : 0U);
+    if (earliest_departure >= INVALID_TIME) {
+      return std::nullopt;
+    }
+
+    auto best = std::optional<tb_journey::tb_edge>{};
+    for (auto const& seg : tp.rides_[leg.ride_]) {
+      auto const trip =
+          first_reachable_trip(data, seg.line_, seg.from_stop_idx_,
+                               static_cast<time>(earliest_departure));
+      if (!trip.has_value()) {
+        continue;
+      }
+      auto const arrival = data.arrival_times_[*trip][seg.to_stop_idx_];
+      if (!best.has_value() || arrival < best->arrival_time_) {
+        best = tb_journey::tb_edge{
+            *trip, seg.from_stop_idx_, seg.to_stop_idx_,
+            data.departure_times_[*trip][seg.from_stop_idx_], arrival};
+      }
+    }
+    if (!best.has_value()) {
+      return std::nullopt;
+    }
+
+    j.edges_.emplace_back(*best);
+    t = best->arrival_time_;
+    after_ride = true;
+    ++transports;
+  }
+
+  if (transports == 0U || t - start_time > MAX_TRAVEL_TIME) {
+    return std::nullopt;
+  }
+
+  // Leave as late as possible if the journey starts with a walk.
+  if (j.edges_.size() > 1U && j.edges_[0].is_walk() &&
+      j.edges_[1].is_connection()) {
+    auto& walk = j.edges_[0];
+    walk.arrival_time_ = j.edges_[1].departure_time_;
+    walk.departure_time_ =
+        static_cast<time>(walk.arrival_time_ - walk.footpath_.duration_);
+  }
+
+  j.arrival_time_ = static_cast<time>(t);
+  j.duration_ = t - start_time;
+  j.transports_ = transports;
+  j.transfers_ = transports - 1U;
+  return j;
+}
+
+}  // namespace
+
+transfer_patterns compute_transfer_patterns(tb_data const& data,
+                                            schedule const& sched,
+                                            time const interval_begin,
+                                            time const interval_end) {
+  // Stations 0 and 1 are the virtual intermodal start/end stations.
+  std::vector<station_id> stations(sched.stations_.size() - 2U);
+  std::iota(begin(stations), end(stations), station_id{2U});
+
+  auto sources = stations;
+  utl::erase_if(sources, [&](station_id const s) {
+    return data.lines_at_stop_[s].empty() && data.footpaths_[s].empty();
+  });
+
+  transfer_patterns tp;
+  tp.schedule_hash_ = sched.hash_;
+  tp.interval_begin_ = interval_begin;
+  tp.interval_end_ = interval_end;
+  tp.targets_.resize(sched.stations_.size());
+
+  auto progress_tracker =
+      utl::get_active_progress_tracker_or_activate("tripbased");
+  progress_tracker->status("Transfer Patterns").in_high(sources.size());
+
+  std::mutex mutex;
+  std::map<std::pair<station_id, station_id>, uint32_t> ride_idx;
+  utl::parallel_for(sources, [&](station_id const source) {
+    auto const source_patterns = compute_source_patterns(
+        data, sched, source, stations, interval_begin, interval_end);
+
+    std::lock_guard const lock{mutex};
+    auto& targets = tp.targets_[source];
+    for (auto const& [target, patterns] : source_patterns) {
+      targets.push_back(tp_target{target,
+                                  static_cast<uint32_t>(tp.patterns_.size()),
+                                  static_cast<uint32_t>(patterns.size())});
+      for (auto const& pattern : patterns) {
+        tp.patterns_.emplace_back(utl::to_vec(pattern, [&](raw_leg const& l) {
+          if (l.walk_) {
+            return tp_leg{l.from_, l.to_, NO_RIDE, l.duration_};
+          }
+          auto const [it, inserted] =
+              ride_idx.emplace(std::pair{l.from_, l.to_},
+                               static_cast<uint32_t>(tp.rides_.size()));
+          if (inserted) {
+            tp.rides_.emplace_back(get_ride_segments(data, l.from_, l.to_));
+          }
+          return tp_leg{l.from_, l.to_, it->second, 0U};
+        }));
+      }
+    }
+    progress_tracker->increment();
+  });
+
+  LOG(info) << "transfer patterns: " << tp.patterns_.size() << " patterns, "
+            << tp.rides_.size() << " rides";
+  return tp;
+}
+
+transfer_patterns const* read_transfer_patterns(std::string const& path,
+                                                cista::memory_holder& mem) {
+#if defined(MOTIS_SCHEDULE_MODE_OFFSET) && !defined(CLANG_TIDY)
+  mem = cista::buf<cista::mmap>(
+      cista::mmap{path.c_str(), cista::mmap::protection::READ});
+  return cista::deserialize<transfer_patterns, CISTA_MODE>(
+      std::get<cista::buf<cista::mmap>>(mem));
+#elif defined(MOTIS_SCHEDULE_MODE_RAW) || defined(CLANG_TIDY)
+  mem = cista::file(path.c_str(), "r").content();
+  // NOLINTNEXTLINE
+  return cista::deserialize<transfer_patterns, CISTA_MODE>(
+      std::get<cista::buffer>(mem));
+#else
+#error "no ptr mode specified"
+#endif
+}
+
+void write_transfer_patterns(std::string const& path,
+                             transfer_patterns const& tp) {
+  auto writer = cista::buf<cista::mmap>(
+      cista::mmap{path.c_str(), cista::mmap::protection::WRITE});
+  cista::serialize<CISTA_MODE>(writer, tp);
+}
+
+std::vector<tb_journey> tp_earliest_arrival(tb_data const& data,
+                                            schedule const& sched,
+                                            transfer_patterns const& tp,
+                                            station_id const source,
+                                            station_id const target,
+                                            time const start_time) {
+  auto const& targets = tp.targets_[source];
+  auto const it = std::lower_bound(
+      begin(targets), end(targets), target,
+      [](tp_target const& t, station_id const s) { return t.station_ < s; });
+  if (it == end(targets) || it->station_ != target) {
+    return {};
+  }
+
+  std::vector<tb_journey> results;
+  for (auto i = it->first_pattern_;
+       i < it->first_pattern_ + it->pattern_count_; ++i) {
+    auto const j = evaluate_pattern(data, sched, tp, tp.patterns_[i], source,
+                                    target, start_time);
+    if (!j.has_value() ||
+        std::any_of(begin(results), end(results), [&](tb_journey const& o) {
+          return o.arrival_time_ <= j->arrival_time_ &&
+                 o.transfers_ <= j->transfers_;
+        })) {
+      continue;
+    }
+    utl::erase_if(results, [&](tb_journey const& o) {
+      return j->arrival_time_ <= o.arrival_time_ &&
+             j->transfers_ <= o.transfers_;
+    });
+    results.emplace_back(*j);
+  }
+
+  std::sort(begin(results), end(results),
+            [](tb_journey const& a, tb_journey const& b) {
+              return a.transfers_ < b.transfers_;
+            });
+  return results;
+}
+
+}  // namespace motis::tripbased
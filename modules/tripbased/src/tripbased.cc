@@ -15,6 +15,7 @@
 #include "utl/raii.h"
 #include "utl/to_vec.h"
 
+#include "motis/tripbased/compressed_transfers.h"
 #include "motis/tripbased/data.h"
 #include "motis/tripbased/debug.h"
 #include "motis/tripbased/error.h"
@@ -23,8 +24,11 @@
 #include "motis/tripbased/query.h"
 #include "motis/tripbased/tb_journey.h"
 #include "motis/tripbased/tb_ontrip_search.h"
+#include "motis/tripbased/tb_parallel_profile_search.h"
 #include "motis/tripbased/tb_profile_search.h"
+#include "motis/tripbased/tb_search_memory.h"
 #include "motis/tripbased/tb_to_journey.h"
+#include "motis/tripbased/transfer_patterns.h"
 #include "motis/tripbased/tripbased.h"
 
 #include "motis/core/common/logging.h"
@@ -242,16 +246,19 @@ void add_result(std::vector<tb_journey>& results, tb_journey const& tbj,
 }
 
 struct tripbased::impl {
-  explicit impl(schedule const& sched, std::unique_ptr<tb_data> data)
-      : tb_data_{std::move(data)}, sched_{sched} {}
+  impl(tripbased const& module, schedule const& sched,
+       std::unique_ptr<tb_data> data)
+      : module_{module}, tb_data_{std::move(data)}, sched_{sched} {}
 
   msg_ptr route(msg_ptr const& msg) {
     auto const req = motis_content(RoutingRequest, msg);
 
     auto const query = build_tb_query(req, sched_);
 
-    auto res = route_dispatch(query, sched_);
+    return make_response(route_dispatch(query, sched_));
+  }
 
+  msg_ptr make_response(trip_based_result const& res) const {
     message_creator fbb;
     auto stats =
         utl::to_vec(res.stats_, [&](auto const& s) { return to_fbs(fbb, s); });
@@ -298,10 +305,12 @@ struct tripbased::impl {
                                          schedule const& sched) {
     trip_based_result res{};
     MOTIS_START_TIMING(search_timing);
+    auto const mem = search_memory_.acquire();
     tb_ontrip_search<Dir> tbs(
         *tb_data_, sched, q.start_time_, q.intermodal_start_,
         q.intermodal_destination_,
-        q.use_dest_metas_ ? destination_mode::ANY : destination_mode::ALL);
+        q.use_dest_metas_ ? destination_mode::ANY : destination_mode::ALL,
+        &mem.get());
 
     add_starts_and_destinations(q, tbs);
 
@@ -376,22 +385,19 @@ struct tripbased::impl {
         q.use_dest_metas_ ? destination_mode::ANY : destination_mode::ALL;
 
     while (!max_interval_reached) {
-      MOTIS_START_TIMING(iteration_search_timing);
       max_interval_reached =
           (!q.extend_interval_earlier_ || interval_begin == schedule_begin) &&
           (!q.extend_interval_later_ || interval_end == schedule_end);
 
-      tb_profile_search<Dir> tbs(*tb_data_, sched, interval_begin, interval_end,
-                                 q.intermodal_start_, q.intermodal_destination_,
-                                 dest_mode);
+      tb_parallel_profile_search<Dir> tbs(
+          *tb_data_, sched, interval_begin, interval_end, q.intermodal_start_,
+          q.intermodal_destination_, dest_mode,
+          module_.profile_search_chunks_, module_.profile_search_min_chunk_);
       add_starts_and_destinations(q, tbs);
       tbs.search();
       res.interval_begin_ = interval_begin;
       res.interval_end_ = interval_end;
       build_results<Dir>(q, res, sched, tbs);
-      MOTIS_STOP_TIMING(iteration_search_timing);
-      tbs.get_statistics().search_duration_ =
-          MOTIS_TIMING_MS(iteration_search_timing);
       tb_stats.push_back(tbs.get_statistics());
       if (res.journeys_.size() >= q.min_connection_count_) {
         break;
@@ -602,6 +608,45 @@ struct tripbased::impl {
     });
   }
 
+  msg_ptr route_transfer_patterns(msg_ptr const& msg) const {
+    if (tp_ == nullptr) {
+      throw std::system_error(error::transfer_patterns_not_available);
+    }
+
+    auto const req = motis_content(RoutingRequest, msg);
+    auto const q = build_tb_query(req, sched_);
+    if (!q.is_ontrip()) {
+      throw std::system_error(error::start_type_not_supported);
+    }
+    if (q.dir_ != search_dir::FWD || q.intermodal_start_ ||
+        q.intermodal_destination_) {
+      throw std::system_error(error::not_implemented);
+    }
+
+    MOTIS_START_TIMING(search_timing);
+    std::vector<tb_journey> results;
+    for (auto const start : q.meta_starts_) {
+      for (auto const destination : q.meta_destinations_) {
+        for (auto const& tbj : tp_earliest_arrival(
+                 *tb_data_, sched_, *tp_, start, destination, q.start_time_)) {
+          if (q.use_start_footpaths_ || !tbj.edges_.front().is_walk()) {
+            add_result(results, tbj, q);
+          }
+        }
+      }
+    }
+    MOTIS_STOP_TIMING(search_timing);
+
+    trip_based_result res{std::vector<stats_category>{stats_category{
+        "tripbased.transfer_patterns",
+        {{"search_duration_us",
+          static_cast<uint64_t>(MOTIS_TIMING_US(search_timing))}}}}};
+    res.journeys_ = utl::to_vec(results, [&](tb_journey const& tbj) {
+      return tb_to_journey(sched_, tbj);
+    });
+    return make_response(res);
+  }
+
   msg_ptr debug(msg_ptr const& msg) const {
     auto const req = motis_content(TripBasedTripDebugRequest, msg);
 
@@ -625,10 +670,34 @@ struct tripbased::impl {
     return make_msg(fbb);
   }
 
+  tripbased const& module_;  // module parameters
   std::unique_ptr<tb_data> tb_data_;
   schedule const& sched_;
+
+  tb_search_memory_pool search_memory_;
+
+  cista::memory_holder tp_mem_;
+  std::unique_ptr<transfer_patterns> tp_owned_;
+  transfer_patterns const* tp_{nullptr};
 };
 
+std::pair<time, time> transfer_patterns_interval(schedule const& sched,
+                                                 unsigned const hours) {
+  auto const schedule_end =
+      static_cast<time>((sched.schedule_end_ - sched.schedule_begin_) / 60);
+  auto const begin = static_cast<time>(SCHEDULE_OFFSET_MINUTES);
+  auto const end = static_cast<time>(
+      std::min(static_cast<unsigned>(schedule_end), begin + hours * 60U - 1U));
+  return {begin, end};
+}
+
+bool transfer_patterns_okay(transfer_patterns const& tp, schedule const& sched,
+                            std::pair<time, time> const& interval) {
+  return tp.schedule_hash_ == sched.hash_ &&
+         tp.interval_begin_ == interval.first &&
+         tp.interval_end_ == interval.second;
+}
+
 struct import_state {
   CISTA_COMPARABLE()
   named<cista::hash_t, MOTIS_NAME("schedule_hash")> schedule_hash_;
@@ -637,6 +706,19 @@ struct import_state {
 tripbased::tripbased() : module("Trip-Based Routing Options", "tripbased") {
   param(use_data_file_, "use_data_file",
         "create a data_file to speed up subsequent loading");
+  param(transfer_patterns_, "transfer_patterns",
+        "precompute transfer patterns for /tripbased/transfer_patterns");
+  param(transfer_patterns_interval_, "transfer_patterns_interval",
+        "transfer pattern preprocessing interval in hours (from schedule "
+        "begin)");
+  param(profile_search_chunks_, "profile_search_chunks",
+        "max. number of departure time chunks searched in parallel by pretrip "
+        "queries (1 = sequential)");
+  param(profile_search_min_chunk_, "profile_search_min_chunk",
+        "min. length of a departure time chunk in minutes");
+  param(compress_transfers_, "compress_transfers",
+        "keep the transfer set bit-packed in memory (less memory, slower "
+        "queries)");
 }
 
 tripbased::~tripbased() = default;
@@ -665,6 +747,12 @@ void tripbased::import(motis::module::import_dispatcher& reg) {
         update_data_file(sched, filename.generic_string(),
                          read_ini<import_state>(dir / "import.ini") != state);
 
+        if (transfer_patterns_) {
+          update_transfer_patterns_file(
+              sched, filename.generic_string(),
+              (dir / "transfer_patterns.bin").generic_string());
+        }
+
         import_successful_ = true;
         write_ini(dir / "import.ini", state);
       })
@@ -675,26 +763,84 @@ void tripbased::import(motis::module::import_dispatcher& reg) {
 
 void tripbased::init(motis::module::registry& reg) {
   try {
-    if (use_data_file_) {
-      auto const filename =
-          get_data_directory() / "tripbased" / "tripbased.bin";
-      impl_ = std::make_unique<impl>(
-          get_sched(), load_data(get_sched(), filename.generic_string()));
-    } else {
-      impl_ = std::make_unique<impl>(get_sched(), build_data(get_sched()));
+    auto data =
+        use_data_file_
+            ? load_data(get_sched(),
+                        (get_data_directory() / "tripbased" / "tripbased.bin")
+                            .generic_string())
+            : build_data(get_sched());
+    if (compress_transfers_) {
+      use_compressed_transfers(*data);
     }
+    impl_ = std::make_unique<impl>(*this, get_sched(), std::move(data));
 
     reg.register_op("/tripbased",
                     [this](msg_ptr const& m) { return impl_->route(m); });
     reg.register_op("/tripbased/debug",
                     [this](msg_ptr const& m) { return impl_->debug(m); });
 
+    if (transfer_patterns_) {
+      load_transfer_patterns();
+      reg.register_op("/tripbased/transfer_patterns", [this](msg_ptr const& m) {
+        return impl_->route_transfer_patterns(m);
+      });
+    }
+
   } catch (std::exception const& e) {
     LOG(logging::warn) << "tripbased module not initialized (" << e.what()
                        << ")";
   }
 }
 
+void tripbased::update_transfer_patterns_file(schedule const& sched,
+                                              std::string const& data_file,
+                                              std::string const& tp_file) {
+  auto const interval =
+      transfer_patterns_interval(sched, transfer_patterns_interval_);
+  if (boost::filesystem::exists(tp_file)) {
+    cista::memory_holder mem;
+    if (transfer_patterns_okay(*read_transfer_patterns(tp_file, mem), sched,
+                               interval)) {
+      return;
+    }
+    LOG(info) << "existing transfer patterns are not okay: " << tp_file;
+  }
+
+  LOG(info) << "calculating transfer patterns...";
+  auto const data = load_data(sched, data_file);
+  auto const tp =
+      compute_transfer_patterns(*data, sched, interval.first, interval.second);
+  LOG(info) << "writing transfer patterns to file " << tp_file;
+  scoped_timer write_timer{"transfer patterns serialization"};
+  write_transfer_patterns(tp_file, tp);
+}
+
+void tripbased::load_transfer_patterns() {
+  auto const& sched = get_sched();
+  auto const interval =
+      transfer_patterns_interval(sched, transfer_patterns_interval_);
+  if (use_data_file_) {
+    auto const filename =
+        get_data_directory() / "tripbased" / "transfer_patterns.bin";
+    if (!boost::filesystem::exists(filename)) {
+      LOG(logging::warn) << "transfer patterns not found: " << filename;
+      return;
+    }
+    auto const tp =
+        read_transfer_patterns(filename.generic_string(), impl_->tp_mem_);
+    if (!transfer_patterns_okay(*tp, sched, interval)) {
+      LOG(logging::warn) << "transfer patterns outdated: " << filename;
+      return;
+    }
+    impl_->tp_ = tp;
+  } else {
+    impl_->tp_owned_ =
+        std::make_unique<transfer_patterns>(compute_transfer_patterns(
+            *impl_->tb_data_, sched, interval.first, interval.second));
+    impl_->tp_ = impl_->tp_owned_.get();
+  }
+}
+
 bool tripbased::import_successful() const { return import_successful_; }
 
 tb_data const* tripbased::get_data() const {
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "motis/core/access/time_access.h"
+
+#include "motis/tripbased/compressed_transfers.h"
+#include "motis/tripbased/preprocessing.h"
+#include "motis/tripbased/tb_profile_search.h"
+
+#include "./simple_realtime_data.h"
+
+using namespace motis;
+using namespace motis::tripbased;
+
+namespace {
+
+using transfer_t = std::pair<trip_id, stop_idx_t>;
+using reverse_transfer_t = std::tuple<trip_id, stop_idx_t, stop_idx_t>;
+using result_t = std::vector<std::pair<time, unsigned>>;
+
+std::vector<transfer_t> get_transfers(tb_data const& data, trip_id const trip,
+                                      stop_idx_t const stop_idx) {
+  std::vector<transfer_t> transfers;
+  data.for_each_transfer(trip, stop_idx, [&](tb_transfer const& t) {
+    transfers.emplace_back(t.to_trip_, t.to_stop_idx_);
+  });
+  std::sort(begin(transfers), end(transfers));
+  return transfers;
+}
+
+std::vector<reverse_transfer_t> get_reverse_transfers(
+    tb_data const& data, trip_id const trip, stop_idx_t const stop_idx) {
+  std::vector<reverse_transfer_t> transfers;
+  data.for_each_reverse_transfer(
+      trip, stop_idx, [&](tb_reverse_transfer const& t) {
+        transfers.emplace_back(t.from_trip_, t.from_stop_idx_, t.to_stop_idx_);
+      });
+  std::sort(begin(transfers), end(transfers));
+  return transfers;
+}
+
+// tb_data with only the buckets: trip i has bucket_sizes[i].size() stops,
+// bucket (i, s) gets bucket_sizes[i][s] transfers and reverse transfers.
+std::unique_ptr<tb_data> make_buckets(
+    std::vector<std::vector<unsigned>> const& bucket_sizes) {
+  auto data = std::make_unique<tb_data>();
+  for (auto const& trip_buckets : bucket_sizes) {
+    for (auto i = 0U; i < trip_buckets.size(); ++i) {
+      data->arrival_times_.push_back(0);
+    }
+    data->arrival_times_.finish_key();
+  }
+  data->arrival_times_.finish_map();
+
+  auto next = 0U;
+  for (auto const& trip_buckets : bucket_sizes) {
+    for (auto stop = 0U; stop < trip_buckets.size(); ++stop) {
+      for (auto i = 0U; i < trip_buckets[stop]; ++i, ++next) {
+        // unsorted trips with varying deltas and stop indices
+        auto const trip = static_cast<trip_id>((next * 7919U) % 100'003U);
+        auto const stop_idx = static_cast<stop_idx_t>(next % 37U);
+        data->transfers_.emplace_back(trip, stop_idx);
+        data->reverse_transfers_.emplace_back(trip, stop_idx,
+                                              static_cast<stop_idx_t>(stop));
+      }
+      data->transfers_.finish_nested_key();
+      data->reverse_transfers_.finish_nested_key();
+    }
+    data->transfers_.finish_base_key();
+    data->reverse_transfers_.finish_base_key();
+  }
+  data->transfers_.finish_map();
+  data->reverse_transfers_.finish_map();
+  return data;
+}
+
+result_t route_pretrip(tb_data const& data, schedule const& sched,
+                       station_id const from, station_id const to,
+                       time const interval_begin, time const interval_end) {
+  tb_profile_search<search_dir::FWD> tbs(data, sched, interval_begin,
+                                         interval_end, false, false,
+                                         destination_mode::ALL);
+  tbs.add_start(from, 0);
+  tbs.add_destination(to);
+  tbs.search();
+
+  result_t result;
+  for (auto const& j : tbs.get_results(to)) {
+    result.emplace_back(j.arrival_time_, j.transfers_);
+  }
+  std::sort(begin(result), end(result));
+  return result;
+}
+
+struct tripbased_compressed_transfers : public tripbased_simple_realtime {
+  tripbased_compressed_transfers() : compressed_data_{build_data(*sched_)} {
+    use_compressed_transfers(*compressed_data_);
+  }
+
+  std::unique_ptr<tb_data> compressed_data_;
+};
+
+}  // namespace
+
+TEST_F(tripbased_compressed_transfers, same_transfers) {
+  ASSERT_FALSE(compressed_data_->compressed_transfers_.empty());
+  ASSERT_FALSE(compressed_data_->compressed_reverse_transfers_.empty());
+  EXPECT_EQ(0U, compressed_data_->transfers_.data_size());
+  EXPECT_EQ(0U, compressed_data_->reverse_transfers_.data_size());
+
+  auto transfer_count = 0U;
+  auto reverse_transfer_count = 0U;
+  for (auto trip = trip_id{0U}; trip < data_->trip_count_; ++trip) {
+    auto const line = data_->trip_to_line_[trip];
+    for (auto stop_idx = stop_idx_t{0U};
+         stop_idx < data_->line_stop_count_[line]; ++stop_idx) {
+      auto const expected = get_transfers(*data_, trip, stop_idx);
+      EXPECT_EQ(expected, get_transfers(*compressed_data_, trip, stop_idx));
+      transfer_count += expected.size();
+
+      auto const expected_reverse =
+          get_reverse_transfers(*data_, trip, stop_idx);
+      EXPECT_EQ(expected_reverse,
+                get_reverse_transfers(*compressed_data_, trip, stop_idx));
+      reverse_transfer_count += expected_reverse.size();
+    }
+  }
+  EXPECT_EQ(data_->transfers_.data_size(), transfer_count);
+  EXPECT_EQ(data_->reverse_transfers_.data_size(), reverse_transfer_count);
+}
+
+TEST(tripbased_compressed_transfer_buckets, large_buckets) {
+  // counts >= 255 are stored with the 32 bit escape, more than one block
+  auto sizes = std::vector<std::vector<unsigned>>{
+      {0U, 1U, 254U, 255U}, {256U, 0U}, {1000U, 2U, 70'000U}};
+  sizes.emplace_back(compressed_transfers::BLOCK_SIZE + 3U, 1U);
+  auto const data = make_buckets(sizes);
+  auto const compressed = make_buckets(sizes);
+  use_compressed_transfers(*compressed);
+  ASSERT_FALSE(compressed->compressed_transfers_.empty());
+  ASSERT_FALSE(compressed->compressed_reverse_transfers_.empty());
+
+  for (auto trip = trip_id{0U}; trip < sizes.size(); ++trip) {
+    for (auto stop_idx = stop_idx_t{0U}; stop_idx < sizes[trip].size();
+         ++stop_idx) {
+      auto const expected = get_transfers(*data, trip, stop_idx);
+      ASSERT_EQ(sizes[trip][stop_idx], expected.size());
+      EXPECT_EQ(expected, get_transfers(*compressed, trip, stop_idx));
+      EXPECT_EQ(get_reverse_transfers(*data, trip, stop_idx),
+                get_reverse_transfers(*compressed, trip, stop_idx));
+    }
+  }
+}
+
+TEST_F(tripbased_compressed_transfers, same_results) {
+  for_each_station_pair([&](station_id const from, station_id const to) {
+    for (auto hhmm = 1200; hhmm < 1800; hhmm += 15) {
+      auto const start_time = motis_time(hhmm);
+      EXPECT_EQ(route_ontrip(*data_, *sched_, from, to, start_time),
+                route_ontrip(*compressed_data_, *sched_, from, to, start_time));
+    }
+
+    EXPECT_EQ(route_pretrip(*data_, *sched_, from, to, motis_time(1200),
+                            motis_time(1800)),
+              route_pretrip(*compressed_data_, *sched_, from, to,
+                            motis_time(1200), motis_time(1800)));
+  });
+}
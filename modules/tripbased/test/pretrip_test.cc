@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <ctime>
+#include <utility>
+#include <vector>
 
 #include "motis/core/access/time_access.h"
 #include "motis/module/message.h"
@@ -78,3 +81,53 @@ TEST_F(tripbased_pretrip, simple_fwd) {
   EXPECT_TRUE(has_journey(journeys, 1612, 1655));
   EXPECT_TRUE(has_journey(journeys, 1642, 1725));
 }
+
+struct tripbased_pretrip_parallel : public motis_instance_test {
+  tripbased_pretrip_parallel()
+      : motis::test::motis_instance_test(
+            loader::loader_options{
+                .dataset_ = {"modules/tripbased/test_resources/schedule"},
+                .schedule_begin_ = "20151121"},
+            {"tripbased"},
+            {"--tripbased.use_data_file=false",
+             "--tripbased.profile_search_chunks=4",
+             "--tripbased.profile_search_min_chunk=15"}) {}
+};
+
+TEST_F(tripbased_pretrip_parallel, simple_fwd) {
+  message_creator fbb;
+  auto const interval = Interval(unix_time(1500), unix_time(1700));
+  fbb.create_and_finish(
+      MsgContent_RoutingRequest,
+      CreateRoutingRequest(
+          fbb, Start_PretripStart,
+          CreatePretripStart(
+              fbb,
+              CreateInputStation(fbb, fbb.CreateString("2000001"),
+                                 fbb.CreateString("")),
+              &interval, 0, false, false)
+              .Union(),
+          CreateInputStation(fbb, fbb.CreateString("1000001"),
+                             fbb.CreateString("")),
+          SearchType_Default, SearchDir_Forward,
+          fbb.CreateVector(std::vector<Offset<Via>>()),
+          fbb.CreateVector(std::vector<Offset<AdditionalEdgeWrapper>>()))
+          .Union(),
+      "/tripbased");
+  auto const msg = call(make_msg(fbb));
+  auto const res = motis_content(RoutingResponse, msg);
+  auto const journeys = message_to_journeys(res);
+
+  std::vector<std::pair<std::time_t, std::time_t>> times;
+  for (auto const& j : journeys) {
+    times.emplace_back(j.stops_.front().departure_.schedule_timestamp_,
+                       j.stops_.back().arrival_.schedule_timestamp_);
+  }
+  std::sort(begin(times), end(times));
+  EXPECT_EQ((std::vector<std::pair<std::time_t, std::time_t>>{
+                {unix_time(1512), unix_time(1555)},
+                {unix_time(1542), unix_time(1625)},
+                {unix_time(1612), unix_time(1655)},
+                {unix_time(1642), unix_time(1725)}}),
+            times);
+}
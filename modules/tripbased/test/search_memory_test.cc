@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+
+#include "motis/core/access/time_access.h"
+
+#include "motis/tripbased/tb_search_memory.h"
+
+#include "./simple_realtime_data.h"
+
+using namespace motis;
+using namespace motis::tripbased;
+
+TEST_F(tripbased_simple_realtime, reused_search_memory_same_results) {
+  tb_search_memory mem;
+  for (auto round = 0; round < 50; ++round) {
+    auto const start_time = motis_time(1300 + round);
+    for_each_station_pair([&](station_id const from, station_id const to) {
+      EXPECT_EQ(route_ontrip(*data_, *sched_, from, to, start_time),
+                route_ontrip(*data_, *sched_, from, to, start_time, &mem));
+    });
+  }
+}
+
+TEST(tripbased_search_memory, epoch_overflow) {
+  tb_reachability r;
+  for (auto i = 0U; i < 70000U; ++i) {
+    r.reset(4U, 100U);
+    ASSERT_EQ(100U, r.get(i % 4U));
+    r.set(i % 4U, static_cast<stop_idx_t>(i % 50U));
+    ASSERT_EQ(i % 50U, r.get(i % 4U));
+  }
+}
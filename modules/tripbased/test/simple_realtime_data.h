@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "motis/core/schedule/schedule.h"
+#include "motis/core/access/station_access.h"
+#include "motis/loader/loader.h"
+
+#include "motis/tripbased/preprocessing.h"
+#include "motis/tripbased/tb_ontrip_search.h"
+#include "motis/tripbased/tb_search_memory.h"
+
+#include "motis/test/schedule/simple_realtime.h"
+
+namespace motis::tripbased {
+
+// (arrival time, transfers, journey edges), sorted
+using ontrip_result_t = std::vector<std::tuple<time, unsigned, std::size_t>>;
+
+inline ontrip_result_t route_ontrip(tb_data const& data, schedule const& sched,
+                                    station_id const from, station_id const to,
+                                    time const start_time,
+                                    tb_search_memory* mem = nullptr) {
+  tb_ontrip_search<search_dir::FWD> tbs(data, sched, start_time, false, false,
+                                        destination_mode::ALL, mem);
+  tbs.add_start(from, 0);
+  tbs.add_destination(to);
+  tbs.search();
+
+  ontrip_result_t result;
+  for (auto const& j : tbs.get_results(to)) {
+    result.emplace_back(j.arrival_time_, j.transfers_, j.edges_.size());
+  }
+  std::sort(begin(result), end(result));
+  return result;
+}
+
+// simple_realtime schedule with trip-based data and a set of stations to
+// route between.
+struct tripbased_simple_realtime : public ::testing::Test {
+  tripbased_simple_realtime()
+      : sched_{loader::load_schedule(
+            motis::test::schedule::simple_realtime::dataset_opt)},
+        data_{build_data(*sched_)} {
+    for (auto const eva : {"8000031", "8000068", "8000105", "8000261"}) {
+      stations_.push_back(get_station(*sched_, eva)->index_);
+    }
+  }
+
+  template <typename Fn>
+  void for_each_station_pair(Fn&& fn) const {
+    for (auto const from : stations_) {
+      for (auto const to : stations_) {
+        if (from != to) {
+          fn(from, to);
+        }
+      }
+    }
+  }
+
+  schedule_ptr sched_;
+  std::unique_ptr<tb_data> data_;
+  std::vector<station_id> stations_;
+};
+
+}  // namespace motis::tripbased
@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "motis/core/access/time_access.h"
+#include "motis/module/message.h"
+
+#include "motis/core/journey/journey.h"
+#include "motis/core/journey/message_to_journeys.h"
+
+#include "motis/test/motis_instance_test.h"
+#include "motis/test/schedule/simple_realtime.h"
+
+using namespace flatbuffers;
+using namespace motis;
+using namespace motis::module;
+using namespace motis::routing;
+using namespace motis::test;
+using motis::test::schedule::simple_realtime::dataset_opt;
+
+struct tripbased_transfer_patterns : public motis_instance_test {
+  tripbased_transfer_patterns()
+      : motis::test::motis_instance_test(
+            dataset_opt, {"tripbased"},
+            {"--tripbased.use_data_file=false",
+             "--tripbased.transfer_patterns=true",
+             "--tripbased.transfer_patterns_interval=48"}) {}
+
+  std::vector<journey> route(std::string const& target,
+                             std::string const& from, std::string const& to,
+                             unixtime const departure) {
+    message_creator fbb;
+    fbb.create_and_finish(
+        MsgContent_RoutingRequest,
+        CreateRoutingRequest(
+            fbb, Start_OntripStationStart,
+            CreateOntripStationStart(
+                fbb,
+                CreateInputStation(fbb, fbb.CreateString(from),
+                                   fbb.CreateString("")),
+                departure)
+                .Union(),
+            CreateInputStation(fbb, fbb.CreateString(to),
+                               fbb.CreateString("")),
+            SearchType_Default, SearchDir_Forward,
+            fbb.CreateVector(std::vector<Offset<Via>>()),
+            fbb.CreateVector(std::vector<Offset<AdditionalEdgeWrapper>>()))
+            .Union(),
+        target);
+    auto journeys = message_to_journeys(
+        motis_content(RoutingResponse, call(make_msg(fbb))));
+    std::sort(begin(journeys), end(journeys),
+              [](journey const& a, journey const& b) {
+                return a.transfers_ < b.transfers_;
+              });
+    return journeys;
+  }
+};
+
+TEST_F(tripbased_transfer_patterns, simple_fwd) {
+  auto const journeys = route("/tripbased/transfer_patterns", "8000031",
+                              "8000105", unix_time(1400));
+
+  ASSERT_EQ(1, journeys.size());
+  auto const& j = journeys[0];
+  ASSERT_EQ(3, j.stops_.size());
+  ASSERT_EQ(1, j.transports_.size());
+
+  EXPECT_EQ("8000031", j.stops_[0].eva_no_);
+  EXPECT_EQ(unix_time(1409), j.stops_[0].departure_.timestamp_);
+  EXPECT_EQ("8000105", j.stops_[2].eva_no_);
+  EXPECT_EQ(unix_time(1440), j.stops_[2].arrival_.timestamp_);
+  EXPECT_EQ("IC", j.transports_[0].category_name_);
+  EXPECT_EQ(2292, j.transports_[0].train_nr_);
+}
+
+TEST_F(tripbased_transfer_patterns, same_as_tripbased) {
+  for (auto const& [from, to] :
+       {std::pair{"8000031", "8000105"}, std::pair{"8000068", "8000105"},
+        std::pair{"8000031", "8000068"}}) {
+    for (auto const departure : {1300, 1400, 1409, 1410, 1500}) {
+      auto const expected =
+          route("/tripbased", from, to, unix_time(departure));
+      auto const actual = route("/tripbased/transfer_patterns", from, to,
+                                unix_time(departure));
+
+      ASSERT_EQ(expected.size(), actual.size());
+      for (auto i = 0U; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].transfers_, actual[i].transfers_);
+        EXPECT_EQ(expected[i].stops_.back().arrival_.timestamp_,
+                  actual[i].stops_.back().arrival_.timestamp_);
+      }
+    }
+  }
+}